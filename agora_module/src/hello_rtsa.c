@@ -10,6 +10,7 @@
 
 #include "app_config.h"
 #include "agora_server.h"
+#include "audio_dsp.h"
 #include <asoundlib.h>
 #include <pthread.h>
 #include <stdbool.h>
@@ -287,14 +288,8 @@ void record_deinit(void)
 }
 
 static void amplify_audio_data(int16_t *buffer, size_t samples, float gain) {
-    for (size_t i = 0; i < samples; i++) {
-        int32_t sample = buffer[i];
-        sample = (int32_t)(sample * gain);
-        // 限制在 16bit 范围内，防止爆音
-        if (sample > 32767) sample = 32767;
-        if (sample < -32768) sample = -32768;
-        buffer[i] = (int16_t)sample;
-    }
+    // 向量化增益，饱和在 16bit 范围内，防止爆音
+    bc_dsp_gain_s16(buffer, samples, gain);
 }
 
 static void app_signal_handler(int sig)
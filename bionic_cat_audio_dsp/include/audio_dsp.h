@@ -0,0 +1,71 @@
+#ifndef BIONIC_CAT_AUDIO_DSP_H
+#define BIONIC_CAT_AUDIO_DSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 采集与播放链路共用的 PCM 基础运算。每个内核都有标量实现，ARM 上另有 NEON、x86 上另有 SSE2 实现，
+ * 首次调用时按 CPU 能力选择（32 位 ARM 通过 AT_HWCAP 检查 NEON），之后固定不变。
+ *
+ * 约定：
+ *  - float 样本按 [-1, 1) 满幅，即 S16 / 32768；
+ *  - 量化统一为“先饱和到 [-32768, 32767]，再四舍五入（远离零）”，各实现结果逐位一致；
+ *  - 长度单位是样本数（交错数据为 帧数 × 声道数），任意长度都可，不要求对齐。
+ */
+
+typedef enum {
+    BC_DSP_IMPL_AUTO = 0, /* 按 CPU 能力自动选择 */
+    BC_DSP_IMPL_SCALAR,
+    BC_DSP_IMPL_SSE2,
+    BC_DSP_IMPL_NEON
+} bc_dsp_impl_t;
+
+/* 当前 CPU 是否支持该实现（AUTO 与 SCALAR 总是支持） */
+int bc_dsp_impl_supported(bc_dsp_impl_t impl);
+
+/* 强制使用某个实现（基准/对比测试用）；不支持时退回自动选择。返回实际生效的实现。
+ * 只应在启动阶段、没有其他线程正在调用内核时使用 */
+bc_dsp_impl_t bc_dsp_select(bc_dsp_impl_t impl);
+
+/* 当前生效的实现及其名字（"scalar" / "sse2" / "neon"） */
+bc_dsp_impl_t bc_dsp_active(void);
+const char* bc_dsp_impl_name(bc_dsp_impl_t impl);
+
+/* 增益并饱和：data[i] = sat(round(data[i] * gain))，原地处理 */
+void bc_dsp_gain_s16(int16_t* data, size_t n, float gain);
+
+/* 同上，结果写到 out（可与 in 相同） */
+void bc_dsp_gain_s16_copy(const int16_t* in, int16_t* out, size_t n, float gain);
+
+/* S16 → float */
+void bc_dsp_s16_to_float(const int16_t* in, float* out, size_t n);
+
+/* float × gain → S16，饱和并四舍五入 */
+void bc_dsp_float_to_s16(const float* in, int16_t* out, size_t n, float gain);
+
+/* 交错 → 分声道：out[c][f] = in[f * channels + c]；2/4 声道走向量路径 */
+void bc_dsp_deinterleave_s16(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out);
+
+/* 分声道 → 交错：out[f * channels + c] = in[c][f] */
+void bc_dsp_interleave_s16(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out);
+
+/* 样本平方和（精确整数） */
+uint64_t bc_dsp_sum_squares_s16(const int16_t* in, size_t n);
+
+/* 均方根电平，归一化到 [0, 1]；n 为 0 时返回 0 */
+float bc_dsp_rms_s16(const int16_t* in, size_t n);
+
+/* 均方根电平的 dBFS 值，静音下限为 BC_DSP_DBFS_FLOOR */
+#define BC_DSP_DBFS_FLOOR (-120.0f)
+float bc_dsp_dbfs_s16(const int16_t* in, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIONIC_CAT_AUDIO_DSP_H */
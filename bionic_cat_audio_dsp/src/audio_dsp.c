@@ -0,0 +1,205 @@
+#include "audio_dsp_internal.h"
+
+#include <math.h>
+#include <pthread.h>
+
+#if defined(BC_DSP_HAVE_NEON) && defined(__arm__)
+  #include <sys/auxv.h>
+  /* 与 asm/hwcap.h 的 HWCAP_NEON 相同；glibc 与 musl 的宏名不一致，这里直接写位 */
+  #define BC_DSP_HWCAP_NEON (1UL << 12)
+#endif
+
+/* ---------------- 标量实现 ---------------- */
+
+/* 饱和后四舍五入（远离零）；向量实现用同样的“加带符号 0.5 再截断”，保证结果逐位一致 */
+static inline int16_t quantize(float v) {
+    if (v > 32767.0f) v = 32767.0f;
+    if (v < -32768.0f) v = -32768.0f;
+    return (int16_t)(int32_t)(v + (v < 0.0f ? -0.5f : 0.5f));
+}
+
+void bc_dsp_scalar_gain_s16(const int16_t* in, int16_t* out, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) out[i] = quantize((float)in[i] * gain);
+}
+
+void bc_dsp_scalar_s16_to_float(const int16_t* in, float* out, size_t n) {
+    const float k = 1.0f / 32768.0f;
+    for (size_t i = 0; i < n; ++i) out[i] = (float)in[i] * k;
+}
+
+void bc_dsp_scalar_float_to_s16(const float* in, int16_t* out, size_t n, float gain) {
+    const float k = gain * 32768.0f;
+    for (size_t i = 0; i < n; ++i) out[i] = quantize(in[i] * k);
+}
+
+void bc_dsp_scalar_deinterleave_s16(const int16_t* in, size_t first, size_t frames, unsigned channels,
+                                    int16_t* const* out) {
+    for (unsigned c = 0; c < channels; ++c) {
+        int16_t* dst = out[c];
+        const int16_t* src = in + c;
+        for (size_t f = first; f < frames; ++f) dst[f] = src[f * channels];
+    }
+}
+
+void bc_dsp_scalar_interleave_s16(const int16_t* const* in, size_t first, size_t frames, unsigned channels,
+                                  int16_t* out) {
+    for (unsigned c = 0; c < channels; ++c) {
+        const int16_t* src = in[c];
+        int16_t* dst = out + c;
+        for (size_t f = first; f < frames; ++f) dst[f * channels] = src[f];
+    }
+}
+
+uint64_t bc_dsp_scalar_sum_squares_s16(const int16_t* in, size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; ++i) acc += (uint64_t)((int32_t)in[i] * (int32_t)in[i]);
+    return acc;
+}
+
+static void scalar_deinterleave(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out) {
+    bc_dsp_scalar_deinterleave_s16(in, 0, frames, channels, out);
+}
+
+static void scalar_interleave(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out) {
+    bc_dsp_scalar_interleave_s16(in, 0, frames, channels, out);
+}
+
+static const bc_dsp_kernels_t scalar_kernels = {
+    BC_DSP_IMPL_SCALAR,
+    bc_dsp_scalar_gain_s16,
+    bc_dsp_scalar_s16_to_float,
+    bc_dsp_scalar_float_to_s16,
+    scalar_deinterleave,
+    scalar_interleave,
+    bc_dsp_scalar_sum_squares_s16,
+};
+
+/* ---------------- 分发 ---------------- */
+
+static const bc_dsp_kernels_t* g_kernels = &scalar_kernels;
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+
+static const bc_dsp_kernels_t* kernelsFor(bc_dsp_impl_t impl) {
+    switch (impl) {
+        case BC_DSP_IMPL_SCALAR:
+            return &scalar_kernels;
+#if defined(BC_DSP_HAVE_SSE2)
+        case BC_DSP_IMPL_SSE2:
+            return &bc_dsp_sse2_kernels;
+#endif
+#if defined(BC_DSP_HAVE_NEON)
+        case BC_DSP_IMPL_NEON:
+            return &bc_dsp_neon_kernels;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+int bc_dsp_impl_supported(bc_dsp_impl_t impl) {
+    switch (impl) {
+        case BC_DSP_IMPL_AUTO:
+        case BC_DSP_IMPL_SCALAR:
+            return 1;
+#if defined(BC_DSP_HAVE_SSE2)
+        case BC_DSP_IMPL_SSE2:
+  #if defined(__x86_64__) || defined(__SSE2__)
+            return 1; /* x86-64 的基线指令集 */
+  #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") ? 1 : 0;
+  #endif
+#endif
+#if defined(BC_DSP_HAVE_NEON)
+        case BC_DSP_IMPL_NEON:
+  #if defined(__arm__)
+            /* 32 位 ARM 上 NEON 是可选扩展（Cortex-A 一般都有），以内核报告为准 */
+            return (getauxval(AT_HWCAP) & BC_DSP_HWCAP_NEON) ? 1 : 0;
+  #else
+            return 1; /* AArch64 必定带 Advanced SIMD */
+  #endif
+#endif
+        default:
+            return 0;
+    }
+}
+
+static bc_dsp_impl_t bestImpl(void) {
+    if (bc_dsp_impl_supported(BC_DSP_IMPL_NEON)) return BC_DSP_IMPL_NEON;
+    if (bc_dsp_impl_supported(BC_DSP_IMPL_SSE2)) return BC_DSP_IMPL_SSE2;
+    return BC_DSP_IMPL_SCALAR;
+}
+
+static void initKernels(void) {
+    g_kernels = kernelsFor(bestImpl());
+}
+
+static inline const bc_dsp_kernels_t* kernels(void) {
+    pthread_once(&g_once, initKernels);
+    return g_kernels;
+}
+
+bc_dsp_impl_t bc_dsp_select(bc_dsp_impl_t impl) {
+    pthread_once(&g_once, initKernels);
+    if (impl == BC_DSP_IMPL_AUTO || !bc_dsp_impl_supported(impl)) impl = bestImpl();
+    g_kernels = kernelsFor(impl);
+    return g_kernels->impl;
+}
+
+bc_dsp_impl_t bc_dsp_active(void) {
+    return kernels()->impl;
+}
+
+const char* bc_dsp_impl_name(bc_dsp_impl_t impl) {
+    switch (impl) {
+        case BC_DSP_IMPL_SCALAR: return "scalar";
+        case BC_DSP_IMPL_SSE2: return "sse2";
+        case BC_DSP_IMPL_NEON: return "neon";
+        default: return "auto";
+    }
+}
+
+/* ---------------- 对外接口 ---------------- */
+
+void bc_dsp_gain_s16(int16_t* data, size_t n, float gain) {
+    kernels()->gain_s16(data, data, n, gain);
+}
+
+void bc_dsp_gain_s16_copy(const int16_t* in, int16_t* out, size_t n, float gain) {
+    kernels()->gain_s16(in, out, n, gain);
+}
+
+void bc_dsp_s16_to_float(const int16_t* in, float* out, size_t n) {
+    kernels()->s16_to_float(in, out, n);
+}
+
+void bc_dsp_float_to_s16(const float* in, int16_t* out, size_t n, float gain) {
+    kernels()->float_to_s16(in, out, n, gain);
+}
+
+void bc_dsp_deinterleave_s16(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out) {
+    if (channels == 0) return;
+    kernels()->deinterleave_s16(in, frames, channels, out);
+}
+
+void bc_dsp_interleave_s16(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out) {
+    if (channels == 0) return;
+    kernels()->interleave_s16(in, frames, channels, out);
+}
+
+uint64_t bc_dsp_sum_squares_s16(const int16_t* in, size_t n) {
+    return kernels()->sum_squares_s16(in, n);
+}
+
+float bc_dsp_rms_s16(const int16_t* in, size_t n) {
+    if (n == 0) return 0.0f;
+    const double mean = (double)bc_dsp_sum_squares_s16(in, n) / (double)n;
+    return (float)(sqrt(mean) / 32768.0);
+}
+
+float bc_dsp_dbfs_s16(const int16_t* in, size_t n) {
+    const float rms = bc_dsp_rms_s16(in, n);
+    if (rms <= 1e-6f) return BC_DSP_DBFS_FLOOR;
+    const float db = 20.0f * log10f(rms);
+    return db < BC_DSP_DBFS_FLOOR ? BC_DSP_DBFS_FLOOR : db;
+}
@@ -0,0 +1,34 @@
+#ifndef BIONIC_CAT_AUDIO_DSP_INTERNAL_H
+#define BIONIC_CAT_AUDIO_DSP_INTERNAL_H
+
+#include "audio_dsp.h"
+
+/* 各实现导出的内核表；向量实现只覆盖主体，尾部与不支持的声道数交给标量函数 */
+typedef struct {
+    bc_dsp_impl_t impl;
+    void (*gain_s16)(const int16_t* in, int16_t* out, size_t n, float gain);
+    void (*s16_to_float)(const int16_t* in, float* out, size_t n);
+    void (*float_to_s16)(const float* in, int16_t* out, size_t n, float gain);
+    void (*deinterleave_s16)(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out);
+    void (*interleave_s16)(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out);
+    uint64_t (*sum_squares_s16)(const int16_t* in, size_t n);
+} bc_dsp_kernels_t;
+
+/* 标量实现，向量实现处理尾部时也调用它们；deinterleave/interleave 的 first 为起始帧 */
+void bc_dsp_scalar_gain_s16(const int16_t* in, int16_t* out, size_t n, float gain);
+void bc_dsp_scalar_s16_to_float(const int16_t* in, float* out, size_t n);
+void bc_dsp_scalar_float_to_s16(const float* in, int16_t* out, size_t n, float gain);
+void bc_dsp_scalar_deinterleave_s16(const int16_t* in, size_t first, size_t frames, unsigned channels,
+                                    int16_t* const* out);
+void bc_dsp_scalar_interleave_s16(const int16_t* const* in, size_t first, size_t frames, unsigned channels,
+                                  int16_t* out);
+uint64_t bc_dsp_scalar_sum_squares_s16(const int16_t* in, size_t n);
+
+#if defined(BC_DSP_HAVE_SSE2)
+extern const bc_dsp_kernels_t bc_dsp_sse2_kernels;
+#endif
+#if defined(BC_DSP_HAVE_NEON)
+extern const bc_dsp_kernels_t bc_dsp_neon_kernels;
+#endif
+
+#endif /* BIONIC_CAT_AUDIO_DSP_INTERNAL_H */
@@ -0,0 +1,113 @@
+#include "audio_dsp_internal.h"
+
+#include <arm_neon.h>
+
+/* 加上与 v 同号的 0.5 后向零取整，与标量 quantize 一致 */
+static inline int32x4_t quantize4(float32x4_t v, float32x4_t lo, float32x4_t hi) {
+    const uint32x4_t sign = vdupq_n_u32(0x80000000u);
+    const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+    v = vminq_f32(vmaxq_f32(v, lo), hi);
+    v = vaddq_f32(v, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), sign), half)));
+    return vcvtq_s32_f32(v);
+}
+
+static void gain_s16(const int16_t* in, int16_t* out, size_t n, float gain) {
+    const float32x4_t lo = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi = vdupq_n_f32(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(in + i);
+        const float32x4_t a = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), gain);
+        const float32x4_t b = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), gain);
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(quantize4(a, lo, hi)), vqmovn_s32(quantize4(b, lo, hi))));
+    }
+    bc_dsp_scalar_gain_s16(in + i, out + i, n - i, gain);
+}
+
+static void s16_to_float(const int16_t* in, float* out, size_t n) {
+    const float k = 1.0f / 32768.0f;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), k));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), k));
+    }
+    bc_dsp_scalar_s16_to_float(in + i, out + i, n - i);
+}
+
+static void float_to_s16(const float* in, int16_t* out, size_t n, float gain) {
+    const float k = gain * 32768.0f;
+    const float32x4_t lo = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi = vdupq_n_f32(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int32x4_t a = quantize4(vmulq_n_f32(vld1q_f32(in + i), k), lo, hi);
+        const int32x4_t b = quantize4(vmulq_n_f32(vld1q_f32(in + i + 4), k), lo, hi);
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    bc_dsp_scalar_float_to_s16(in + i, out + i, n - i, gain);
+}
+
+static void deinterleave_s16(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out) {
+    size_t f = 0;
+    if (channels == 2) {
+        for (; f + 8 <= frames; f += 8) {
+            const int16x8x2_t v = vld2q_s16(in + f * 2);
+            vst1q_s16(out[0] + f, v.val[0]);
+            vst1q_s16(out[1] + f, v.val[1]);
+        }
+    } else if (channels == 4) {
+        for (; f + 8 <= frames; f += 8) {
+            const int16x8x4_t v = vld4q_s16(in + f * 4);
+            vst1q_s16(out[0] + f, v.val[0]);
+            vst1q_s16(out[1] + f, v.val[1]);
+            vst1q_s16(out[2] + f, v.val[2]);
+            vst1q_s16(out[3] + f, v.val[3]);
+        }
+    }
+    bc_dsp_scalar_deinterleave_s16(in, f, frames, channels, out);
+}
+
+static void interleave_s16(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out) {
+    size_t f = 0;
+    if (channels == 2) {
+        for (; f + 8 <= frames; f += 8) {
+            int16x8x2_t v;
+            v.val[0] = vld1q_s16(in[0] + f);
+            v.val[1] = vld1q_s16(in[1] + f);
+            vst2q_s16(out + f * 2, v);
+        }
+    } else if (channels == 4) {
+        for (; f + 8 <= frames; f += 8) {
+            int16x8x4_t v;
+            v.val[0] = vld1q_s16(in[0] + f);
+            v.val[1] = vld1q_s16(in[1] + f);
+            v.val[2] = vld1q_s16(in[2] + f);
+            v.val[3] = vld1q_s16(in[3] + f);
+            vst4q_s16(out + f * 4, v);
+        }
+    }
+    bc_dsp_scalar_interleave_s16(in, f, frames, channels, out);
+}
+
+static uint64_t sum_squares_s16(const int16_t* in, size_t n) {
+    uint64x2_t acc = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(in + i);
+        /* 单个平方最大 2^30，按无符号两两累加到 64 位 */
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(vget_low_s16(v), vget_low_s16(v))));
+        acc = vpadalq_u32(acc, vreinterpretq_u32_s32(vmull_s16(vget_high_s16(v), vget_high_s16(v))));
+    }
+    return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1) + bc_dsp_scalar_sum_squares_s16(in + i, n - i);
+}
+
+const bc_dsp_kernels_t bc_dsp_neon_kernels = {
+    BC_DSP_IMPL_NEON,
+    gain_s16,
+    s16_to_float,
+    float_to_s16,
+    deinterleave_s16,
+    interleave_s16,
+    sum_squares_s16,
+};
@@ -0,0 +1,140 @@
+#include "audio_dsp_internal.h"
+
+#include <emmintrin.h>
+
+/* 加上与 v 同号的 0.5 后截断取整，与标量 quantize 一致 */
+static inline __m128i quantize4(__m128 v, __m128 lo, __m128 hi) {
+    const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u));
+    const __m128 half = _mm_set1_ps(0.5f);
+    v = _mm_min_ps(_mm_max_ps(v, lo), hi);
+    return _mm_cvttps_epi32(_mm_add_ps(v, _mm_or_ps(_mm_and_ps(v, sign), half)));
+}
+
+static void gain_s16(const int16_t* in, int16_t* out, size_t n, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        /* 与自身交织后算术右移 16 位即符号扩展到 32 位 */
+        const __m128 a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+        const __m128 b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+        const __m128i r = _mm_packs_epi32(quantize4(_mm_mul_ps(a, g), lo, hi), quantize4(_mm_mul_ps(b, g), lo, hi));
+        _mm_storeu_si128((__m128i*)(out + i), r);
+    }
+    bc_dsp_scalar_gain_s16(in + i, out + i, n - i, gain);
+}
+
+static void s16_to_float(const int16_t* in, float* out, size_t n) {
+    const __m128 k = _mm_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), k));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), k));
+    }
+    bc_dsp_scalar_s16_to_float(in + i, out + i, n - i);
+}
+
+static void float_to_s16(const float* in, int16_t* out, size_t n, float gain) {
+    const __m128 k = _mm_set1_ps(gain * 32768.0f);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i a = quantize4(_mm_mul_ps(_mm_loadu_ps(in + i), k), lo, hi);
+        const __m128i b = quantize4(_mm_mul_ps(_mm_loadu_ps(in + i + 4), k), lo, hi);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(a, b));
+    }
+    bc_dsp_scalar_float_to_s16(in + i, out + i, n - i, gain);
+}
+
+/* 把 a、b 中的 16 个样本按奇偶位置拆开：even/odd 各 8 个 */
+static inline void split2(__m128i a, __m128i b, __m128i* even, __m128i* odd) {
+    *even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+    *odd = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+}
+
+static void deinterleave_s16(const int16_t* in, size_t frames, unsigned channels, int16_t* const* out) {
+    size_t f = 0;
+    if (channels == 2) {
+        for (; f + 8 <= frames; f += 8) {
+            const __m128i* p = (const __m128i*)(in + f * 2);
+            __m128i c0, c1;
+            split2(_mm_loadu_si128(p), _mm_loadu_si128(p + 1), &c0, &c1);
+            _mm_storeu_si128((__m128i*)(out[0] + f), c0);
+            _mm_storeu_si128((__m128i*)(out[1] + f), c1);
+        }
+    } else if (channels == 4) {
+        for (; f + 8 <= frames; f += 8) {
+            const __m128i* p = (const __m128i*)(in + f * 4);
+            /* 第一次拆出 (c0,c2)/(c1,c3) 交错，第二次再拆开 */
+            __m128i e01, o01, e23, o23, c0, c1, c2, c3;
+            split2(_mm_loadu_si128(p), _mm_loadu_si128(p + 1), &e01, &o01);
+            split2(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3), &e23, &o23);
+            split2(e01, e23, &c0, &c2);
+            split2(o01, o23, &c1, &c3);
+            _mm_storeu_si128((__m128i*)(out[0] + f), c0);
+            _mm_storeu_si128((__m128i*)(out[1] + f), c1);
+            _mm_storeu_si128((__m128i*)(out[2] + f), c2);
+            _mm_storeu_si128((__m128i*)(out[3] + f), c3);
+        }
+    }
+    bc_dsp_scalar_deinterleave_s16(in, f, frames, channels, out);
+}
+
+static void interleave_s16(const int16_t* const* in, size_t frames, unsigned channels, int16_t* out) {
+    size_t f = 0;
+    if (channels == 2) {
+        for (; f + 8 <= frames; f += 8) {
+            const __m128i c0 = _mm_loadu_si128((const __m128i*)(in[0] + f));
+            const __m128i c1 = _mm_loadu_si128((const __m128i*)(in[1] + f));
+            __m128i* p = (__m128i*)(out + f * 2);
+            _mm_storeu_si128(p, _mm_unpacklo_epi16(c0, c1));
+            _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(c0, c1));
+        }
+    } else if (channels == 4) {
+        for (; f + 8 <= frames; f += 8) {
+            const __m128i c0 = _mm_loadu_si128((const __m128i*)(in[0] + f));
+            const __m128i c1 = _mm_loadu_si128((const __m128i*)(in[1] + f));
+            const __m128i c2 = _mm_loadu_si128((const __m128i*)(in[2] + f));
+            const __m128i c3 = _mm_loadu_si128((const __m128i*)(in[3] + f));
+            /* (c0,c2) 与 (c1,c3) 先各自交错，再按 16 bit 交错即得 c0 c1 c2 c3 */
+            const __m128i a_lo = _mm_unpacklo_epi16(c0, c2), a_hi = _mm_unpackhi_epi16(c0, c2);
+            const __m128i b_lo = _mm_unpacklo_epi16(c1, c3), b_hi = _mm_unpackhi_epi16(c1, c3);
+            __m128i* p = (__m128i*)(out + f * 4);
+            _mm_storeu_si128(p, _mm_unpacklo_epi16(a_lo, b_lo));
+            _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(a_lo, b_lo));
+            _mm_storeu_si128(p + 2, _mm_unpacklo_epi16(a_hi, b_hi));
+            _mm_storeu_si128(p + 3, _mm_unpackhi_epi16(a_hi, b_hi));
+        }
+    }
+    bc_dsp_scalar_interleave_s16(in, f, frames, channels, out);
+}
+
+static uint64_t sum_squares_s16(const int16_t* in, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        /* 相邻两个平方之和最大 2^31，按无符号 32 位解释不会溢出，再零扩展累加到 64 位 */
+        const __m128i sq = _mm_madd_epi16(v, v);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(sq, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(sq, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return lanes[0] + lanes[1] + bc_dsp_scalar_sum_squares_s16(in + i, n - i);
+}
+
+const bc_dsp_kernels_t bc_dsp_sse2_kernels = {
+    BC_DSP_IMPL_SSE2,
+    gain_s16,
+    s16_to_float,
+    float_to_s16,
+    deinterleave_s16,
+    interleave_s16,
+    sum_squares_s16,
+};
@@ -0,0 +1,51 @@
+#ifndef ADAPTIVE_BITRATE_HPP
+#define ADAPTIVE_BITRATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 发布侧积压快照：由 MicrophoneNode 提供（MQTT 在途包数与累计丢弃数）
+struct PublishBacklog {
+    size_t in_flight{0};
+    uint64_t dropped{0};
+};
+
+struct AdaptiveBitrateParams {
+    uint32_t min_bps{16000};
+    uint32_t max_bps{64000};
+    uint32_t increase_bps{4000};    // 加性增：每个空闲评估周期上调
+    float decrease_factor{0.7f};    // 乘性减：拥塞时按比例下调
+    uint32_t interval_ms{1000};     // 评估周期
+    size_t high_in_flight{8};       // 周期内在途峰值达到该值视为拥塞
+    size_t low_in_flight{2};        // 周期内在途峰值不超过该值视为空闲
+    uint32_t probe_intervals{3};    // 连续空闲周期数达到后才开始上调
+};
+
+// AIMD 码率控制：在途数或丢弃数上升时乘性下调，链路持续空闲时加性回升
+// 只在编码线程调用，不做同步
+class AdaptiveBitrateController {
+public:
+    AdaptiveBitrateController(const AdaptiveBitrateParams& params, uint32_t start_bps);
+
+    // 每编码一帧调用一次；到达评估周期且码率变化时返回 true 并写出新码率
+    bool update(uint64_t now_ms, const PublishBacklog& sample, uint32_t& new_bps);
+
+    uint32_t bitrate() const { return bps_; }
+
+private:
+    AdaptiveBitrateParams params_;
+    uint32_t bps_;
+    uint64_t interval_start_ms_{0};
+    bool started_{false};
+    size_t peak_in_flight_{0};
+    uint64_t dropped_at_start_{0};
+    uint32_t clean_intervals_{0};
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // ADAPTIVE_BITRATE_HPP
@@ -0,0 +1,101 @@
+#ifndef AUDIO_ENCODER_HPP
+#define AUDIO_ENCODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <fdk-aac/aacenc_lib.h>
+#include "pooled_buffer.hpp"
+
+struct OpusEncoder; // libopus 的前向声明
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 数值与 MqttMsgs::AudioCodec 一致，便于直接转换
+enum class AudioCodecType : uint8_t {
+    AAC_ADTS = 0,
+    OPUS = 1
+};
+
+const char* audioCodecName(AudioCodecType codec);
+
+// 编码输出前预留的字节数：足够 MicrophoneNode 原地写入 AdtsStreamDataMsg 的序列化前缀
+static constexpr size_t kAdtsPayloadHeadroom = 96;
+
+// 单帧编码器接口：每次输入恰好一帧 PCM，输出一个码流包到池化缓冲（headroom 供序列化前缀使用）
+class AudioEncoder {
+public:
+    virtual ~AudioEncoder() = default;
+
+    // aot 仅 AAC 使用
+    virtual bool init(int sample_rate, int channels, int bitrate, int aot) = 0;
+    // 输入 PCM（S16LE，samples = frameSamplesPerCh() × 通道数），输出一个包（可能为空）
+    virtual bool encode(const int16_t* pcm_data, size_t samples, ByteSlice& out) = 0;
+    virtual void close() = 0;
+    // 运行中调整目标码率（自适应码率），从下一帧起生效
+    virtual bool setBitrate(int bitrate) = 0;
+
+    virtual int frameSamplesPerCh() const = 0;
+    virtual AudioCodecType codec() const = 0;
+};
+
+class AACEncoder : public AudioEncoder {
+public:
+    AACEncoder();
+    ~AACEncoder() override;
+
+    bool init(int sample_rate, int channels, int bitrate, int aot = 2) override;
+    // 输出一帧 ADTS 字节；FDK 直接写入池化缓冲中 7 字节 ADTS 头之后的位置，头部随后原地补写，不做中间复制
+    bool encode(const int16_t* pcm_data, size_t samples, ByteSlice& out_adts) override;
+    void close() override;
+    bool setBitrate(int bitrate) override;
+
+    int frameSamplesPerCh() const override { return input_samples_per_frame_; }
+    AudioCodecType codec() const override { return AudioCodecType::AAC_ADTS; }
+
+private:
+    static void writeAdtsHeader(uint8_t* adts, int aac_length, int samplerate, int channels);
+
+private:
+    HANDLE_AACENCODER encoder_{nullptr};
+    std::unique_ptr<BufferPool> pool_;   // 输出缓冲池，init 时创建
+    int input_samples_per_frame_{1024}; // per channel
+    int samplerate_{16000};
+    int channels_{1};
+};
+
+// Opus（VOIP 模式，20 ms 帧）。未链接 opus::opus（BIONIC_CAT_HAS_OPUS 未定义）时编译为空实现，init 返回 false
+class OpusAudioEncoder : public AudioEncoder {
+public:
+    static constexpr int kFrameMs = 20;
+    static constexpr int kComplexity = 5; // 0..10，ARM 小核上兼顾音质与 CPU
+
+    OpusAudioEncoder();
+    ~OpusAudioEncoder() override;
+
+    // 采样率须为 8/12/16/24/48 kHz
+    bool init(int sample_rate, int channels, int bitrate, int aot = 0) override;
+    bool encode(const int16_t* pcm_data, size_t samples, ByteSlice& out) override;
+    void close() override;
+    bool setBitrate(int bitrate) override;
+
+    int frameSamplesPerCh() const override { return frame_samples_per_ch_; }
+    AudioCodecType codec() const override { return AudioCodecType::OPUS; }
+
+    static bool available();
+
+private:
+    ::OpusEncoder* encoder_{nullptr};
+    std::unique_ptr<BufferPool> pool_;
+    int frame_samples_per_ch_{320};
+    int channels_{1};
+};
+
+std::unique_ptr<AudioEncoder> createAudioEncoder(AudioCodecType codec);
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // AUDIO_ENCODER_HPP
@@ -0,0 +1,63 @@
+#ifndef BEAMFORMER_HPP
+#define BEAMFORMER_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "sound_localization.hpp"
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 4 麦延迟求和波束形成：按定位方向把各通道对齐（分数延迟，加窗 sinc FIR）后取平均，输出单声道
+// - 几何取自 MicArrayConfig，与 MicArrayLocalizer 使用同一套麦克风坐标
+// - FIR 内层循环按编译目标选择 NEON / SSE / 标量实现
+// - 改变指向时，本 period 内在新旧两组滤波器输出之间线性交叉淡化，避免咔哒声
+// 仅在 process 所在线程（编码线程）使用；方向由调用方传入
+class DelayAndSumBeamformer {
+public:
+    static constexpr int kMaxTaps = 32;
+
+    DelayAndSumBeamformer(const MicArrayConfig& config, uint32_t max_period_samples, int taps = 16);
+
+    // 角度约定与 MicArrayLocalizer 输出一致（度）；变化小于 retune_deg 时忽略
+    void steer(float azimuth_deg, float elevation_deg, float retune_deg = 2.0f);
+
+    // in: 4 通道 int16（每通道 n 个样本）；out: 单声道样本（饱和到 int16），长度为 n 与构造时 max_period_samples 中的较小者
+    void process(const std::vector<std::vector<int16_t>>& in, size_t n, std::vector<int16_t>& out);
+
+    bool steered() const { return steered_; }
+
+private:
+    struct Steering {
+        std::array<int32_t, 4> shift{};                   // 整数延迟（样本）
+        std::array<std::array<float, kMaxTaps>, 4> taps{}; // 分数延迟 FIR
+    };
+
+    void design(float azimuth_deg, float elevation_deg, Steering& s) const;
+    void render(const Steering& s, size_t n, float* y) const;
+
+    std::array<Vec3, 4> mic_positions_;
+    float sound_speed_;
+    float sample_rate_;
+    int taps_;
+    int32_t history_;                                  // 每通道保留的历史样本数
+    uint32_t max_period_;
+
+    std::array<std::vector<float>, 4> buf_;            // [history | 当前 period] 的浮点样本
+    std::vector<float> mix_;
+    std::vector<float> mix_old_;
+
+    Steering current_;
+    Steering previous_;
+    bool crossfade_{false};
+    bool steered_{false};
+    float az_{0.0f};
+    float el_{0.0f};
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // BEAMFORMER_HPP
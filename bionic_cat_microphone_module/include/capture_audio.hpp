@@ -12,11 +12,18 @@
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <array>
 
 struct pcm; // tinyalsa 的前向声明
 
-#include <fdk-aac/aacenc_lib.h>
+#include "audio_encoder.hpp"
+#include "adaptive_bitrate.hpp"
 #include "sound_localization.hpp"
+#include "sliding_window_localizer.hpp"
+#include "source_tracker.hpp"
+#include "worker_pool.hpp"
+#include "pooled_buffer.hpp"
+#include "beamformer.hpp"
 
 namespace BionicCat {
 namespace MicrophoneModule {
@@ -28,13 +35,14 @@ struct AdtsStreamControl {
     uint8_t channels{1};
     uint32_t bit_rate{64000};
     uint8_t aot{2}; // 2=LC
+    AudioCodecType codec{AudioCodecType::AAC_ADTS};
 };
 
 struct AdtsStreamData {
     uint32_t seq{0};
     uint64_t pts_ms{0};
     uint16_t frame_count{1};
-    std::vector<uint8_t> payload; // ADTS 带头字节
+    ByteSlice payload; // AAC 时为带头 ADTS 帧，Opus 时为一个原始包（池化缓冲，headroom 可供序列化前缀使用）
 };
 
 // 适配声源定位 YAML 的音频配置（与 MicArrayConfig 的 audio 字段对应）
@@ -47,12 +55,36 @@ struct AudioConfig {
     int period_count{4};
 };
 
+// 流水线统计：计数为开流以来累计；high_water 与耗时只覆盖当前统计窗口（stats(true) 开启新窗口）
+struct StreamerStats {
+    uint32_t window_ms{0};
+    uint64_t periods_captured{0};
+    uint64_t capture_xruns{0};
+    uint32_t queue_capacity{0};
+    uint64_t encode_queue_drops{0};
+    uint64_t localize_queue_drops{0};
+    uint32_t encode_queue_high_water{0};
+    uint32_t localize_queue_high_water{0};
+    uint64_t frames_encoded{0};
+    float encode_us_avg{0.0f};
+    float encode_us_max{0.0f};
+    uint64_t periods_localized{0};
+    float localize_us_avg{0.0f};
+    float localize_us_max{0.0f};
+    float period_us{0.0f}; // 一个 period 的时长，即各阶段的实时预算
+    uint32_t bit_rate{0};
+    float input_dbfs{-120.0f}; // 窗口内 ch0 单个 period 的 RMS 电平最大值（增益后）
+};
+
 struct sound_localization_result
 {
     float azimuth{0.0f};
     float elevation{0.0f};
     float confidence{0.0f};
     float loudness[4]{0.0f};
+    // 多声源跟踪结果（tracking 关闭时 num_sources = 0）
+    uint8_t num_sources{0};
+    std::array<TrackedSource, SourceTracker::kMaxTracks> sources{};
 };
 
 
@@ -82,6 +114,8 @@ public:
     int rate() const { return rate_; }
     int channels() const { return channels_; }
     int periodSize() const { return period_size_; }
+    // 采集溢出次数：tinyalsa 在 pcm_read 内部处理 EPIPE 后静默重启，只能按读取进度与时钟的差推断
+    uint64_t xruns() const { return xruns_.load(std::memory_order_relaxed); }
 
 private:
     pcm* pcm_{nullptr};
@@ -90,32 +124,16 @@ private:
     int period_size_{1024};
     int period_count_{4};
     float gain_{1.0f}; // 新增：采集输出增益（用于声源定位）
-};
-
-class AACEncoder {
-public:
-    AACEncoder();
-    ~AACEncoder();
-
-    bool init(int sample_rate, int channels, int bitrate, int aot = 2);
-    // 输入 PCM（S16LE，samples 为采样点个数=样本数×通道数），输出一帧 ADTS 字节（可能为空）
-    bool encode(const int16_t* pcm_data, size_t samples, std::vector<uint8_t>& out_adts);
-    void close();
-
-    int frameSamplesPerCh() const { return input_samples_per_frame_; }
-
-private:
-    static void writeAdtsHeader(uint8_t* adts, int aac_length, int samplerate, int channels);
 
-private:
-    HANDLE_AACENCODER encoder_{nullptr};
-    int input_samples_per_frame_{1024}; // per channel
-    int samplerate_{16000};
-    int channels_{1};
+    void trackXrun();
+    std::atomic<uint64_t> xruns_{0};
+    bool xrun_started_{false};
+    std::chrono::steady_clock::time_point xrun_t0_{};
+    uint64_t xrun_frames_{0}; // 自 xrun_t0_ 起读到的帧数
 };
 
-// 采集+编码+打包成 ADTS，提供回调接口（用于发布 MQTT 消息）
-// 注意：无论采集通道数是多少，AAC 编码与 ADTS 打包固定为单通道（Mono）
+// 采集+编码（AAC-ADTS 或 Opus），提供回调接口（用于发布 MQTT 消息）
+// 注意：无论采集通道数是多少，编码固定为单通道（Mono）
 class MicrophoneAdtsStreamer {
 public:
     struct Config {
@@ -125,16 +143,22 @@ public:
         uint8_t channels{1}; // 采集通道数；编码固定使用 1
         uint32_t bit_rate{64000};
         uint8_t aot{2};
+        AudioCodecType codec{AudioCodecType::AAC_ADTS}; // 所选编码不可用时回退到 AAC
+        // 自适应码率：按发布积压在 [min_bit_rate, bit_rate] 内 AIMD 调整，需设置 onBacklogProbe
+        bool adaptive_bitrate{false};
+        uint32_t min_bit_rate{16000};
         int period_size{1024};
         int period_count{4};
         // 新增：声源定位相关
         bool enable_localization{false};
         std::string localization_config_path{"/mnt/data/CV184X/bionic_cat/config/custom_3d_mic_config.yaml"}; // YAML 配置路径
+        bool watch_localization_config{true}; // inotify 监听 YAML，修改后热更新定位参数
     };
 
     using ControlCallback = std::function<void(const AdtsStreamControl&)>;
     using DataCallback = std::function<void(const AdtsStreamData&)>;
     using LocalizationCallback = std::function<void(const sound_localization_result&)>; // 新增
+    using BacklogProbe = std::function<PublishBacklog()>;
 
     MicrophoneAdtsStreamer();
     ~MicrophoneAdtsStreamer();
@@ -145,16 +169,48 @@ public:
     void onControl(ControlCallback cb) { ctrl_cb_ = std::move(cb); }
     void onData(DataCallback cb) { data_cb_ = std::move(cb); }
     void onLocalization(LocalizationCallback cb) { loc_cb_ = std::move(cb); } // 新增
+    // 编码线程每帧发布后调用，读取下游积压；码率变化时以 is_start=true 的控制回调通知新码率
+    void onBacklogProbe(BacklogProbe cb) { backlog_cb_ = std::move(cb); }
+
+    uint32_t currentBitrate() const { return bit_rate_.load(std::memory_order_relaxed); }
+
+    // 查询流水线统计，任意线程可调用；reset_window 为 true 时开启新的统计窗口
+    StreamerStats stats(bool reset_window = false);
+
+    // 热更新定位参数（不重启 PCM 与编码器）：在调用线程解析 YAML 并预构建定位器，
+    // 定位线程在下一个 period 边界原子接管。影响采集的字段（采样率/帧长/通道/增益）被忽略
+    bool reloadLocalizationConfig(const std::string& yaml_text);
+    bool reloadLocalizationConfigFile();
 
 private:
     // 生产者：采集并推入队列
     void run();
-    // 消费者：编码 ch0 并输出 ADTS
+    // 消费者：编码 ch0（或波束形成输出）并输出码流包
     void runEncode();
     // 消费者：声源定位（可选）
     void runLocalize();
+    // 监听定位 YAML 文件变化（inotify）
+    void runConfigWatch();
     static uint64_t nowMs();
 
+    // 定位线程使用的一整套实例，热更新时整体替换
+    struct LocalizationState {
+        MicArrayConfig cfg;
+        std::unique_ptr<WorkerPool> pool;                       // 并行线程池（可选），需先于使用者构造
+        std::unique_ptr<MicArrayLocalizer> localizer;
+        std::unique_ptr<SlidingWindowAnalyzer> window_analyzer; // 滑动窗口（可选）
+        std::unique_ptr<SourceTracker> tracker;                 // 多声源跟踪（可选）
+    };
+    static std::shared_ptr<LocalizationState> buildLocalization(MicArrayConfig cfg);
+    // 波束形成器随热更新重建：几何或波束参数变化时在重载线程构建，经 pending_beamformer_ 交给编码线程
+    struct BeamformerSlot {
+        std::unique_ptr<DelayAndSumBeamformer> beamformer; // 为空表示关闭波束形成
+    };
+    static std::unique_ptr<DelayAndSumBeamformer> buildBeamformer(const MicArrayConfig& cfg);
+    static bool sameBeamformer(const MicArrayConfig& a, const MicArrayConfig& b);
+    bool applyLocalizationConfig(MicArrayConfig cfg);
+    void adoptLocalization(std::shared_ptr<LocalizationState> next);
+
 private:
     Config cfg_{};
     std::atomic<bool> running_{false};
@@ -162,6 +218,7 @@ private:
     std::thread producer_;
     std::thread encoder_;
     std::thread localizer_thr_;
+    std::thread config_watch_thr_;
     // 双队列与同步
     using FramePtr = std::shared_ptr<std::vector<std::vector<int16_t>>>;
     std::deque<FramePtr> encode_queue_;
@@ -171,14 +228,46 @@ private:
     size_t max_queue_size_{32};
 
     AudioCapture cap_;
-    AACEncoder enc_;
+    std::unique_ptr<AudioEncoder> enc_; // start 时按 Config::codec 创建
     ControlCallback ctrl_cb_{};
     DataCallback data_cb_{};
     LocalizationCallback loc_cb_{};
+    BacklogProbe backlog_cb_{};
+
+    std::atomic<uint32_t> bit_rate_{0};          // 当前编码码率（自适应码率会修改）
+
+    // 统计：计数由各自线程写入；high_water 受 queue_mtx_ 保护
+    struct StageTiming {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> window_count{0};
+        std::atomic<uint64_t> window_total_us{0};
+        std::atomic<uint32_t> window_max_us{0};
+        void record(uint32_t us);
+        void reset();
+    };
+    bool localize_enabled_{false};                 // 定位线程存在时生产者才推入 localize_queue_
+    std::atomic<uint64_t> periods_captured_{0};
+    std::atomic<float> input_dbfs_max_{-120.0f};   // 仅采集线程写入，stats(true) 复位
+    std::atomic<uint64_t> encode_queue_drops_{0};  // 编码队列溢出丢弃的 period 数
+    std::atomic<uint64_t> localize_queue_drops_{0};
+    size_t encode_queue_high_water_{0};
+    size_t localize_queue_high_water_{0};
+    StageTiming encode_timing_;                    // 单帧编码
+    StageTiming localize_timing_;                  // 单 period 定位（含跟踪与回调）
+    std::atomic<uint64_t> stats_window_start_ms_{0};
 
     // 声源定位实例与配置
-    MicArrayConfig mic_cfg_{}; // 新增：定位用配置
-    std::unique_ptr<MicArrayLocalizer> localizer_; // 新增
+    MicArrayConfig mic_cfg_{}; // 启动时的定位配置（决定采集参数）
+    std::shared_ptr<LocalizationState> loc_;         // 仅定位线程访问
+    std::shared_ptr<LocalizationState> pending_loc_; // 待接管的新实例，std::atomic_load/store 访问
+    std::mutex reload_mtx_;                          // 串行化多个来源的热更新
+
+    // 波束形成（可选，需启用定位）：定位线程写入最新方向，编码线程按 period 读取并重新指向
+    std::unique_ptr<DelayAndSumBeamformer> beamformer_;  // 仅编码线程访问
+    std::shared_ptr<BeamformerSlot> pending_beamformer_; // 待接管的新实例，std::atomic_load/store 访问
+    MicArrayConfig beam_cfg_{};                          // 当前波束形成所用配置，受 reload_mtx_ 保护
+    std::atomic<uint64_t> steer_dir_{0}; // 高 32 位方位角、低 32 位仰角（float 位模式）
+    std::atomic<bool> steer_valid_{false};
 };
 
 } // namespace MicrophoneModule
@@ -0,0 +1,42 @@
+#ifndef FFT_RADIX2_HPP
+#define FFT_RADIX2_HPP
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 轻量实数 FFT（基 2，长度为 2 的幂）
+// 内部用 n/2 点复数 FFT + 打包后处理，旋转因子与位反转表在构造时预计算，
+// forward/inverse 调用过程中不分配内存，适合在定位线程中按 hop 反复调用
+class RealFft {
+public:
+    explicit RealFft(uint32_t n);
+
+    uint32_t size() const { return n_; }
+    uint32_t bins() const { return n_ / 2 + 1; }
+
+    // in: n 个实数；out: n/2+1 个频点
+    void forward(const float* in, std::complex<float>* out);
+    // in: n/2+1 个频点；out: n 个实数（已按 1/n 归一化）
+    void inverse(const std::complex<float>* in, float* out);
+
+    static bool isPowerOfTwo(uint32_t n) { return n >= 4 && (n & (n - 1)) == 0; }
+
+private:
+    void complexFft(std::complex<float>* data) const;
+
+    uint32_t n_;
+    uint32_t half_;
+    std::vector<uint32_t> bitrev_;                 // half_ 点位反转表
+    std::vector<std::complex<float>> twiddle_;     // half_ 点复数 FFT 旋转因子
+    std::vector<std::complex<float>> post_twiddle_; // W_n^k, k = 0..half_
+    std::vector<std::complex<float>> work_;
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // FFT_RADIX2_HPP
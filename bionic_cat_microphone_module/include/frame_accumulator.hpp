@@ -0,0 +1,65 @@
+#ifndef FRAME_ACCUMULATOR_HPP
+#define FRAME_ACCUMULATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 把任意长度的 period 拼成固定长度的编码帧（如 480 样本 period → 1024 样本 AAC 帧）：
+// - 输入中能构成整帧的部分直接把指针交给编码器（零拷贝）
+// - 只有跨 period 的帧才把不足一帧的片段拷入暂存区，暂存区固定一帧大小，不会增长
+// 每次 push 后残留始终 < 一帧，period 与帧长对齐时完全不拷贝
+class FrameAccumulator {
+public:
+    explicit FrameAccumulator(size_t frame_samples)
+        : frame_(frame_samples == 0 ? 1 : frame_samples)
+        , staging_(frame_) {}
+
+    size_t frameSamples() const { return frame_; }
+    size_t buffered() const { return level_; }
+    void reset() { level_ = 0; }
+
+    // 推入 n 个样本，每凑满一帧调用 on_frame(const int16_t* frame)（指向连续的一整帧）；
+    // on_frame 返回 false 时停止并返回 false（未消费的样本丢弃）
+    template <typename OnFrame>
+    bool push(const int16_t* data, size_t n, OnFrame&& on_frame) {
+        // 先补齐暂存区中的半帧
+        if (level_ > 0) {
+            const size_t m = std::min(n, frame_ - level_);
+            std::memcpy(staging_.data() + level_, data, m * sizeof(int16_t));
+            level_ += m;
+            data += m;
+            n -= m;
+            if (level_ < frame_) return true;
+            level_ = 0;
+            if (!on_frame(staging_.data())) return false;
+        }
+        // 整帧直接引用输入
+        while (n >= frame_) {
+            if (!on_frame(data)) return false;
+            data += frame_;
+            n -= frame_;
+        }
+        // 余下不足一帧的样本留待下个 period
+        if (n > 0) {
+            std::memcpy(staging_.data(), data, n * sizeof(int16_t));
+            level_ = n;
+        }
+        return true;
+    }
+
+private:
+    size_t frame_;
+    std::vector<int16_t> staging_;
+    size_t level_{0};
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // FRAME_ACCUMULATOR_HPP
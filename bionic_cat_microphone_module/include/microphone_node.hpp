@@ -34,6 +34,9 @@ public:
     void run();
     void stop();
 
+    // 按发布积压自动调节编码码率（默认关闭，按控制消息中的码率固定编码）；在下一次开流时生效
+    void setAdaptiveBitrate(bool enable) { adaptive_bitrate_ = enable; }
+
     // 新增：发布声源定位结果（外部可调用）
     void publishSoundLocalization(const sound_localization_result& msg);
     // 新增：设置声源定位结果发布主题
@@ -41,10 +44,15 @@ public:
 
 private:
     void handleControl(mqtt::const_message_ptr msg);
-    void startStream(uint32_t sample_rate, uint8_t channels, uint32_t bitrate, uint8_t aot);
+    // 定位配置热更新（YAML 文本），不重启采集
+    void handleLocalizationConfig(mqtt::const_message_ptr msg);
+    void startStream(uint32_t sample_rate, uint8_t channels, uint32_t bitrate, uint8_t aot,
+                     AudioCodecType codec);
     void stopStream();
+    // 周期发布流水线统计（run 循环中调用）
+    void publishStreamStats();
 
-    struct ControlCmd { bool start; uint32_t sr; uint8_t ch; uint32_t br; uint8_t aot; };
+    struct ControlCmd { bool start; uint32_t sr; uint8_t ch; uint32_t br; uint8_t aot; AudioCodecType codec; };
     void controlLoop();
 
 private:
@@ -53,10 +61,14 @@ private:
     std::string publish_topic_data_;
     std::string subscribe_topic_control_;
     std::string publish_topic_sound_{"bionic_cat/sound_localization"}; // 新增：声源定位发布主题
+    std::string subscribe_topic_loc_config_{"bionic_cat/microphone_localization_config"}; // 定位配置热更新
+    std::string publish_topic_stream_status_{"bionic_cat/microphone_stream_status"}; // AdtsStreamControlMsg：开始/结束/码率变化
+    std::string publish_topic_stream_stats_{"bionic_cat/microphone_stream_stats"};   // MicrophoneStreamStatsMsg
     int qos_;
     int card_;
     int device_;
     std::string device_id_;
+    std::atomic<bool> adaptive_bitrate_{false};
 
     std::atomic<bool> running_{false};
 
@@ -66,6 +78,12 @@ private:
 
     std::mutex stream_mtx_;
     std::unique_ptr<MicrophoneAdtsStreamer> streamer_;
+    std::vector<uint8_t> data_prefix_buf_; // AdtsStreamDataMsg 序列化前缀（仅编码线程使用，复用容量）
+    std::atomic<uint64_t> data_dropped_{0}; // 因在途过多或发布失败丢弃的数据包
+
+    static constexpr size_t kMaxDataInFlight = 32;        // 约 2 s 的 AAC 16 kHz 帧
+    static constexpr uint32_t kMinAdaptiveBitrate = 16000; // 自适应码率下限
+    static constexpr int kStatsIntervalMs = 5000;          // 统计发布周期
 
     std::thread control_thread_;
     std::mutex control_mtx_;
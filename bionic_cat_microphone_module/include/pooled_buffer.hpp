@@ -0,0 +1,58 @@
+#ifndef POOLED_BUFFER_HPP
+#define POOLED_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 池化字节缓冲中的一段：块布局为 [headroom | payload | 空闲]
+// payload 前的 headroom 留给下游（序列化器）原地写消息前缀，整条链路不再复制 payload
+struct ByteSlice {
+    std::shared_ptr<std::vector<uint8_t>> block;
+    size_t offset{0}; // payload 起始位置，即可用 headroom
+    size_t length{0};
+
+    uint8_t* data() { return block ? block->data() + offset : nullptr; }
+    const uint8_t* data() const { return block ? block->data() + offset : nullptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    size_t headroom() const { return offset; }
+    // payload 之后还能写入的字节数
+    size_t tailroom() const { return block ? block->size() - offset - length : 0; }
+
+    // 在 payload 前追加 n 字节（n <= headroom），返回新的起始指针
+    uint8_t* prepend(size_t n) {
+        offset -= n;
+        length += n;
+        return data();
+    }
+};
+
+// 固定块大小的缓冲池，只允许单个生产者线程调用 acquire：
+// - 块由 shared_ptr 持有，下游全部释放后（use_count 回到 1）即可复用，无需回调
+// - 预热后 acquire 不分配内存；全部在用时按需扩容，最多 max_blocks 个
+class BufferPool {
+public:
+    BufferPool(size_t block_size, size_t initial_blocks, size_t max_blocks);
+
+    // 取一个空闲块，payload 从 headroom 处开始、长度为 0
+    ByteSlice acquire(size_t headroom);
+
+    size_t blockSize() const { return block_size_; }
+    size_t blockCount() const { return blocks_.size(); }
+
+private:
+    size_t block_size_;
+    size_t max_blocks_;
+    size_t next_{0}; // 轮询起点
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> blocks_;
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // POOLED_BUFFER_HPP
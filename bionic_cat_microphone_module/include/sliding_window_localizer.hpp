@@ -0,0 +1,87 @@
+#ifndef SLIDING_WINDOW_LOCALIZER_HPP
+#define SLIDING_WINDOW_LOCALIZER_HPP
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "fft_radix2.hpp"
+#include "sound_localization.hpp"
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 单个 hop 的 TDOA 估计结果（mic1..3 相对 mic0，单位秒）
+struct TdoaEstimate {
+    std::array<float, 3> tdoa{};
+    std::array<float, 3> pair_confidence{};
+    float confidence{0.0f};
+    bool valid{false}; // 非静音且 confidence ≥ min_confidence：只有 valid 的估计才求方向、送入跟踪器
+};
+
+// 滑动窗口分析器：
+// - 每通道维护 window_size 长的环形缓冲，按 hop_size 前进，相邻窗口重叠
+// - 每个 hop 每通道只做一次 FFT，互功率谱 X0·conj(Xi) 在最近 accumulate_hops 个 hop 上累加
+// - 累加后做 PHAT 加权并逆变换，取 ±max_delay 范围内峰值（抛物线插值到亚样本）
+// 对拍手、唤名等短促声音，累积后的谱比单个 period 的时域互相关稳定得多
+class WorkerPool;
+
+class SlidingWindowAnalyzer {
+public:
+    SlidingWindowAnalyzer(const MicArrayConfig& config, int32_t max_delay_samples);
+
+    // 设置后每个 hop 的 4 路 FFT 与 3 对 GCC-PHAT 并行计算
+    void setWorkerPool(WorkerPool* pool) { pool_ = pool; }
+
+    // 追加 num_samples 个新样本；每凑满一个 hop 产生一个估计，写入 results（先清空）
+    // 返回产生的估计个数
+    uint32_t process(const std::array<std::vector<float>, 4>& audio_data,
+                     uint32_t num_samples,
+                     std::vector<TdoaEstimate>& results);
+
+    void reset();
+
+    // 热更新置信度门限：保留已累积的互功率谱历史，下一个 hop 起生效
+    void setMinConfidence(float min_confidence) { min_confidence_ = min_confidence; }
+
+    uint32_t windowSize() const { return window_size_; }
+    uint32_t hopSize() const { return hop_size_; }
+
+private:
+    void analyzeHop(TdoaEstimate& est);
+    void transformChannel(uint32_t c);
+    void correlatePair(uint32_t p, TdoaEstimate& est);
+    float findPeak(const float* corr, int32_t& best_delay, float& frac) const;
+
+    uint32_t window_size_;
+    uint32_t hop_size_;
+    uint32_t accumulate_hops_;
+    int32_t max_delay_;
+    uint32_t sample_rate_;
+    float min_confidence_;
+
+    // 每条并行通道一个 FFT 实例（内部有工作缓冲，不能跨线程共享）
+    std::vector<RealFft> ffts_;
+    std::vector<float> window_;                           // Hann 窗
+    std::array<std::vector<float>, 4> ring_;              // 每通道环形缓冲
+    uint32_t write_pos_{0};
+    uint32_t filled_{0};
+    uint32_t since_hop_{0};
+
+    std::array<std::vector<float>, 4> frame_;             // 展开 + 加窗后的时域帧
+    std::array<float, 4> energy_{};
+    std::array<std::vector<std::complex<float>>, 4> spec_;
+    // 互功率谱历史：[hop][pair][bin]，环形覆盖
+    std::vector<std::array<std::vector<std::complex<float>>, 3>> history_;
+    uint32_t history_pos_{0};
+    uint32_t history_count_{0};
+    std::array<std::vector<std::complex<float>>, 3> accum_;
+    std::array<std::vector<float>, 3> corr_;
+    WorkerPool* pool_{nullptr};
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // SLIDING_WINDOW_LOCALIZER_HPP
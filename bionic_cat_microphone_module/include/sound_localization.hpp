@@ -9,6 +9,8 @@
 namespace BionicCat {
 namespace MicrophoneModule {
 
+class WorkerPool;
+
 struct Vec3 {
     float x;
     float y;
@@ -36,6 +38,24 @@ struct MicArrayConfig {
     float min_confidence{0.3f};
     bool smoothing_enabled{true};
     float smoothing_alpha{0.3f};
+    // 滑动窗口多帧累积（GCC-PHAT），localization.sliding_window
+    bool sliding_window_enabled{false};
+    uint32_t window_size{2048};     // 分析窗长（样本，2 的幂）
+    uint32_t hop_size{512};         // 每次前进的样本数
+    uint32_t accumulate_hops{4};    // 互功率谱累积的 hop 数
+    // 多声源跟踪，localization.tracking（启用后替代 EMA 平滑）
+    bool tracking_enabled{false};
+    uint32_t max_tracks{4};         // 不超过 SourceTracker::kMaxTracks
+    float gate_deg{25.0f};          // 关联门限（方位角差，度）
+    uint32_t birth_hits{3};         // 确认一条轨迹所需命中次数
+    float track_timeout_s{1.5f};    // 超过该时间无观测则删除轨迹
+    float process_noise{400.0f};    // 角加速度噪声谱密度 (deg/s^2)^2
+    float measurement_noise_deg{6.0f};
+    // 并行：每帧把麦克风对/通道计算分给常驻线程（0 = 单线程），localization.parallel_workers
+    uint32_t parallel_workers{0};
+    // 延迟求和波束形成：按定位方向合成单声道送编码（beamforming 段）
+    bool beamforming_enabled{false};
+    int beamforming_taps{16};       // 分数延迟 FIR 阶数（4..32）
 };
 
 class MicArrayLocalizer {
@@ -46,7 +66,24 @@ public:
                   uint32_t num_samples,
                   float& azimuth, float& elevation, float& confidence);
 
+    // 由外部估计的 TDOA（秒，mic1..3 相对 mic0）求解方向，并应用平滑
+    bool resolveDirection(const std::array<float, 3>& tdoa,
+                          float& azimuth, float& elevation);
+
+    // 读取失败时回退到默认正四面体配置
     static MicArrayConfig loadConfig(const std::string& filepath);
+    // 热更新用：解析失败返回 false 且不修改 out（不回退默认配置）
+    static bool tryLoadConfig(const std::string& filepath, MicArrayConfig& out);
+    static bool parseConfig(const std::string& yaml_text, MicArrayConfig& out);
+
+    // 热更新时继承上一个实例的 EMA 平滑状态，避免方向跳变
+    void inheritState(const MicArrayLocalizer& previous);
+
+    // 设置后 localize 中三对互相关并行计算（pool 生命周期由调用方保证）
+    void setWorkerPool(WorkerPool* pool) { pool_ = pool; }
+
+    const MicArrayConfig& config() const { return config_; }
+    int maxTheoreticalDelay() const { return max_theoretical_delay_; }
 
     void calc4chSeparateDb(const std::array<std::vector<float>, 4>& channels,
                            double* db_out) const;
@@ -56,12 +93,17 @@ private:
     Vec3 smoothed_direction_;
     bool first_result_{true};
     int max_theoretical_delay_{0};
+    // 最小二乘伪逆 (AᵀA)⁻¹Aᵀ，A 的行为 mic_i - mic_0；构造时预计算
+    // direction = pinv_ · (tdoa * c)，平面阵列时第 3 行为 0
+    float pinv_[3][3]{};
+    bool solvable_{false};
+    WorkerPool* pool_{nullptr};
 
-    bool solve2D(const std::array<float, 3>& tdoa, Vec3& direction);
-    bool solve3D(const std::array<float, 3>& tdoa, Vec3& direction);
+    void precomputeSolver();
+    bool solve(const std::array<float, 3>& tdoa, Vec3& direction) const;
     float computeCrossCorrelation(const float* sig1, const float* sig2,
                                   uint32_t length, int32_t max_delay,
-                                  int32_t& best_delay);
+                                  int32_t& best_delay) const;
                                    
 };
 
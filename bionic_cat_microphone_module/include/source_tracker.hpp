@@ -0,0 +1,86 @@
+#ifndef SOURCE_TRACKER_HPP
+#define SOURCE_TRACKER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "sound_localization.hpp"
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 单次定位观测（来自 localize / 滑动窗口的一个 hop）
+struct SourceMeasurement {
+    float azimuth{0.0f};    // 度
+    float elevation{0.0f};  // 度
+    float confidence{0.0f};
+};
+
+// 对外发布的已确认声源
+struct TrackedSource {
+    uint32_t track_id{0};
+    float azimuth{0.0f};        // 度
+    float elevation{0.0f};      // 度
+    float azimuth_rate{0.0f};   // 度/秒
+    float confidence{0.0f};
+    uint32_t age_ms{0};
+};
+
+// 多声源跟踪器：
+// - 固定 kMaxTracks 个槽位，全部预分配，step 中无内存分配
+// - 每条轨迹方位角使用匀速模型卡尔曼滤波（角度环绕处理），仰角为随机游走
+// - 观测按最近邻 + 门限关联；未关联观测生成暂定轨迹，命中 birth_hits 次后确认
+// - 超过 track_timeout_s 无观测的轨迹删除
+// 两个说话人交替发声时各自保持一条轨迹，不会像 EMA 那样被平均到中间
+class SourceTracker {
+public:
+    static constexpr int kMaxTracks = 4;
+
+    explicit SourceTracker(const MicArrayConfig& config);
+
+    // 推进 dt 秒并融合本次观测（可为 0 个）
+    void step(float dt, const SourceMeasurement* measurements, size_t count);
+
+    // 输出已确认轨迹（按置信度降序），返回个数
+    size_t activeSources(std::array<TrackedSource, kMaxTracks>& out) const;
+
+    void reset();
+
+private:
+    struct Track {
+        bool used{false};
+        bool confirmed{false};
+        uint32_t id{0};
+        // 方位角状态 [角度, 角速度] 与协方差
+        float az{0.0f};
+        float az_rate{0.0f};
+        float p00{0.0f}, p01{0.0f}, p11{0.0f};
+        // 仰角（一维随机游走）
+        float el{0.0f};
+        float pel{0.0f};
+        float confidence{0.0f};
+        uint32_t hits{0};
+        float since_update_s{0.0f};
+        float age_s{0.0f};
+    };
+
+    void predict(Track& t, float dt) const;
+    void update(Track& t, const SourceMeasurement& m) const;
+    void spawn(const SourceMeasurement& m);
+
+    int max_tracks_;
+    float gate_deg_;
+    uint32_t birth_hits_;
+    float timeout_s_;
+    float q_;
+    float r_;
+    float min_confidence_;
+    uint32_t next_id_{1};
+    std::array<Track, kMaxTracks> tracks_{};
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // SOURCE_TRACKER_HPP
@@ -0,0 +1,63 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 固定线程数的小型并行池，用于把每帧的通道 FFT / 麦克风对互相关分摊到多核：
+// - 线程在构造时创建，之后常驻，每帧不创建线程、不分配内存
+// - parallelFor 下发一批任务后调用线程也参与执行，全部完成才返回（每帧一次屏障同步）
+// - workers = 0 时退化为调用线程串行执行
+class WorkerPool {
+public:
+    explicit WorkerPool(uint32_t workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    uint32_t workers() const { return static_cast<uint32_t>(threads_.size()); }
+
+    // 对 i ∈ [0, count) 调用 fn(i)，返回时所有任务已完成
+    template <typename F>
+    void parallelFor(uint32_t count, F&& fn) {
+        using Fn = typename std::remove_reference<F>::type;
+        run(count, &invoke<Fn>, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+private:
+    using TaskFn = void (*)(void*, uint32_t);
+
+    template <typename Fn>
+    static void invoke(void* ctx, uint32_t i) { (*static_cast<Fn*>(ctx))(i); }
+
+    void run(uint32_t count, TaskFn fn, void* ctx);
+    void drain();
+    void workerLoop();
+
+    std::vector<std::thread> threads_;
+    std::mutex mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_{0};
+    bool stop_{false};
+    uint32_t active_{0};            // 本批次尚未完成的后台线程数
+
+    TaskFn fn_{nullptr};
+    void* ctx_{nullptr};
+    uint32_t count_{0};
+    std::atomic<uint32_t> next_{0}; // 下一个待领取的任务下标
+};
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
+
+#endif // WORKER_POOL_HPP
@@ -0,0 +1,46 @@
+#include "adaptive_bitrate.hpp"
+
+#include <algorithm>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+AdaptiveBitrateController::AdaptiveBitrateController(const AdaptiveBitrateParams& params, uint32_t start_bps)
+    : params_(params) {
+    if (params_.max_bps < params_.min_bps) params_.max_bps = params_.min_bps;
+    bps_ = std::min(std::max(start_bps, params_.min_bps), params_.max_bps);
+}
+
+bool AdaptiveBitrateController::update(uint64_t now_ms, const PublishBacklog& sample, uint32_t& new_bps) {
+    if (!started_) {
+        started_ = true;
+        interval_start_ms_ = now_ms;
+        dropped_at_start_ = sample.dropped;
+    }
+    peak_in_flight_ = std::max(peak_in_flight_, sample.in_flight);
+    if (now_ms - interval_start_ms_ < params_.interval_ms) return false;
+
+    const bool dropped = sample.dropped > dropped_at_start_;
+    const uint32_t prev = bps_;
+    if (dropped || peak_in_flight_ >= params_.high_in_flight) {
+        bps_ = std::max(params_.min_bps, static_cast<uint32_t>(static_cast<float>(bps_) * params_.decrease_factor));
+        clean_intervals_ = 0;
+    } else if (peak_in_flight_ <= params_.low_in_flight) {
+        // 拥塞后先观察若干周期再回升，避免在临界点来回振荡
+        if (++clean_intervals_ >= params_.probe_intervals) {
+            bps_ = std::min(params_.max_bps, bps_ + params_.increase_bps);
+        }
+    } else {
+        clean_intervals_ = 0;
+    }
+
+    interval_start_ms_ = now_ms;
+    dropped_at_start_ = sample.dropped;
+    peak_in_flight_ = sample.in_flight;
+    if (bps_ == prev) return false;
+    new_bps = bps_;
+    return true;
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -0,0 +1,266 @@
+#include "audio_encoder.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+// Opus 为可选依赖：CMake 找到 opus::opus 并链接时定义 BIONIC_CAT_HAS_OPUS=1，编译与链接用同一条件；
+// 未定义时 OpusAudioEncoder::init 返回 false
+#ifndef BIONIC_CAT_HAS_OPUS
+  #define BIONIC_CAT_HAS_OPUS 0
+#endif
+#if BIONIC_CAT_HAS_OPUS
+  #include <opus/opus.h>
+#endif
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+const char* audioCodecName(AudioCodecType codec) {
+    switch (codec) {
+        case AudioCodecType::AAC_ADTS: return "aac";
+        case AudioCodecType::OPUS:     return "opus";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<AudioEncoder> createAudioEncoder(AudioCodecType codec) {
+    switch (codec) {
+        case AudioCodecType::AAC_ADTS: return std::make_unique<AACEncoder>();
+        case AudioCodecType::OPUS:     return std::make_unique<OpusAudioEncoder>();
+    }
+    return nullptr;
+}
+
+// -------- AACEncoder --------
+AACEncoder::AACEncoder() = default;
+AACEncoder::~AACEncoder() { close(); }
+
+bool AACEncoder::init(int sample_rate, int channels, int bitrate, int aot) {
+    close();
+
+    AACENC_ERROR err;
+    if ((err = aacEncOpen(&encoder_, 0, channels)) != AACENC_OK) {
+        std::fprintf(stderr, "aacEncOpen(): %d\n", err);
+        return false;
+    }
+
+    aacEncoder_SetParam(encoder_, AACENC_AOT, aot == 0 ? 2 : aot);
+    aacEncoder_SetParam(encoder_, AACENC_SAMPLERATE, sample_rate);
+    aacEncoder_SetParam(encoder_, AACENC_CHANNELMODE, channels == 1 ? MODE_1 : MODE_2);
+    aacEncoder_SetParam(encoder_, AACENC_BITRATE, bitrate);
+    // 使用 RAW 传输流，由我们手动添加 ADTS 头，避免重复 ADTS 导致解码错误
+    aacEncoder_SetParam(encoder_, AACENC_TRANSMUX, TT_MP4_RAW);
+
+    if ((err = aacEncEncode(encoder_, nullptr, nullptr, nullptr, nullptr)) != AACENC_OK) {
+        std::fprintf(stderr, "aacEncEncode(start): %d\n", err);
+        close();
+        return false;
+    }
+
+    AACENC_InfoStruct info{};
+    if (aacEncInfo(encoder_, &info) != AACENC_OK) {
+        std::fprintf(stderr, "aacEncInfo failed\n");
+        close();
+        return false;
+    }
+    // FDK 默认 1024 samples / ch / frame for LC
+    input_samples_per_frame_ = info.frameLength;
+    // 块布局：[headroom][7B ADTS 头][AAC 原始帧]，原始帧上限沿用 4 KB；
+    // 预分配的块数覆盖发布回调短暂阻塞时下游持有的帧
+    pool_ = std::make_unique<BufferPool>(kAdtsPayloadHeadroom + 7 + 4096, 8, 64);
+    samplerate_ = sample_rate;
+    channels_ = channels;
+    return true;
+}
+
+static int sfIndexFromRate(int samplerate) {
+    switch (samplerate) {
+        case 96000: return 0;
+        case 88200: return 1;
+        case 64000: return 2;
+        case 48000: return 3;
+        case 44100: return 4;
+        case 32000: return 5;
+        case 24000: return 6;
+        case 22050: return 7;
+        case 16000: return 8;
+        case 12000: return 9;
+        case 11025: return 10;
+        case 8000:  return 11;
+        default:    return 3;
+    }
+}
+
+void AACEncoder::writeAdtsHeader(uint8_t* adts, int aac_length, int samplerate, int channels) {
+    const int sf_index = sfIndexFromRate(samplerate);
+    const int adts_len = aac_length + 7;
+
+    // ADTS Profile 固定为 AAC LC (1)，确保与编码配置匹配
+    const int profile = 1; // AAC LC
+
+    adts[0] = 0xFF;
+    adts[1] = 0xF1;               // MPEG-4, layer=0, protection_absent=1
+    adts[2] = (profile << 6) | (sf_index << 2) | ((channels & 0x4) >> 2);
+    adts[3] = ((channels & 0x3) << 6) | ((adts_len >> 11) & 0x03);
+    adts[4] = (adts_len >> 3) & 0xFF;
+    adts[5] = ((adts_len & 0x7) << 5) | 0x1F; // buffer fullness 0x7FF (VBR)
+    adts[6] = 0xFC; // number_of_raw_data_blocks_in_frame = 0
+}
+
+bool AACEncoder::encode(const int16_t* pcm_data, size_t samples, ByteSlice& out_adts) {
+    if (!encoder_) return false;
+    // 准备输入缓冲
+    AACENC_BufDesc in_buf{}; AACENC_BufDesc out_buf{};
+    AACENC_InArgs in_args{}; AACENC_OutArgs out_args{};
+
+    void* in_ptr = const_cast<int16_t*>(pcm_data);
+    int in_size = static_cast<int>(samples * sizeof(int16_t));
+    int in_elem = sizeof(int16_t);
+
+    in_buf.numBufs = 1;
+    in_buf.bufs = &in_ptr;
+    int in_id = IN_AUDIO_DATA; // 需要稳定地址
+    in_buf.bufferIdentifiers = &in_id;
+    in_buf.bufSizes = &in_size;
+    in_buf.bufElSizes = &in_elem;
+
+    // 输出直接写入池化块，留出 headroom 与 7 字节 ADTS 头
+    ByteSlice slice = pool_->acquire(kAdtsPayloadHeadroom);
+    uint8_t* adts = slice.data();
+    void* out_ptr = adts + 7;
+    int out_size = static_cast<int>(slice.tailroom() - 7);
+    int out_elem = 1;
+
+    out_buf.numBufs = 1;
+    out_buf.bufs = &out_ptr;
+    int out_id = OUT_BITSTREAM_DATA;
+    out_buf.bufferIdentifiers = &out_id;
+    out_buf.bufSizes = &out_size;
+    out_buf.bufElSizes = &out_elem;
+
+    // FDK 需要的是每通道样本数
+    in_args.numInSamples = static_cast<int>(samples);
+
+    const AACENC_ERROR err = aacEncEncode(encoder_, &in_buf, &out_buf, &in_args, &out_args);
+    if (err != AACENC_OK) {
+        std::fprintf(stderr, "aacEncEncode(): %d\n", err);
+        return false;
+    }
+
+    out_adts = ByteSlice{};
+    if (out_args.numOutBytes > 0) {
+        writeAdtsHeader(adts, out_args.numOutBytes, samplerate_, channels_);
+        slice.length = 7 + static_cast<size_t>(out_args.numOutBytes);
+        out_adts = std::move(slice);
+        return true;
+    }
+    return true; // 仅表示调用成功，可能没有输出（编码器内部缓冲）
+}
+
+bool AACEncoder::setBitrate(int bitrate) {
+    if (!encoder_) return false;
+    // FDK 在下一次 aacEncEncode 时按新码率重新配置码率控制，不清空输入缓冲
+    const AACENC_ERROR err = aacEncoder_SetParam(encoder_, AACENC_BITRATE, static_cast<UINT>(bitrate));
+    if (err != AACENC_OK) {
+        std::fprintf(stderr, "aacEncoder_SetParam(BITRATE=%d): %d\n", bitrate, err);
+        return false;
+    }
+    return true;
+}
+
+void AACEncoder::close() {
+    if (encoder_) {
+        aacEncClose(&encoder_);
+        encoder_ = nullptr;
+    }
+    pool_.reset();
+}
+
+// -------- OpusAudioEncoder --------
+OpusAudioEncoder::OpusAudioEncoder() = default;
+OpusAudioEncoder::~OpusAudioEncoder() { close(); }
+
+bool OpusAudioEncoder::available() { return BIONIC_CAT_HAS_OPUS != 0; }
+
+#if BIONIC_CAT_HAS_OPUS
+
+bool OpusAudioEncoder::init(int sample_rate, int channels, int bitrate, int /*aot*/) {
+    close();
+
+    int err = OPUS_OK;
+    encoder_ = opus_encoder_create(sample_rate, channels, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK || !encoder_) {
+        std::fprintf(stderr, "opus_encoder_create(%d Hz): %s\n", sample_rate, opus_strerror(err));
+        encoder_ = nullptr;
+        return false;
+    }
+    opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate));
+    opus_encoder_ctl(encoder_, OPUS_SET_COMPLEXITY(kComplexity));
+    opus_encoder_ctl(encoder_, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+
+    frame_samples_per_ch_ = sample_rate * kFrameMs / 1000;
+    channels_ = channels;
+    // 单个 Opus 包最大 1275 字节
+    pool_ = std::make_unique<BufferPool>(kAdtsPayloadHeadroom + 1276, 8, 64);
+    return true;
+}
+
+bool OpusAudioEncoder::encode(const int16_t* pcm_data, size_t samples, ByteSlice& out) {
+    out = ByteSlice{};
+    if (!encoder_) return false;
+    if (samples != static_cast<size_t>(frame_samples_per_ch_ * channels_)) {
+        std::fprintf(stderr, "opus_encode(): expected %d samples, got %zu\n",
+                     frame_samples_per_ch_ * channels_, samples);
+        return false;
+    }
+
+    ByteSlice slice = pool_->acquire(kAdtsPayloadHeadroom);
+    const opus_int32 n = opus_encode(encoder_, pcm_data, frame_samples_per_ch_, slice.data(),
+                                     static_cast<opus_int32>(slice.tailroom()));
+    if (n < 0) {
+        std::fprintf(stderr, "opus_encode(): %s\n", opus_strerror(n));
+        return false;
+    }
+    slice.length = static_cast<size_t>(n);
+    out = std::move(slice);
+    return true;
+}
+
+bool OpusAudioEncoder::setBitrate(int bitrate) {
+    if (!encoder_) return false;
+    const int err = opus_encoder_ctl(encoder_, OPUS_SET_BITRATE(bitrate));
+    if (err != OPUS_OK) {
+        std::fprintf(stderr, "opus_encoder_ctl(SET_BITRATE=%d): %s\n", bitrate, opus_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+void OpusAudioEncoder::close() {
+    if (encoder_) {
+        opus_encoder_destroy(encoder_);
+        encoder_ = nullptr;
+    }
+    pool_.reset();
+}
+
+#else
+
+bool OpusAudioEncoder::init(int, int, int, int) {
+    std::cerr << "[OpusAudioEncoder] Built without libopus (opus/opus.h not found)" << std::endl;
+    return false;
+}
+
+bool OpusAudioEncoder::encode(const int16_t*, size_t, ByteSlice& out) {
+    out = ByteSlice{};
+    return false;
+}
+
+bool OpusAudioEncoder::setBitrate(int) { return false; }
+
+void OpusAudioEncoder::close() {}
+
+#endif // BIONIC_CAT_HAS_OPUS
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -0,0 +1,175 @@
+#include "beamformer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define BEAMFORMER_NEON 1
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+  #define BEAMFORMER_SSE 1
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// y[i] += Σ_k h[k] * x[i - k]，i ∈ [0, n)；调用方保证 x[-(taps-1)] 可读
+static void firAccumulate(float* y, const float* x, const float* h, int taps, size_t n) {
+    size_t i = 0;
+#if defined(BEAMFORMER_NEON)
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t acc = vld1q_f32(y + i);
+        for (int k = 0; k < taps; ++k) {
+            acc = vmlaq_n_f32(acc, vld1q_f32(x + i - k), h[k]);
+        }
+        vst1q_f32(y + i, acc);
+    }
+#elif defined(BEAMFORMER_SSE)
+    for (; i + 4 <= n; i += 4) {
+        __m128 acc = _mm_loadu_ps(y + i);
+        for (int k = 0; k < taps; ++k) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i - k), _mm_set1_ps(h[k])));
+        }
+        _mm_storeu_ps(y + i, acc);
+    }
+#endif
+    for (; i < n; ++i) {
+        float acc = y[i];
+        for (int k = 0; k < taps; ++k) acc += h[k] * x[i - k];
+        y[i] = acc;
+    }
+}
+
+DelayAndSumBeamformer::DelayAndSumBeamformer(const MicArrayConfig& config, uint32_t max_period_samples, int taps)
+    : mic_positions_(config.mic_positions)
+    , sound_speed_(config.sound_speed)
+    , sample_rate_(static_cast<float>(config.sample_rate))
+    , taps_(std::max(4, std::min(taps, kMaxTaps)))
+    , max_period_(max_period_samples) {
+    float max_dist = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = i + 1; j < 4; ++j) {
+            max_dist = std::max(max_dist, (mic_positions_[j] - mic_positions_[i]).magnitude());
+        }
+    }
+    const int32_t max_shift = static_cast<int32_t>(std::ceil(max_dist / sound_speed_ * sample_rate_)) + 1;
+    history_ = max_shift + taps_;
+    for (auto& b : buf_) b.assign(static_cast<size_t>(history_) + max_period_, 0.0f);
+    mix_.assign(max_period_, 0.0f);
+    mix_old_.assign(max_period_, 0.0f);
+    // 未指向前等同于不加延迟的 4 路平均
+    for (auto& s : current_.shift) s = 0;
+    for (auto& t : current_.taps) {
+        std::fill(t.begin(), t.end(), 0.0f);
+        t[taps_ / 2 - 1] = 1.0f;
+    }
+}
+
+void DelayAndSumBeamformer::design(float azimuth_deg, float elevation_deg, Steering& s) const {
+    // 与定位器输出同一方向约定：方向向量 d 下第 m 路的相对到达时刻为 p_m·d / c
+    const float az = azimuth_deg * static_cast<float>(M_PI) / 180.0f;
+    const float el = elevation_deg * static_cast<float>(M_PI) / 180.0f;
+    const Vec3 d(std::cos(el) * std::cos(az), std::cos(el) * std::sin(az), std::sin(el));
+
+    std::array<float, 4> arrival{};
+    float latest = -1e30f;
+    for (int m = 0; m < 4; ++m) {
+        arrival[m] = mic_positions_[m].dot(d) / sound_speed_ * sample_rate_;
+        latest = std::max(latest, arrival[m]);
+    }
+
+    // 先到达的通道多延迟，使 4 路对齐到最晚到达者；FIR 自身群延迟 taps/2-1 对所有通道相同
+    const int center = taps_ / 2 - 1;
+    for (int m = 0; m < 4; ++m) {
+        const float shift = latest - arrival[m];
+        const float ip = std::floor(shift);
+        const float frac = shift - ip;
+        s.shift[m] = static_cast<int32_t>(ip);
+        float sum = 0.0f;
+        for (int k = 0; k < kMaxTaps; ++k) {
+            if (k >= taps_) { s.taps[m][k] = 0.0f; continue; }
+            const float x = static_cast<float>(k - center) - frac;
+            const float sinc = std::fabs(x) < 1e-6f ? 1.0f
+                             : std::sin(static_cast<float>(M_PI) * x) / (static_cast<float>(M_PI) * x);
+            // Blackman 窗，中心与 sinc 峰值（center + frac）对齐
+            const float t = (static_cast<float>(k) + 1.0f - frac) / static_cast<float>(taps_);
+            const float w = 0.42f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * t)
+                          + 0.08f * std::cos(4.0f * static_cast<float>(M_PI) * t);
+            s.taps[m][k] = sinc * w;
+            sum += s.taps[m][k];
+        }
+        // 直流增益归一
+        if (std::fabs(sum) > 1e-6f) {
+            for (int k = 0; k < taps_; ++k) s.taps[m][k] /= sum;
+        }
+    }
+}
+
+void DelayAndSumBeamformer::steer(float azimuth_deg, float elevation_deg, float retune_deg) {
+    if (steered_) {
+        float daz = std::fabs(azimuth_deg - az_);
+        if (daz > 180.0f) daz = 360.0f - daz;
+        if (daz < retune_deg && std::fabs(elevation_deg - el_) < retune_deg) return;
+    }
+    previous_ = current_;
+    design(azimuth_deg, elevation_deg, current_);
+    crossfade_ = true;
+    steered_ = true;
+    az_ = azimuth_deg;
+    el_ = elevation_deg;
+}
+
+void DelayAndSumBeamformer::render(const Steering& s, size_t n, float* y) const {
+    std::fill(y, y + n, 0.0f);
+    for (int m = 0; m < 4; ++m) {
+        const float* x = buf_[m].data() + history_ - s.shift[m];
+        firAccumulate(y, x, s.taps[m].data(), taps_, n);
+    }
+}
+
+void DelayAndSumBeamformer::process(const std::vector<std::vector<int16_t>>& in, size_t n, std::vector<int16_t>& out) {
+    // 超过预分配长度的部分不处理；先截断再定输出长度，避免 out 尾部留着未写入的旧数据
+    if (n > max_period_) n = max_period_;
+    out.resize(n);
+    if (in.size() < 4 || n == 0) return;
+
+    // 追加当前 period（历史段保留在前部）
+    for (int m = 0; m < 4; ++m) {
+        float* dst = buf_[m].data() + history_;
+        const int16_t* src = in[m].data();
+        for (size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(src[i]);
+    }
+
+    render(current_, n, mix_.data());
+    if (crossfade_) {
+        render(previous_, n, mix_old_.data());
+        const float step = 1.0f / static_cast<float>(n);
+        for (size_t i = 0; i < n; ++i) {
+            const float g = static_cast<float>(i) * step;
+            mix_[i] = g * mix_[i] + (1.0f - g) * mix_old_[i];
+        }
+        crossfade_ = false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        int32_t v = static_cast<int32_t>(std::lrint(mix_[i] * 0.25f));
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        out[i] = static_cast<int16_t>(v);
+    }
+
+    // 把本 period 末尾移到历史段
+    for (int m = 0; m < 4; ++m) {
+        float* b = buf_[m].data();
+        std::memmove(b, b + n, static_cast<size_t>(history_) * sizeof(float));
+    }
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -1,4 +1,6 @@
 #include "capture_audio.hpp"
+#include "frame_accumulator.hpp"
+#include "audio_dsp.h"
 
 #include <cstring>
 #include <cstdio>
@@ -10,6 +12,11 @@
 #include <condition_variable>
 #include <atomic>
 #include <ostream>
+#include <algorithm>
+#include <iostream>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 // 仅在实现中包含 tinyalsa 头，兼容不同安装路径
 #if __has_include(<tinyalsa/asoundlib.h>)
   #include <tinyalsa/asoundlib.h>
@@ -53,6 +60,7 @@ bool AudioCapture::open(int card, int device, int rate, int channels,
     period_size_ = period_size;
     period_count_ = period_count;
     gain_ = 1.0f;
+    xrun_started_ = false;
     return true;
 }
 
@@ -77,9 +85,35 @@ bool AudioCapture::openMulti(int card, int device, const AudioConfig& cfg) {
     period_size_ = static_cast<int>(pc.period_size);
     period_count_ = static_cast<int>(pc.period_count);
     gain_ = cfg.audio_gain; // 设置增益
+    xrun_started_ = false;
     return true;
 }
 
+// 读到的帧数落后于按时钟应采集的帧数超过整个环形缓冲时，说明驱动已覆盖未读数据
+void AudioCapture::trackXrun() {
+    const auto now = std::chrono::steady_clock::now();
+    if (!xrun_started_) {
+        // 首次 pcm_read 返回时采集刚启动，以此为基线
+        xrun_started_ = true;
+        xrun_t0_ = now;
+        xrun_frames_ = 0;
+        return;
+    }
+    xrun_frames_ += static_cast<uint64_t>(period_size_);
+    const double elapsed_s = std::chrono::duration<double>(now - xrun_t0_).count();
+    const double lag = elapsed_s * rate_ - static_cast<double>(xrun_frames_);
+    if (lag > static_cast<double>(period_size_) * period_count_) {
+        xruns_.fetch_add(1, std::memory_order_relaxed);
+        xrun_t0_ = now;
+        xrun_frames_ = 0;
+    } else if (xrun_frames_ >= static_cast<uint64_t>(rate_) * 10) {
+        // 每 10 s 重设基线（保留当前积压），避免声卡时钟与系统时钟的 ppm 偏差长期累积
+        xrun_t0_ = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(std::max(0.0, lag) / rate_));
+        xrun_frames_ = 0;
+    }
+}
+
 void AudioCapture::close() {
     if (pcm_) {
         pcm_close(pcm_);
@@ -95,14 +129,10 @@ bool AudioCapture::readPeriod(std::vector<int16_t>& out) {
         std::fprintf(stderr, "pcm_read error: %s\n", pcm_get_error(pcm_));
         return false;
     }
+    trackXrun();
     // 应用增益并饱和
     if (gain_ != 1.0f) {
-        for (size_t i = 0; i < out.size(); ++i) {
-            int32_t v = static_cast<int32_t>(std::lround(out[i] * gain_));
-            if (v > 32767) v = 32767;
-            if (v < -32768) v = -32768;
-            out[i] = static_cast<int16_t>(v);
-        }
+        bc_dsp_gain_s16(out.data(), out.size(), gain_);
     }
     return true;
 }
@@ -121,153 +151,19 @@ bool AudioCapture::readMultiPeriod(std::vector<std::vector<int16_t>>& outPerChan
         std::fprintf(stderr, "pcm_read error: %s\n", pcm_get_error(pcm_));
         return false;
     }
+    trackXrun();
 
-    outPerChannel.assign(static_cast<size_t>(ch), std::vector<int16_t>(static_cast<size_t>(frames)));
-    for (int f = 0; f < frames; ++f) {
-        const int base = f * ch;
-        for (int c = 0; c < ch; ++c) {
-            int32_t v = static_cast<int32_t>(buf[static_cast<size_t>(base + c)]);
-            if (gain_ != 1.0f) {
-                v = static_cast<int32_t>(std::lround(v * gain_));
-            }
-            if (v > 32767) v = 32767;
-            if (v < -32768) v = -32768;
-            outPerChannel[c][static_cast<size_t>(f)] = static_cast<int16_t>(v);
-        }
-    }
-    return true;
-}
-
-// -------- AACEncoder --------
-AACEncoder::AACEncoder() = default;
-AACEncoder::~AACEncoder() { close(); }
-
-bool AACEncoder::init(int sample_rate, int channels, int bitrate, int aot) {
-    close();
-
-    AACENC_ERROR err;
-    if ((err = aacEncOpen(&encoder_, 0, channels)) != AACENC_OK) {
-        std::fprintf(stderr, "aacEncOpen(): %d\n", err);
-        return false;
-    }
-
-    aacEncoder_SetParam(encoder_, AACENC_AOT, aot == 0 ? 2 : aot);
-    aacEncoder_SetParam(encoder_, AACENC_SAMPLERATE, sample_rate);
-    aacEncoder_SetParam(encoder_, AACENC_CHANNELMODE, channels == 1 ? MODE_1 : MODE_2);
-    aacEncoder_SetParam(encoder_, AACENC_BITRATE, bitrate);
-    // 使用 RAW 传输流，由我们手动添加 ADTS 头，避免重复 ADTS 导致解码错误
-    aacEncoder_SetParam(encoder_, AACENC_TRANSMUX, TT_MP4_RAW);
-
-    if ((err = aacEncEncode(encoder_, nullptr, nullptr, nullptr, nullptr)) != AACENC_OK) {
-        std::fprintf(stderr, "aacEncEncode(start): %d\n", err);
-        close();
-        return false;
-    }
-
-    AACENC_InfoStruct info{};
-    if (aacEncInfo(encoder_, &info) != AACENC_OK) {
-        std::fprintf(stderr, "aacEncInfo failed\n");
-        close();
-        return false;
+    // 先在交织数据上整块做增益，再去交织
+    if (gain_ != 1.0f) {
+        bc_dsp_gain_s16(buf.data(), buf.size(), gain_);
     }
-    // FDK 默认 1024 samples / ch / frame for LC
-    input_samples_per_frame_ = info.frameLength;
-    samplerate_ = sample_rate;
-    channels_ = channels;
+    outPerChannel.assign(static_cast<size_t>(ch), std::vector<int16_t>(static_cast<size_t>(frames)));
+    std::vector<int16_t*> planes(static_cast<size_t>(ch));
+    for (int c = 0; c < ch; ++c) planes[static_cast<size_t>(c)] = outPerChannel[static_cast<size_t>(c)].data();
+    bc_dsp_deinterleave_s16(buf.data(), static_cast<size_t>(frames), static_cast<unsigned>(ch), planes.data());
     return true;
 }
 
-static int sfIndexFromRate(int samplerate) {
-    switch (samplerate) {
-        case 96000: return 0;
-        case 88200: return 1;
-        case 64000: return 2;
-        case 48000: return 3;
-        case 44100: return 4;
-        case 32000: return 5;
-        case 24000: return 6;
-        case 22050: return 7;
-        case 16000: return 8;
-        case 12000: return 9;
-        case 11025: return 10;
-        case 8000:  return 11;
-        default:    return 3;
-    }
-}
-
-void AACEncoder::writeAdtsHeader(uint8_t* adts, int aac_length, int samplerate, int channels) {
-    const int sf_index = sfIndexFromRate(samplerate);
-    const int adts_len = aac_length + 7;
-
-    // ADTS Profile 固定为 AAC LC (1)，确保与编码配置匹配
-    const int profile = 1; // AAC LC
-
-    adts[0] = 0xFF;
-    adts[1] = 0xF1;               // MPEG-4, layer=0, protection_absent=1
-    adts[2] = (profile << 6) | (sf_index << 2) | ((channels & 0x4) >> 2);
-    adts[3] = ((channels & 0x3) << 6) | ((adts_len >> 11) & 0x03);
-    adts[4] = (adts_len >> 3) & 0xFF;
-    adts[5] = ((adts_len & 0x7) << 5) | 0x1F; // buffer fullness 0x7FF (VBR)
-    adts[6] = 0xFC; // number_of_raw_data_blocks_in_frame = 0
-}
-
-bool AACEncoder::encode(const int16_t* pcm_data, size_t samples, std::vector<uint8_t>& out_adts) {
-    if (!encoder_) return false;
-    // 准备输入缓冲
-    AACENC_BufDesc in_buf{}; AACENC_BufDesc out_buf{};
-    AACENC_InArgs in_args{}; AACENC_OutArgs out_args{};
-
-    void* in_ptr = const_cast<int16_t*>(pcm_data);
-    int in_size = static_cast<int>(samples * sizeof(int16_t));
-    int in_elem = sizeof(int16_t);
-
-    in_buf.numBufs = 1;
-    in_buf.bufs = &in_ptr;
-    int in_id = IN_AUDIO_DATA; // 需要稳定地址
-    in_buf.bufferIdentifiers = &in_id;
-    in_buf.bufSizes = &in_size;
-    in_buf.bufElSizes = &in_elem;
-
-    uint8_t aac_buf[4096];
-    void* out_ptr = aac_buf;
-    int out_size = static_cast<int>(sizeof(aac_buf));
-    int out_elem = 1;
-
-    out_buf.numBufs = 1;
-    out_buf.bufs = &out_ptr;
-    int out_id = OUT_BITSTREAM_DATA;
-    out_buf.bufferIdentifiers = &out_id;
-    out_buf.bufSizes = &out_size;
-    out_buf.bufElSizes = &out_elem;
-
-    // FDK 需要的是每通道样本数
-    in_args.numInSamples = static_cast<int>(samples);
-
-    const AACENC_ERROR err = aacEncEncode(encoder_, &in_buf, &out_buf, &in_args, &out_args);
-    if (err != AACENC_OK) {
-        std::fprintf(stderr, "aacEncEncode(): %d\n", err);
-        return false;
-    }
-
-    out_adts.clear();
-    if (out_args.numOutBytes > 0) {
-        uint8_t adts[7];
-        writeAdtsHeader(adts, out_args.numOutBytes, samplerate_, channels_);
-        out_adts.reserve(7 + out_args.numOutBytes);
-        out_adts.insert(out_adts.end(), adts, adts + 7);
-        out_adts.insert(out_adts.end(), aac_buf, aac_buf + out_args.numOutBytes);
-        return true;
-    }
-    return true; // 仅表示调用成功，可能没有输出（编码器内部缓冲）
-}
-
-void AACEncoder::close() {
-    if (encoder_) {
-        aacEncClose(&encoder_);
-        encoder_ = nullptr;
-    }
-}
-
 // -------- MicrophoneAdtsStreamer --------
 MicrophoneAdtsStreamer::MicrophoneAdtsStreamer() = default;
 MicrophoneAdtsStreamer::~MicrophoneAdtsStreamer() { stop(); }
@@ -280,7 +176,12 @@ bool MicrophoneAdtsStreamer::start(const Config& cfg) {
     AudioConfig acfg{};
     if (cfg.enable_localization) {
         mic_cfg_ = MicArrayLocalizer::loadConfig(cfg.localization_config_path);
-        localizer_ = std::make_unique<MicArrayLocalizer>(mic_cfg_);
+        loc_ = buildLocalization(mic_cfg_);
+        std::atomic_store(&pending_loc_, std::shared_ptr<LocalizationState>());
+        std::atomic_store(&pending_beamformer_, std::shared_ptr<BeamformerSlot>());
+        steer_valid_.store(false);
+        beam_cfg_ = mic_cfg_;
+        beamformer_ = buildBeamformer(mic_cfg_);
         acfg.sample_rate = mic_cfg_.sample_rate;
         acfg.frame_size = mic_cfg_.frame_size;
         acfg.channels = mic_cfg_.channels;
@@ -288,6 +189,9 @@ bool MicrophoneAdtsStreamer::start(const Config& cfg) {
         acfg.period_count = cfg.period_count;
  
     } else {
+        loc_.reset();
+        beamformer_.reset();
+        std::atomic_store(&pending_beamformer_, std::shared_ptr<BeamformerSlot>());
         acfg.sample_rate = cfg.sample_rate;
         acfg.frame_size = cfg.period_size;
         acfg.channels = cfg.channels;
@@ -305,19 +209,54 @@ bool MicrophoneAdtsStreamer::start(const Config& cfg) {
         return false;
     }
 
-    // 编码固定单通道
-    if (!enc_.init(cfg.sample_rate, /*channels*/1, cfg.bit_rate, cfg.aot)) {
-        cap_.close();
-        return false;
+    // 编码固定单通道；Opus 不可用（未编译或采样率不支持）时回退到 AAC
+    enc_ = createAudioEncoder(cfg.codec);
+    if (!enc_ || !enc_->init(cfg.sample_rate, /*channels*/1, cfg.bit_rate, cfg.aot)) {
+        if (cfg.codec == AudioCodecType::AAC_ADTS) {
+            enc_.reset();
+            cap_.close();
+            return false;
+        }
+        std::cerr << "[MicrophoneAdtsStreamer] Codec " << audioCodecName(cfg.codec)
+                  << " unavailable, falling back to aac" << std::endl;
+        enc_ = createAudioEncoder(AudioCodecType::AAC_ADTS);
+        if (!enc_->init(cfg.sample_rate, /*channels*/1, cfg.bit_rate, cfg.aot)) {
+            enc_.reset();
+            cap_.close();
+            return false;
+        }
+    }
+    cfg_.codec = enc_->codec();
+    bit_rate_.store(cfg.bit_rate);
+
+    localize_enabled_ = cfg.enable_localization && loc_;
+    periods_captured_.store(0);
+    input_dbfs_max_.store(BC_DSP_DBFS_FLOOR);
+    encode_queue_drops_.store(0);
+    localize_queue_drops_.store(0);
+    {
+        std::lock_guard<std::mutex> lk(queue_mtx_);
+        encode_queue_high_water_ = 0;
+        localize_queue_high_water_ = 0;
     }
+    encode_timing_.count.store(0);
+    encode_timing_.reset();
+    localize_timing_.count.store(0);
+    localize_timing_.reset();
+    stats_window_start_ms_.store(nowMs());
+    std::cout << "[MicrophoneAdtsStreamer] Encoder: " << audioCodecName(cfg_.codec)
+              << ", frame=" << enc_->frameSamplesPerCh() << " samples" << std::endl;
 
     running_.store(true);
     // 启动生产者与两个消费者线程
     producer_ = std::thread(&MicrophoneAdtsStreamer::run, this);
     encoder_  = std::thread(&MicrophoneAdtsStreamer::runEncode, this);
-    if (cfg.enable_localization && localizer_) {
+    if (localize_enabled_) {
         std::cout << "[MicrophoneAdtsStreamer] Starting localization thread." << std::endl;
         localizer_thr_ = std::thread(&MicrophoneAdtsStreamer::runLocalize, this);
+        if (cfg.watch_localization_config) {
+            config_watch_thr_ = std::thread(&MicrophoneAdtsStreamer::runConfigWatch, this);
+        }
     }
 
     // 发送控制开始
@@ -328,6 +267,7 @@ bool MicrophoneAdtsStreamer::start(const Config& cfg) {
         c.channels = 1; // 固定单声道编码
         c.bit_rate = cfg.bit_rate;
         c.aot = cfg.aot;
+        c.codec = cfg_.codec;
         ctrl_cb_(c);
     }
     return true;
@@ -339,6 +279,7 @@ void MicrophoneAdtsStreamer::stop() {
         if (producer_.joinable()) producer_.join();
         if (encoder_.joinable()) encoder_.join();
         if (localizer_thr_.joinable()) localizer_thr_.join();
+        if (config_watch_thr_.joinable()) config_watch_thr_.join();
         return;
     }
 
@@ -351,17 +292,19 @@ void MicrophoneAdtsStreamer::stop() {
     if (producer_.joinable()) producer_.join();
     if (encoder_.joinable()) encoder_.join();
     if (localizer_thr_.joinable()) localizer_thr_.join();
+    if (config_watch_thr_.joinable()) config_watch_thr_.join();
 
     cap_.close();
-    enc_.close();
+    if (enc_) enc_->close();
 
     if (ctrl_cb_) {
         AdtsStreamControl c{};
         c.is_start = false;
         c.sample_rate = cfg_.sample_rate;
         c.channels = cfg_.channels;
-        c.bit_rate = cfg_.bit_rate;
+        c.bit_rate = bit_rate_.load();
         c.aot = cfg_.aot;
+        c.codec = cfg_.codec;
         ctrl_cb_(c);
     }
 }
@@ -371,6 +314,63 @@ uint64_t MicrophoneAdtsStreamer::nowMs() {
     return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
+// -------- 统计 --------
+void MicrophoneAdtsStreamer::StageTiming::record(uint32_t us) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    window_count.fetch_add(1, std::memory_order_relaxed);
+    window_total_us.fetch_add(us, std::memory_order_relaxed);
+    // 单写者，读-比较-写即可
+    if (us > window_max_us.load(std::memory_order_relaxed)) {
+        window_max_us.store(us, std::memory_order_relaxed);
+    }
+}
+
+void MicrophoneAdtsStreamer::StageTiming::reset() {
+    window_count.store(0, std::memory_order_relaxed);
+    window_total_us.store(0, std::memory_order_relaxed);
+    window_max_us.store(0, std::memory_order_relaxed);
+}
+
+StreamerStats MicrophoneAdtsStreamer::stats(bool reset_window) {
+    StreamerStats s{};
+    const uint64_t now = nowMs();
+    s.window_ms = static_cast<uint32_t>(now - stats_window_start_ms_.load());
+    s.periods_captured = periods_captured_.load(std::memory_order_relaxed);
+    s.capture_xruns = cap_.xruns();
+    s.queue_capacity = static_cast<uint32_t>(max_queue_size_);
+    s.encode_queue_drops = encode_queue_drops_.load(std::memory_order_relaxed);
+    s.localize_queue_drops = localize_queue_drops_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lk(queue_mtx_);
+        s.encode_queue_high_water = static_cast<uint32_t>(encode_queue_high_water_);
+        s.localize_queue_high_water = static_cast<uint32_t>(localize_queue_high_water_);
+        if (reset_window) {
+            encode_queue_high_water_ = encode_queue_.size();
+            localize_queue_high_water_ = localize_queue_.size();
+        }
+    }
+    auto fill = [](const StageTiming& t, uint64_t& count, float& avg, float& max) {
+        count = t.count.load(std::memory_order_relaxed);
+        const uint64_t n = t.window_count.load(std::memory_order_relaxed);
+        avg = n ? static_cast<float>(t.window_total_us.load(std::memory_order_relaxed)) / static_cast<float>(n) : 0.0f;
+        max = static_cast<float>(t.window_max_us.load(std::memory_order_relaxed));
+    };
+    fill(encode_timing_, s.frames_encoded, s.encode_us_avg, s.encode_us_max);
+    fill(localize_timing_, s.periods_localized, s.localize_us_avg, s.localize_us_max);
+    if (cap_.rate() > 0) {
+        s.period_us = 1e6f * static_cast<float>(cap_.periodSize()) / static_cast<float>(cap_.rate());
+    }
+    s.bit_rate = bit_rate_.load(std::memory_order_relaxed);
+    s.input_dbfs = input_dbfs_max_.load(std::memory_order_relaxed);
+    if (reset_window) {
+        input_dbfs_max_.store(BC_DSP_DBFS_FLOOR, std::memory_order_relaxed);
+        encode_timing_.reset();
+        localize_timing_.reset();
+        stats_window_start_ms_.store(now);
+    }
+    return s;
+}
+
 // 生产者：采集并推入队列
 void MicrophoneAdtsStreamer::run() {
     while (running_.load()) {
@@ -379,18 +379,30 @@ void MicrophoneAdtsStreamer::run() {
             break;
         }
         if (period_ch.empty()) continue;
+        const float db = bc_dsp_dbfs_s16(period_ch[0].data(), period_ch[0].size());
+        if (db > input_dbfs_max_.load(std::memory_order_relaxed)) {
+            input_dbfs_max_.store(db, std::memory_order_relaxed);
+        }
         // 为同一帧创建共享指针，分别推入两个队列
         FramePtr frame = std::make_shared<std::vector<std::vector<int16_t>>>(std::move(period_ch));
+        periods_captured_.fetch_add(1, std::memory_order_relaxed);
         {
             std::unique_lock<std::mutex> lk(queue_mtx_);
             if (encode_queue_.size() >= max_queue_size_) {
                 encode_queue_.pop_front();
-            }
-            if (localize_queue_.size() >= max_queue_size_) {
-                localize_queue_.pop_front();
+                encode_queue_drops_.fetch_add(1, std::memory_order_relaxed);
             }
             encode_queue_.push_back(frame);
-            localize_queue_.push_back(frame);
+            encode_queue_high_water_ = std::max(encode_queue_high_water_, encode_queue_.size());
+            // 未启动定位线程时不入队，否则队列常满、丢弃计数失去意义
+            if (localize_enabled_) {
+                if (localize_queue_.size() >= max_queue_size_) {
+                    localize_queue_.pop_front();
+                    localize_queue_drops_.fetch_add(1, std::memory_order_relaxed);
+                }
+                localize_queue_.push_back(frame);
+                localize_queue_high_water_ = std::max(localize_queue_high_water_, localize_queue_.size());
+            }
         }
         queue_cv_.notify_all();
     }
@@ -398,14 +410,71 @@ void MicrophoneAdtsStreamer::run() {
 
 // 消费者：编码 ch0
 void MicrophoneAdtsStreamer::runEncode() {
-    const int frame_samples_per_ch = enc_.frameSamplesPerCh();
+    const int frame_samples_per_ch = enc_->frameSamplesPerCh();
     const int frame_samples_total_mono = frame_samples_per_ch * 1; // 单通道编码
 
-    std::vector<int16_t> mono_cache;
-    mono_cache.reserve(static_cast<size_t>(frame_samples_total_mono * 2));
+    // period 与编码帧长可以不同（如 480 vs AAC 1024 / Opus 320），整帧直接交给编码器，只暂存跨 period 的残片
+    FrameAccumulator mono_acc(static_cast<size_t>(frame_samples_total_mono));
+    std::vector<int16_t> beam_mono;
+    beam_mono.reserve(static_cast<size_t>(cap_.periodSize()));
 
     uint32_t seq = 0;
-    uint64_t pts = nowMs();
+    const uint64_t pts_base = nowMs();
+    uint64_t frames_encoded = 0;
+
+    // 本地编码队列溢出与发布侧丢弃一样计为拥塞
+    std::unique_ptr<AdaptiveBitrateController> abr;
+    if (cfg_.adaptive_bitrate && backlog_cb_) {
+        AdaptiveBitrateParams p{};
+        p.min_bps = cfg_.min_bit_rate;
+        p.max_bps = cfg_.bit_rate;
+        abr = std::make_unique<AdaptiveBitrateController>(p, cfg_.bit_rate);
+        std::cout << "[MicrophoneAdtsStreamer] Adaptive bitrate: " << p.min_bps << ".." << p.max_bps
+                  << " bps" << std::endl;
+    }
+    auto adaptBitrate = [&]() {
+        PublishBacklog b = backlog_cb_();
+        b.dropped += encode_queue_drops_.load(std::memory_order_relaxed);
+        uint32_t bps = 0;
+        if (!abr->update(nowMs(), b, bps) || !enc_->setBitrate(static_cast<int>(bps))) return;
+        std::cout << "[MicrophoneAdtsStreamer] Bitrate " << bit_rate_.load() << " -> " << bps
+                  << " bps (in_flight=" << b.in_flight << ", dropped=" << b.dropped << ")" << std::endl;
+        bit_rate_.store(bps);
+        if (ctrl_cb_) {
+            AdtsStreamControl c{};
+            c.is_start = true;
+            c.sample_rate = cfg_.sample_rate;
+            c.channels = 1;
+            c.bit_rate = bps;
+            c.aot = cfg_.aot;
+            c.codec = cfg_.codec;
+            ctrl_cb_(c);
+        }
+    };
+
+    auto encodeFrame = [&](const int16_t* pcm) -> bool {
+        ByteSlice packet;
+        const auto t0 = std::chrono::steady_clock::now();
+        if (!enc_->encode(pcm, static_cast<size_t>(frame_samples_total_mono), packet)) {
+            return false;
+        }
+        encode_timing_.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count()));
+        // 按累计样本数计算 pts，避免逐帧取整造成漂移（如 48k 下 21.33ms/帧）
+        const uint64_t pts = pts_base + frames_encoded * static_cast<uint64_t>(frame_samples_per_ch) * 1000ULL
+                                        / cfg_.sample_rate;
+        ++frames_encoded;
+        if (!packet.empty() && data_cb_) {
+            AdtsStreamData d{};
+            d.seq = seq++;
+            d.pts_ms = pts;
+            d.frame_count = 1;
+            d.payload = std::move(packet);
+            data_cb_(d);
+        }
+        if (abr) adaptBitrate();
+        return true;
+    };
 
     while (running_.load()) {
         FramePtr frame;
@@ -417,35 +486,36 @@ void MicrophoneAdtsStreamer::runEncode() {
             encode_queue_.pop_front();
         }
         if (!frame || frame->empty()) continue;
-        const size_t frames = static_cast<size_t>(cap_.periodSize());
 
-        const std::vector<int16_t>& ch0 = (*frame)[0];
-        mono_cache.insert(mono_cache.end(), ch0.begin(), ch0.end());
-
-        while (mono_cache.size() >= static_cast<size_t>(frame_samples_total_mono)) {
-            std::vector<uint8_t> adts;
-            const bool ok = enc_.encode(mono_cache.data(), frame_samples_total_mono, adts);
-            if (!ok) {
-                running_.store(false);
-                break;
-            }
-            mono_cache.erase(mono_cache.begin(), mono_cache.begin() + frame_samples_total_mono);
-
-            if (!adts.empty() && data_cb_) {
-                AdtsStreamData d{};
-                d.seq = seq++;
-                d.pts_ms = pts;
-                d.frame_count = 1;
-                d.payload = std::move(adts);
-                data_cb_(d);
+        // period 边界：接管热更新重建的波束形成器（构建已在重载线程完成）
+        std::shared_ptr<BeamformerSlot> next_beam =
+            std::atomic_exchange(&pending_beamformer_, std::shared_ptr<BeamformerSlot>());
+        if (next_beam) beamformer_ = std::move(next_beam->beamformer);
+
+        const std::vector<int16_t>* mono = &(*frame)[0];
+        if (beamformer_ && frame->size() >= 4) {
+            if (steer_valid_.load(std::memory_order_relaxed)) {
+                const uint64_t packed = steer_dir_.load(std::memory_order_relaxed);
+                float az = 0.0f, el = 0.0f;
+                const uint32_t az_bits = static_cast<uint32_t>(packed >> 32);
+                const uint32_t el_bits = static_cast<uint32_t>(packed);
+                std::memcpy(&az, &az_bits, sizeof(az));
+                std::memcpy(&el, &el_bits, sizeof(el));
+                beamformer_->steer(az, el);
             }
-            pts += static_cast<uint64_t>(1000.0 * frame_samples_per_ch / static_cast<double>(cfg_.sample_rate));
+            beamformer_->process(*frame, (*frame)[0].size(), beam_mono);
+            mono = &beam_mono;
+        }
+        if (!mono_acc.push(mono->data(), mono->size(), encodeFrame)) {
+            running_.store(false);
+            break;
         }
     }
 }
 
 // 消费者：声源定位
 void MicrophoneAdtsStreamer::runLocalize() {
+    std::vector<TdoaEstimate> hop_results;
     while (running_.load()) {
         FramePtr frame;
         {
@@ -456,9 +526,23 @@ void MicrophoneAdtsStreamer::runLocalize() {
             localize_queue_.pop_front();
         }
        // std::cout << "[MicrophoneAdtsStreamer] Localize thread processing frame." << std::endl;
-        if (!frame || frame->size() < 4 || !localizer_ || !loc_cb_) {
+        // period 边界：接管热更新的新实例（只交换指针，构建已在其他线程完成）
+        std::shared_ptr<LocalizationState> next = std::atomic_exchange(&pending_loc_, std::shared_ptr<LocalizationState>());
+        if (next) adoptLocalization(std::move(next));
+
+        if (!frame || frame->size() < 4 || !loc_ || !loc_cb_) {
             continue;
         }
+        // 覆盖本 period 的全部定位工作（含跟踪与回调），析构时记录
+        struct ScopedTiming {
+            StageTiming& timing;
+            std::chrono::steady_clock::time_point t0{std::chrono::steady_clock::now()};
+            ~ScopedTiming() {
+                timing.record(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - t0).count()));
+            }
+        } scoped_timing{localize_timing_};
+        LocalizationState& st = *loc_;
         //std::cout << "[MicrophoneAdtsStreamer] Localize thread got valid frame." << std::endl;
         const size_t frames = static_cast<size_t>(cap_.periodSize());
 
@@ -471,33 +555,243 @@ void MicrophoneAdtsStreamer::runLocalize() {
             }
         }
 
+        // 响度按整个 period 计算，同一 period 内的多个 hop 结果共用
+        double db_ch[4] = {0,0,0,0};
+        st.localizer->calc4chSeparateDb(ch_float, db_ch);
+        // ok=false 表示本次无有效观测：跟踪器仍按 dt 推进（用于轨迹超时），但不发布
+        auto emit = [&](bool ok, float azimuth_deg, float elevation_deg, float confidence, float dt) {
+            sound_localization_result m{};
+            m.azimuth = azimuth_deg;
+            m.elevation = elevation_deg;
+            m.confidence = confidence;
+            for (int c = 0; c < 4; ++c) {
+                m.loudness[c] = static_cast<float>(db_ch[c]);
+            }
+            if (st.tracker) {
+                const SourceMeasurement meas{azimuth_deg, elevation_deg, confidence};
+                const bool observed = ok && confidence >= st.cfg.min_confidence;
+                st.tracker->step(dt, &meas, observed ? 1 : 0);
+                m.num_sources = static_cast<uint8_t>(st.tracker->activeSources(m.sources));
+                if (m.num_sources > 0) {
+                    // 主结果取最强轨迹
+                    m.azimuth = m.sources[0].azimuth;
+                    m.elevation = m.sources[0].elevation;
+                }
+            }
+            if (ok && st.cfg.beamforming_enabled && confidence >= st.cfg.min_confidence) {
+                uint32_t az_bits = 0, el_bits = 0;
+                std::memcpy(&az_bits, &m.azimuth, sizeof(az_bits));
+                std::memcpy(&el_bits, &m.elevation, sizeof(el_bits));
+                steer_dir_.store((static_cast<uint64_t>(az_bits) << 32) | el_bits, std::memory_order_relaxed);
+                steer_valid_.store(true, std::memory_order_relaxed);
+            }
+            if (ok) loc_cb_(m);
+        };
+
+        if (st.window_analyzer) {
+            // 滑动窗口：一个 period 可能产生 0..N 个 hop 结果
+            st.window_analyzer->process(ch_float, static_cast<uint32_t>(frames), hop_results);
+            const float hop_dt = static_cast<float>(st.window_analyzer->hopSize())
+                                 / static_cast<float>(mic_cfg_.sample_rate);
+            for (const TdoaEstimate& est : hop_results) {
+                float azimuth_deg = 0.0f;
+                float elevation_deg = 0.0f;
+                // 静音或低于 min_confidence 的 hop 不求方向（不污染平滑状态），跟踪器按无观测推进
+                const bool ok = est.valid &&
+                                st.localizer->resolveDirection(est.tdoa, azimuth_deg, elevation_deg);
+                emit(ok, azimuth_deg, elevation_deg, est.confidence, hop_dt);
+            }
+            continue;
+        }
+
         float azimuth_deg = 0.0f;
         float elevation_deg = 0.0f;
         float confidence = 0.0f;
         //std::cout << "[MicrophoneAdtsStreamer] ch_float: " << ch_float[0][10] << std::endl;
-        const bool ok_loc = localizer_->localize(ch_float, static_cast<uint32_t>(frames), azimuth_deg, elevation_deg, confidence);
+        const bool ok_loc = st.localizer->localize(ch_float, static_cast<uint32_t>(frames), azimuth_deg, elevation_deg, confidence);
         //std::cout << "[MicrophoneAdtsStreamer] Localization computation done. Success: " << (ok_loc ? "Yes" : "No") << std::endl;
-        if (ok_loc) {
-            double db_ch[4] = {0,0,0,0};
-            localizer_->calc4chSeparateDb(ch_float, db_ch);
-            float loudness[4] = {
-                static_cast<float>(db_ch[0]),
-                static_cast<float>(db_ch[1]),
-                static_cast<float>(db_ch[2]),
-                static_cast<float>(db_ch[3])
-            };
+        emit(ok_loc, azimuth_deg, elevation_deg, confidence,
+             static_cast<float>(frames) / static_cast<float>(mic_cfg_.sample_rate));
+    }
+}
 
-            sound_localization_result m{};
-            m.azimuth = azimuth_deg;
-            m.elevation = elevation_deg;
-            m.confidence = confidence;
-            m.loudness[0] = loudness[0];
-            m.loudness[1] = loudness[1];
-            m.loudness[2] = loudness[2];
-            m.loudness[3] = loudness[3];
-            loc_cb_(m);
+// -------- 定位配置热更新 --------
+std::shared_ptr<MicrophoneAdtsStreamer::LocalizationState>
+MicrophoneAdtsStreamer::buildLocalization(MicArrayConfig cfg) {
+    auto st = std::make_shared<LocalizationState>();
+    if (cfg.tracking_enabled) {
+        // 跟踪器自带时间模型，关闭 EMA 以免两个声源被平均
+        cfg.smoothing_enabled = false;
+        st->tracker = std::make_unique<SourceTracker>(cfg);
+        std::cout << "[MicrophoneAdtsStreamer] Multi-source tracking enabled, max_tracks="
+                  << cfg.max_tracks << std::endl;
+    }
+    if (cfg.parallel_workers > 0) {
+        // 每帧最多 4 路 FFT / 3 对互相关，调用线程也参与，超过 3 个后台线程没有收益
+        st->pool = std::make_unique<WorkerPool>(std::min<uint32_t>(cfg.parallel_workers, 3));
+        std::cout << "[MicrophoneAdtsStreamer] Localization worker pool: "
+                  << st->pool->workers() << " threads" << std::endl;
+    }
+    // 构造时预计算最大延迟与最小二乘伪逆
+    st->localizer = std::make_unique<MicArrayLocalizer>(cfg);
+    st->localizer->setWorkerPool(st->pool.get());
+    if (cfg.sliding_window_enabled) {
+        const int32_t max_delay = std::min<int32_t>(cfg.max_delay_samples,
+                                                    st->localizer->maxTheoreticalDelay());
+        st->window_analyzer = std::make_unique<SlidingWindowAnalyzer>(cfg, max_delay);
+        st->window_analyzer->setWorkerPool(st->pool.get());
+        std::cout << "[MicrophoneAdtsStreamer] Sliding window: win=" << st->window_analyzer->windowSize()
+                  << ", hop=" << st->window_analyzer->hopSize()
+                  << ", accumulate=" << cfg.accumulate_hops << std::endl;
+    }
+    st->cfg = cfg;
+    return st;
+}
+
+bool MicrophoneAdtsStreamer::applyLocalizationConfig(MicArrayConfig cfg) {
+    if (!running_.load() || !cfg_.enable_localization) return false;
+
+    // 采集参数在 PCM 打开时已确定，热更新只能沿用
+    if (cfg.sample_rate != mic_cfg_.sample_rate || cfg.frame_size != mic_cfg_.frame_size ||
+        cfg.channels != mic_cfg_.channels || cfg.audio_gain != mic_cfg_.audio_gain) {
+        std::cerr << "[MicrophoneAdtsStreamer] audio.sample_rate/frame_size/channels/gain require a restart,"
+                     " keeping the running values" << std::endl;
+        cfg.sample_rate = mic_cfg_.sample_rate;
+        cfg.frame_size = mic_cfg_.frame_size;
+        cfg.channels = mic_cfg_.channels;
+        cfg.audio_gain = mic_cfg_.audio_gain;
+    }
+
+    std::shared_ptr<LocalizationState> next = buildLocalization(cfg);
+    // 若定位线程尚未接管上一次更新，直接覆盖（旧的待定实例在此线程释放）
+    std::atomic_store(&pending_loc_, std::move(next));
+
+    if (!sameBeamformer(beam_cfg_, cfg)) {
+        auto slot = std::make_shared<BeamformerSlot>();
+        slot->beamformer = buildBeamformer(cfg);
+        if (!slot->beamformer) {
+            std::cout << "[MicrophoneAdtsStreamer] Beamformed mono encode disabled, encoding ch0" << std::endl;
         }
+        std::atomic_store(&pending_beamformer_, std::move(slot));
+        beam_cfg_ = cfg;
+    }
+    std::cout << "[MicrophoneAdtsStreamer] Localization config staged for hot swap" << std::endl;
+    return true;
+}
+
+bool MicrophoneAdtsStreamer::reloadLocalizationConfig(const std::string& yaml_text) {
+    std::lock_guard<std::mutex> lk(reload_mtx_);
+    MicArrayConfig cfg;
+    if (!MicArrayLocalizer::parseConfig(yaml_text, cfg)) return false;
+    return applyLocalizationConfig(cfg);
+}
+
+bool MicrophoneAdtsStreamer::reloadLocalizationConfigFile() {
+    std::lock_guard<std::mutex> lk(reload_mtx_);
+    MicArrayConfig cfg;
+    if (!MicArrayLocalizer::tryLoadConfig(cfg_.localization_config_path, cfg)) return false;
+    return applyLocalizationConfig(cfg);
+}
+
+std::unique_ptr<DelayAndSumBeamformer> MicrophoneAdtsStreamer::buildBeamformer(const MicArrayConfig& cfg) {
+    if (!cfg.beamforming_enabled || cfg.channels < 4) return nullptr;
+    std::cout << "[MicrophoneAdtsStreamer] Beamformed mono encode enabled, taps="
+              << cfg.beamforming_taps << std::endl;
+    return std::make_unique<DelayAndSumBeamformer>(cfg, cfg.frame_size, cfg.beamforming_taps);
+}
+
+bool MicrophoneAdtsStreamer::sameBeamformer(const MicArrayConfig& a, const MicArrayConfig& b) {
+    const bool on_a = a.beamforming_enabled && a.channels >= 4;
+    const bool on_b = b.beamforming_enabled && b.channels >= 4;
+    if (on_a != on_b) return false;
+    if (!on_a) return true;
+    if (a.beamforming_taps != b.beamforming_taps || a.sound_speed != b.sound_speed ||
+        a.sample_rate != b.sample_rate || a.frame_size != b.frame_size) {
+        return false;
+    }
+    for (size_t i = 0; i < a.mic_positions.size(); ++i) {
+        const Vec3& p = a.mic_positions[i];
+        const Vec3& q = b.mic_positions[i];
+        if (p.x != q.x || p.y != q.y || p.z != q.z) return false;
+    }
+    return true;
+}
+
+void MicrophoneAdtsStreamer::adoptLocalization(std::shared_ptr<LocalizationState> next) {
+    if (loc_) {
+        const MicArrayConfig& a = loc_->cfg;
+        const MicArrayConfig& b = next->cfg;
+        // 方向 EMA 状态继承，避免切换瞬间跳变
+        next->localizer->inheritState(*loc_->localizer);
+        // 几何或波束参数变化时，旧配置下求得的指向作废，等新配置的定位结果再指向
+        if (!sameBeamformer(a, b)) steer_valid_.store(false, std::memory_order_relaxed);
+        // 窗口参数与延迟范围不变时保留已累积的互功率谱历史
+        if (loc_->window_analyzer && next->window_analyzer &&
+            a.window_size == b.window_size && a.hop_size == b.hop_size &&
+            a.accumulate_hops == b.accumulate_hops &&
+            a.max_delay_samples == b.max_delay_samples &&
+            loc_->localizer->maxTheoreticalDelay() == next->localizer->maxTheoreticalDelay()) {
+            next->window_analyzer = std::move(loc_->window_analyzer);
+            next->window_analyzer->setWorkerPool(next->pool.get());
+            next->window_analyzer->setMinConfidence(b.min_confidence);
+        }
+        // 跟踪参数不变时保留现有轨迹
+        if (loc_->tracker && next->tracker &&
+            a.max_tracks == b.max_tracks && a.gate_deg == b.gate_deg &&
+            a.birth_hits == b.birth_hits && a.track_timeout_s == b.track_timeout_s &&
+            a.process_noise == b.process_noise &&
+            a.measurement_noise_deg == b.measurement_noise_deg &&
+            a.min_confidence == b.min_confidence) {
+            next->tracker = std::move(loc_->tracker);
+        }
+    }
+    loc_ = std::move(next);
+    std::cout << "[MicrophoneAdtsStreamer] Localization config applied: array=" << loc_->cfg.array_type
+              << ", min_conf=" << loc_->cfg.min_confidence
+              << ", alpha=" << loc_->cfg.smoothing_alpha << std::endl;
+}
+
+void MicrophoneAdtsStreamer::runConfigWatch() {
+    const std::string& path = cfg_.localization_config_path;
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash == 0 ? 1 : slash);
+    const std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        std::perror("[MicrophoneAdtsStreamer] inotify_init1");
+        return;
+    }
+    // 监听目录而非文件：编辑器常以"写临时文件再 rename"的方式保存
+    if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::perror("[MicrophoneAdtsStreamer] inotify_add_watch");
+        ::close(fd);
+        return;
+    }
+
+    alignas(struct inotify_event) char buf[4096];
+    while (running_.load()) {
+        struct pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 200) <= 0) continue;
+
+        bool changed = false;
+        ssize_t len;
+        while ((len = ::read(fd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + len; ) {
+                const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+                if (ev->len > 0 && name == ev->name) changed = true;
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+        if (!changed) continue;
+
+        // 合并短时间内的连续写入
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        while (::read(fd, buf, sizeof(buf)) > 0) {}
+        std::cout << "[MicrophoneAdtsStreamer] Localization config changed: " << path << std::endl;
+        reloadLocalizationConfigFile();
     }
+    ::close(fd);
 }
 
 } // namespace MicrophoneModule
@@ -0,0 +1,98 @@
+#include "fft_radix2.hpp"
+
+#include <cmath>
+#include <utility>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+RealFft::RealFft(uint32_t n)
+    : n_(isPowerOfTwo(n) ? n : 1024)
+    , half_(n_ / 2) {
+    bitrev_.resize(half_);
+    uint32_t bits = 0;
+    while ((1u << bits) < half_) ++bits;
+    for (uint32_t i = 0; i < half_; ++i) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; ++b) {
+            if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+
+    twiddle_.resize(half_ / 2);
+    for (uint32_t k = 0; k < half_ / 2; ++k) {
+        const double a = -2.0 * M_PI * k / half_;
+        twiddle_[k] = std::complex<float>(static_cast<float>(std::cos(a)), static_cast<float>(std::sin(a)));
+    }
+
+    post_twiddle_.resize(half_ + 1);
+    for (uint32_t k = 0; k <= half_; ++k) {
+        const double a = -2.0 * M_PI * k / n_;
+        post_twiddle_[k] = std::complex<float>(static_cast<float>(std::cos(a)), static_cast<float>(std::sin(a)));
+    }
+
+    work_.resize(half_);
+}
+
+void RealFft::complexFft(std::complex<float>* data) const {
+    for (uint32_t i = 0; i < half_; ++i) {
+        const uint32_t j = bitrev_[i];
+        if (j > i) std::swap(data[i], data[j]);
+    }
+    for (uint32_t len = 2; len <= half_; len <<= 1) {
+        const uint32_t step = half_ / len;
+        const uint32_t hl = len / 2;
+        for (uint32_t i = 0; i < half_; i += len) {
+            for (uint32_t k = 0; k < hl; ++k) {
+                const std::complex<float> t = data[i + k + hl] * twiddle_[k * step];
+                const std::complex<float> u = data[i + k];
+                data[i + k] = u + t;
+                data[i + k + hl] = u - t;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* in, std::complex<float>* out) {
+    // 偶/奇样本打包为复数序列
+    for (uint32_t i = 0; i < half_; ++i) {
+        work_[i] = std::complex<float>(in[2 * i], in[2 * i + 1]);
+    }
+    complexFft(work_.data());
+
+    // 拆分：X[k] = E[k] + W^k * O[k]
+    for (uint32_t k = 0; k <= half_; ++k) {
+        const std::complex<float> zk = work_[k % half_];
+        const std::complex<float> zc = std::conj(work_[(half_ - k) % half_]);
+        const std::complex<float> e = (zk + zc) * 0.5f;
+        const std::complex<float> o = (zk - zc) * std::complex<float>(0.0f, -0.5f);
+        out[k] = e + post_twiddle_[k] * o;
+    }
+}
+
+void RealFft::inverse(const std::complex<float>* in, float* out) {
+    // 逆向合成：Z[k] = E[k] + i*O[k]
+    for (uint32_t k = 0; k < half_; ++k) {
+        const std::complex<float> xk = in[k];
+        const std::complex<float> xc = std::conj(in[half_ - k]);
+        const std::complex<float> e = (xk + xc) * 0.5f;
+        const std::complex<float> o = (xk - xc) * 0.5f * std::conj(post_twiddle_[k]);
+        // 逆变换借助共轭：ifft(Z) = conj(fft(conj(Z))) / m
+        work_[k] = std::conj(e + std::complex<float>(0.0f, 1.0f) * o);
+    }
+    complexFft(work_.data());
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (uint32_t i = 0; i < half_; ++i) {
+        const std::complex<float> z = std::conj(work_[i]) * scale;
+        out[2 * i] = z.real();
+        out[2 * i + 1] = z.imag();
+    }
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
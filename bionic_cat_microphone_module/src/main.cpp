@@ -24,13 +24,15 @@ int main(int argc, char* argv[]) {
 
     int CARD = 1;
     int DEVICE = 0;
-    // 简单参数解析：支持 -d <card> / --card=<n> 和 -D <device> / --device=<n>
+    bool ADAPTIVE_BITRATE = false;
+    // 简单参数解析：支持 -d <card> / --card=<n>、-D <device> / --device=<n> 和 -a / --adaptive-bitrate
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         if (a == "-h" || a == "--help") {
-            std::cout << "Usage: " << argv[0] << " [-d <card>] [-D <device>]\n"
+            std::cout << "Usage: " << argv[0] << " [-d <card>] [-D <device>] [-a]\n"
                       << "  -d, --card   serial device (default:0)\n"
-                      << "  -D, --device     baud rate (default: 0)\n";
+                      << "  -D, --device     baud rate (default: 0)\n"
+                      << "  -a, --adaptive-bitrate   lower the bitrate when publishing backs up (default: off)\n";
             return 0;
         } else if (a == "-d" && i + 1 < argc) {
             CARD = std::stoi(argv[++i]);
@@ -40,11 +42,14 @@ int main(int argc, char* argv[]) {
             DEVICE = std::stoi(argv[++i]);
         } else if (a.rfind("--device=", 0) == 0) {
             DEVICE = std::stoi(a.substr(std::string("--device=").size()));
+        } else if (a == "-a" || a == "--adaptive-bitrate") {
+            ADAPTIVE_BITRATE = true;
         }
     }
 
     g_node = std::make_unique<BionicCat::MicrophoneModule::MicrophoneNode>(
         SERVER_ADDRESS, CLIENT_ID , PUBLISH_TOPIC, SUBSCRIBE_TOPIC, QOS, CARD, DEVICE, "A");
+    g_node->setAdaptiveBitrate(ADAPTIVE_BITRATE);
 
     if (!g_node->init()) {
         std::cerr << "[MicrophoneMain] init failed" << std::endl;
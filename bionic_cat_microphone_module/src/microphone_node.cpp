@@ -1,6 +1,8 @@
 #include "microphone_node.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 
 #include "mqtt_utils.hpp"
@@ -10,6 +12,7 @@ namespace MicrophoneModule {
 using BionicCat::MqttMsgs::AdtsStreamControlMsg;
 using BionicCat::MqttMsgs::AdtsStreamDataMsg;
 using BionicCat::MqttMsgs::Header;
+using BionicCat::MqttMsgs::LocalizationConfigMsg;
 using BionicCat::MqttMsgs::SoundLocalizationMsg;
 
 MicrophoneNode::MicrophoneNode(const std::string& server_address,
@@ -57,6 +60,10 @@ bool MicrophoneNode::init() {
         std::cerr << "[MicrophoneNode] Failed to subscribe control topic: " << subscribe_topic_control_ << std::endl;
         return false;
     }
+    if (!subscriber_->subscribe(subscribe_topic_loc_config_)) {
+        std::cerr << "[MicrophoneNode] Failed to subscribe config topic: " << subscribe_topic_loc_config_ << std::endl;
+        return false;
+    }
 
     running_.store(true);
 
@@ -68,11 +75,51 @@ bool MicrophoneNode::init() {
 
 void MicrophoneNode::run() {
     std::cout << "[MicrophoneNode] Running" << std::endl;
+    auto last_stats = std::chrono::steady_clock::now();
     while (running_.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_stats >= std::chrono::milliseconds(kStatsIntervalMs)) {
+            last_stats = now;
+            publishStreamStats();
+        }
     }
 }
 
+void MicrophoneNode::publishStreamStats() {
+    BionicCat::MqttMsgs::MicrophoneStreamStatsMsg m{};
+    {
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        if (!streamer_) return;
+        const StreamerStats st = streamer_->stats(/*reset_window*/true);
+        m.window_ms = st.window_ms;
+        m.periods_captured = st.periods_captured;
+        m.capture_xruns = st.capture_xruns;
+        m.queue_capacity = st.queue_capacity;
+        m.encode_queue_drops = st.encode_queue_drops;
+        m.localize_queue_drops = st.localize_queue_drops;
+        m.encode_queue_high_water = st.encode_queue_high_water;
+        m.localize_queue_high_water = st.localize_queue_high_water;
+        m.frames_encoded = st.frames_encoded;
+        m.encode_us_avg = st.encode_us_avg;
+        m.encode_us_max = st.encode_us_max;
+        m.periods_localized = st.periods_localized;
+        m.localize_us_avg = st.localize_us_avg;
+        m.localize_us_max = st.localize_us_max;
+        m.period_us = st.period_us;
+        m.bit_rate = st.bit_rate;
+        m.input_dbfs = st.input_dbfs;
+    }
+    m.header.frame_id = "microphone";
+    m.header.device_id = device_id_;
+    m.header.timestamp = getStamp();
+    m.publish_in_flight = static_cast<uint32_t>(publisher_->inFlight());
+    m.publish_dropped = data_dropped_.load(std::memory_order_relaxed);
+    auto bin = BionicCat::MsgsSerializer::Serializer::serializeMicrophoneStreamStats(m);
+    // 经定位发布连接发送，不计入数据连接的在途数（自适应码率依据）
+    sound_publisher_->publish(publish_topic_stream_stats_, bin.data(), bin.size(), qos_, false);
+}
+
 void MicrophoneNode::stop() {
     running_.store(false);
 
@@ -91,6 +138,10 @@ void MicrophoneNode::stop() {
 }
 
 void MicrophoneNode::handleControl(mqtt::const_message_ptr msg) {
+    if (msg->get_topic() == subscribe_topic_loc_config_) {
+        handleLocalizationConfig(msg);
+        return;
+    }
     try {
         const auto& payload = msg->get_payload();
         auto ctrl = BionicCat::MsgsSerializer::Serializer::deserializeAdtsStreamControl(
@@ -102,7 +153,8 @@ void MicrophoneNode::handleControl(mqtt::const_message_ptr msg) {
         //           << ", br=" << ctrl.bit_rate
         //           << ", aot=" << int(ctrl.aot) << std::endl;
         // enqueue control command
-        ControlCmd cmd{ctrl.is_start, ctrl.sample_rate, ctrl.channels, ctrl.bit_rate, ctrl.aot};
+        ControlCmd cmd{ctrl.is_start, ctrl.sample_rate, ctrl.channels, ctrl.bit_rate, ctrl.aot,
+                       static_cast<AudioCodecType>(ctrl.codec)};
         {
             std::lock_guard<std::mutex> lk(control_mtx_);
             control_queue_.push(cmd);
@@ -113,6 +165,25 @@ void MicrophoneNode::handleControl(mqtt::const_message_ptr msg) {
     }
 }
 
+void MicrophoneNode::handleLocalizationConfig(mqtt::const_message_ptr msg) {
+    try {
+        const auto& payload = msg->get_payload();
+        LocalizationConfigMsg cfg = BionicCat::MsgsSerializer::Serializer::deserializeLocalizationConfig(
+            reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+        // 解析与预计算在 MQTT 回调线程完成，定位线程只做指针交换
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        if (!streamer_) {
+            std::cout << "[MicrophoneNode] Stream not running, ignoring localization config" << std::endl;
+            return;
+        }
+        if (!streamer_->reloadLocalizationConfig(cfg.yaml_text)) {
+            std::cerr << "[MicrophoneNode] Localization config rejected" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[MicrophoneNode] localization config parse error: " << e.what() << std::endl;
+    }
+}
+
 void MicrophoneNode::controlLoop() {
     while (running_.load()) {
         ControlCmd cmd;
@@ -126,7 +197,7 @@ void MicrophoneNode::controlLoop() {
 
         if (cmd.start) {
             std::cout << "[MicrophoneNode] Received START command" << std::endl;
-            startStream(cmd.sr, cmd.ch, cmd.br, cmd.aot);
+            startStream(cmd.sr, cmd.ch, cmd.br, cmd.aot, cmd.codec);
         } else {
             std::cout << "[MicrophoneNode] Received STOP command" << std::endl;
             stopStream();
@@ -136,7 +207,8 @@ void MicrophoneNode::controlLoop() {
     }
 }
 
-void MicrophoneNode::startStream(uint32_t sample_rate, uint8_t channels, uint32_t bitrate, uint8_t aot) {
+void MicrophoneNode::startStream(uint32_t sample_rate, uint8_t channels, uint32_t bitrate, uint8_t aot,
+                                 AudioCodecType codec) {
     std::lock_guard<std::mutex> lk(stream_mtx_);
     if (streamer_) {
         // already running, ignore duplicate start
@@ -155,9 +227,34 @@ void MicrophoneNode::startStream(uint32_t sample_rate, uint8_t channels, uint32_
         m.seq = d.seq;
         m.pts_ms = d.pts_ms;
         m.frame_count = d.frame_count;
-        m.payload = d.payload;
-        auto bin = BionicCat::MsgsSerializer::Serializer::serializeAdtsStreamData(m);
-        publisher_->publish(publish_topic_data_, std::string(reinterpret_cast<const char*>(bin.data()), bin.size()), qos_, false);
+        // 消息前缀原地写入 ADTS 缓冲的 headroom，payload 从编码器输出到 MQTT 不再复制
+        data_prefix_buf_.clear();
+        BionicCat::MsgsSerializer::Serializer::serializeAdtsStreamDataPrefix(
+            data_prefix_buf_, m, static_cast<uint32_t>(d.payload.size()));
+        // 异步发布，不在编码线程等待 broker 确认；在途过多说明链路拥塞，丢弃本包（开启自适应码率时随后下调）
+        if (publisher_->inFlight() >= kMaxDataInFlight) {
+            data_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ByteSlice slice = d.payload;
+        bool queued = false;
+        if (slice.block && data_prefix_buf_.size() <= slice.headroom()) {
+            std::memcpy(slice.prepend(data_prefix_buf_.size()), data_prefix_buf_.data(), data_prefix_buf_.size());
+            queued = publisher_->publishAsyncTracked(publish_topic_data_, slice.data(), slice.size(), qos_, false);
+        } else {
+            // headroom 不足（如 device_id 过长）时退回拼接
+            data_prefix_buf_.insert(data_prefix_buf_.end(), d.payload.data(), d.payload.data() + d.payload.size());
+            queued = publisher_->publishAsyncTracked(publish_topic_data_, data_prefix_buf_.data(),
+                                                     data_prefix_buf_.size(), qos_, false);
+        }
+        if (!queued) data_dropped_.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    streamer_->onBacklogProbe([this]() {
+        PublishBacklog b{};
+        b.in_flight = publisher_->inFlight();
+        b.dropped = data_dropped_.load(std::memory_order_relaxed);
+        return b;
     });
 
     // 新增：声源定位回调，直接发布
@@ -165,13 +262,26 @@ void MicrophoneNode::startStream(uint32_t sample_rate, uint8_t channels, uint32_
         publishSoundLocalization(msg);
     });
 
-    // 控制回调（仅打印）
+    // 控制回调：开始/结束及码率变化，经数据发布连接发到状态主题，与数据包保持先后顺序
     streamer_->onControl([this](const AdtsStreamControl& c){
         std::cout << "[MicrophoneNode] stream " << (c.is_start?"start":"stop")
                   << ", sr=" << c.sample_rate
                   << ", ch=" << int(c.channels)
                   << ", br=" << c.bit_rate
-                  << ", aot=" << int(c.aot) << std::endl;
+                  << ", aot=" << int(c.aot)
+                  << ", codec=" << audioCodecName(c.codec) << std::endl;
+        AdtsStreamControlMsg m{};
+        m.header.frame_id = "microphone";
+        m.header.device_id = device_id_;
+        m.header.timestamp = getStamp();
+        m.is_start = c.is_start;
+        m.sample_rate = c.sample_rate;
+        m.channels = c.channels;
+        m.bit_rate = c.bit_rate;
+        m.aot = c.aot;
+        m.codec = static_cast<BionicCat::MqttMsgs::AudioCodec>(c.codec);
+        auto bin = BionicCat::MsgsSerializer::Serializer::serializeAdtsStreamControl(m);
+        publisher_->publishAsyncTracked(publish_topic_stream_status_, bin.data(), bin.size(), qos_, false);
     });
 
     MicrophoneAdtsStreamer::Config cfg;
@@ -181,6 +291,10 @@ void MicrophoneNode::startStream(uint32_t sample_rate, uint8_t channels, uint32_
     cfg.channels = channels;
     cfg.bit_rate = bitrate;
     cfg.aot = aot;
+    cfg.codec = codec;
+    cfg.adaptive_bitrate = adaptive_bitrate_.load();
+    cfg.min_bit_rate = std::min<uint32_t>(kMinAdaptiveBitrate, bitrate);
+    data_dropped_.store(0);
     // 开启定位由外部设置 publish_topic_sound_ 与 cfg.enable_localization 等，这里保留默认关闭
 
     if (!streamer_->start(cfg)) {
@@ -211,6 +325,18 @@ void MicrophoneNode::publishSoundLocalization(const sound_localization_result& m
     m.loudness[1] = msg.loudness[1];
     m.loudness[2] = msg.loudness[2];
     m.loudness[3] = msg.loudness[3];
+    m.sources.reserve(msg.num_sources);
+    for (uint8_t i = 0; i < msg.num_sources; ++i) {
+        const TrackedSource& t = msg.sources[i];
+        BionicCat::MqttMsgs::SoundSourceTrack src;
+        src.track_id = t.track_id;
+        src.azimuth_deg = t.azimuth;
+        src.elevation_deg = t.elevation;
+        src.azimuth_rate_dps = t.azimuth_rate;
+        src.confidence = t.confidence;
+        src.age_ms = t.age_ms;
+        m.sources.push_back(src);
+    }
     // std::cout << "[MicrophoneNode] Publishing sound localization: azimuth=" << m.azimuth_deg
     //           << ", elevation=" << m.elevation_deg
     //           << ", confidence=" << m.confidence
@@ -0,0 +1,42 @@
+#include "pooled_buffer.hpp"
+
+#include <atomic>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+BufferPool::BufferPool(size_t block_size, size_t initial_blocks, size_t max_blocks)
+    : block_size_(block_size)
+    , max_blocks_(max_blocks < initial_blocks ? initial_blocks : max_blocks) {
+    blocks_.reserve(max_blocks_);
+    for (size_t i = 0; i < initial_blocks; ++i) {
+        blocks_.push_back(std::make_shared<std::vector<uint8_t>>(block_size_));
+    }
+}
+
+ByteSlice BufferPool::acquire(size_t headroom) {
+    ByteSlice s;
+    s.offset = headroom < block_size_ ? headroom : block_size_;
+    s.length = 0;
+
+    const size_t n = blocks_.size();
+    for (size_t k = 0; k < n; ++k) {
+        const size_t i = (next_ + k) % n;
+        if (blocks_[i].use_count() == 1) {
+            // 与下游释放引用时的递减配对，确保其读操作已全部完成
+            std::atomic_thread_fence(std::memory_order_acquire);
+            next_ = (i + 1) % n;
+            s.block = blocks_[i];
+            return s;
+        }
+    }
+
+    // 全部在用（下游发布阻塞）：扩容，超过上限则给一个不入池的临时块
+    auto block = std::make_shared<std::vector<uint8_t>>(block_size_);
+    if (blocks_.size() < max_blocks_) blocks_.push_back(block);
+    s.block = std::move(block);
+    return s;
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -0,0 +1,193 @@
+#include "sliding_window_localizer.hpp"
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+SlidingWindowAnalyzer::SlidingWindowAnalyzer(const MicArrayConfig& config, int32_t max_delay_samples)
+    : window_size_(RealFft::isPowerOfTwo(config.window_size) ? config.window_size : 2048)
+    , hop_size_(std::max<uint32_t>(1, std::min(config.hop_size, window_size_)))
+    , accumulate_hops_(std::max<uint32_t>(1, config.accumulate_hops))
+    , max_delay_(std::max<int32_t>(1, std::min<int32_t>(max_delay_samples, static_cast<int32_t>(window_size_ / 2 - 2))))
+    , sample_rate_(config.sample_rate)
+    , min_confidence_(config.min_confidence) {
+    ffts_.reserve(4);
+    for (int c = 0; c < 4; ++c) ffts_.emplace_back(window_size_);
+    window_.resize(window_size_);
+    for (uint32_t i = 0; i < window_size_; ++i) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * i / window_size_);
+    }
+    for (auto& r : ring_) r.assign(window_size_, 0.0f);
+    for (auto& f : frame_) f.resize(window_size_);
+    const uint32_t bins = ffts_[0].bins();
+    for (auto& s : spec_) s.resize(bins);
+    history_.resize(accumulate_hops_);
+    for (auto& h : history_) {
+        for (auto& p : h) p.assign(bins, std::complex<float>(0.0f, 0.0f));
+    }
+    for (auto& a : accum_) a.resize(bins);
+    for (auto& c : corr_) c.resize(window_size_);
+}
+
+void SlidingWindowAnalyzer::reset() {
+    for (auto& r : ring_) std::fill(r.begin(), r.end(), 0.0f);
+    write_pos_ = 0;
+    filled_ = 0;
+    since_hop_ = 0;
+    history_pos_ = 0;
+    history_count_ = 0;
+}
+
+uint32_t SlidingWindowAnalyzer::process(const std::array<std::vector<float>, 4>& audio_data,
+                                        uint32_t num_samples,
+                                        std::vector<TdoaEstimate>& results) {
+    results.clear();
+    uint32_t offset = 0;
+    while (offset < num_samples) {
+        // 一次最多拷贝到下一个 hop 边界
+        const uint32_t n = std::min(num_samples - offset, hop_size_ - since_hop_);
+        for (int c = 0; c < 4; ++c) {
+            const float* src = audio_data[c].data() + offset;
+            std::vector<float>& ring = ring_[c];
+            uint32_t pos = write_pos_;
+            for (uint32_t i = 0; i < n; ++i) {
+                ring[pos] = src[i];
+                if (++pos == window_size_) pos = 0;
+            }
+        }
+        write_pos_ = (write_pos_ + n) % window_size_;
+        filled_ = std::min(filled_ + n, window_size_);
+        since_hop_ += n;
+        offset += n;
+
+        if (since_hop_ == hop_size_) {
+            since_hop_ = 0;
+            // 首个完整窗口到来前不输出
+            if (filled_ < window_size_) continue;
+            TdoaEstimate est;
+            analyzeHop(est);
+            results.push_back(est);
+        }
+    }
+    return static_cast<uint32_t>(results.size());
+}
+
+void SlidingWindowAnalyzer::transformChannel(uint32_t c) {
+    // 环形缓冲按时间顺序展开并加窗
+    const std::vector<float>& ring = ring_[c];
+    float* frame = frame_[c].data();
+    const uint32_t tail = window_size_ - write_pos_;
+    float energy = 0.0f;
+    for (uint32_t i = 0; i < tail; ++i) {
+        frame[i] = ring[write_pos_ + i] * window_[i];
+        energy += frame[i] * frame[i];
+    }
+    for (uint32_t i = 0; i < write_pos_; ++i) {
+        frame[tail + i] = ring[i] * window_[tail + i];
+        energy += frame[tail + i] * frame[tail + i];
+    }
+    energy_[c] = energy;
+    ffts_[c].forward(frame, spec_[c].data());
+}
+
+void SlidingWindowAnalyzer::correlatePair(uint32_t p, TdoaEstimate& est) {
+    const uint32_t bins = ffts_[p].bins();
+    std::complex<float>* accum = accum_[p].data();
+    std::fill(accum, accum + bins, std::complex<float>(0.0f, 0.0f));
+    for (uint32_t h = 0; h < history_count_; ++h) {
+        const std::complex<float>* src = history_[h][p].data();
+        for (uint32_t k = 0; k < bins; ++k) accum[k] += src[k];
+    }
+    // PHAT 加权：只保留相位
+    accum[0] = std::complex<float>(0.0f, 0.0f);
+    for (uint32_t k = 1; k < bins; ++k) {
+        const float mag = std::abs(accum[k]);
+        accum[k] = mag > 1e-12f ? accum[k] / mag : std::complex<float>(0.0f, 0.0f);
+    }
+    ffts_[p].inverse(accum, corr_[p].data());
+
+    int32_t best_delay = 0;
+    float frac = 0.0f;
+    const float peak = findPeak(corr_[p].data(), best_delay, frac);
+    // 与时域互相关保持一致：sig0[i] ≈ sigi[i - delay]，tdoa = -delay / fs
+    est.tdoa[p] = -(static_cast<float>(best_delay) + frac) / static_cast<float>(sample_rate_);
+    est.pair_confidence[p] = std::min(1.0f, std::max(0.0f, peak));
+}
+
+void SlidingWindowAnalyzer::analyzeHop(TdoaEstimate& est) {
+    // 每通道一次 FFT
+    auto channel = [this](uint32_t c) { transformChannel(c); };
+    if (pool_) {
+        pool_->parallelFor(4, channel);
+    } else {
+        for (uint32_t c = 0; c < 4; ++c) channel(c);
+    }
+    bool silent = false;
+    for (float e : energy_) {
+        if (e < 1e-10f) silent = true;
+    }
+
+    // 当前 hop 的互功率谱覆盖历史中最旧的一格
+    const uint32_t bins = ffts_[0].bins();
+    auto& slot = history_[history_pos_];
+    for (int p = 0; p < 3; ++p) {
+        const std::complex<float>* x0 = spec_[0].data();
+        const std::complex<float>* xi = spec_[p + 1].data();
+        std::complex<float>* dst = slot[p].data();
+        for (uint32_t k = 0; k < bins; ++k) {
+            dst[k] = x0[k] * std::conj(xi[k]);
+        }
+    }
+    history_pos_ = (history_pos_ + 1) % accumulate_hops_;
+    history_count_ = std::min(history_count_ + 1, accumulate_hops_);
+
+    if (silent) {
+        est.confidence = 0.0f;
+        return;
+    }
+
+    auto pair = [this, &est](uint32_t p) { correlatePair(p, est); };
+    if (pool_) {
+        pool_->parallelFor(3, pair);
+    } else {
+        for (uint32_t p = 0; p < 3; ++p) pair(p);
+    }
+    est.confidence = (est.pair_confidence[0] + est.pair_confidence[1] + est.pair_confidence[2]) / 3.0f;
+    // 与逐 period 路径同一门限：低置信度的 GCC-PHAT 峰多为噪声/混响，不作为观测
+    est.valid = est.confidence > 0.0f && est.confidence >= min_confidence_;
+}
+
+float SlidingWindowAnalyzer::findPeak(const float* corr, int32_t& best_delay, float& frac) const {
+    const int32_t n = static_cast<int32_t>(window_size_);
+    auto at = [&](int32_t d) { return corr[(d + n) % n]; };
+
+    float best = -1e30f;
+    best_delay = 0;
+    for (int32_t d = -max_delay_; d <= max_delay_; ++d) {
+        const float v = at(d);
+        if (v > best) {
+            best = v;
+            best_delay = d;
+        }
+    }
+
+    // 抛物线插值得到亚样本偏移
+    frac = 0.0f;
+    const float ym = at(best_delay - 1);
+    const float yp = at(best_delay + 1);
+    const float denom = ym - 2.0f * best + yp;
+    if (std::fabs(denom) > 1e-12f) {
+        frac = std::max(-0.5f, std::min(0.5f, 0.5f * (ym - yp) / denom));
+    }
+    return best;
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
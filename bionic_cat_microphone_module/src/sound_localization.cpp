@@ -1,4 +1,5 @@
 #include "sound_localization.hpp"
+#include "worker_pool.hpp"
 #include <cmath>
 #include <yaml-cpp/yaml.h>
 
@@ -90,35 +91,42 @@ MicArrayLocalizer::MicArrayLocalizer(const MicArrayConfig& config)
     }
     float max_delay_sec = max_dist / config_.sound_speed;
     max_theoretical_delay_ = static_cast<int>(max_delay_sec * config_.sample_rate) + 1;
+
+    precomputeSolver();
 }
 
 bool MicArrayLocalizer::localize(const std::array<std::vector<float>, 4>& audio_data,
                                  uint32_t num_samples,
                                  float& azimuth, float& elevation, float& confidence) {
     std::array<float, 3> tdoa{};
-    float total_correlation = 0.0f;
+    std::array<float, 3> corr{};
 
-    for (int i = 1; i < 4; ++i) {
+    // 三对互相关互相独立，有线程池时并行
+    auto pair = [&](uint32_t p) {
+        const int i = static_cast<int>(p) + 1;
         int32_t delay_samples = 0;
-        float corr = computeCrossCorrelation(
+        corr[p] = computeCrossCorrelation(
             audio_data[0].data(),
             audio_data[i].data(),
             num_samples,
             config_.max_delay_samples,
             delay_samples);
-        tdoa[i - 1] = -(float)delay_samples / config_.sample_rate;
-        total_correlation += corr;
+        tdoa[p] = -(float)delay_samples / config_.sample_rate;
+    };
+    if (pool_) {
+        pool_->parallelFor(3, pair);
+    } else {
+        for (uint32_t p = 0; p < 3; ++p) pair(p);
     }
-    confidence = total_correlation / 3.0f;
+    confidence = (corr[0] + corr[1] + corr[2]) / 3.0f;
+
+    return resolveDirection(tdoa, azimuth, elevation);
+}
 
+bool MicArrayLocalizer::resolveDirection(const std::array<float, 3>& tdoa,
+                                         float& azimuth, float& elevation) {
     Vec3 direction;
-    bool ok = false;
-    if (config_.is_planar) {
-        ok = solve2D(tdoa, direction);
-    } else {
-        ok = solve3D(tdoa, direction);
-    }
-    if (!ok) return false;
+    if (!solve(tdoa, direction)) return false;
 
     direction = direction.normalize();
 
@@ -139,56 +147,48 @@ bool MicArrayLocalizer::localize(const std::array<std::vector<float>, 4>& audio_
     return true;
 }
 
-bool MicArrayLocalizer::solve2D(const std::array<float, 3>& tdoa, Vec3& direction) {
-    float A[2][2] = {{0}};
-    float b[2] = {0};
-
+void MicArrayLocalizer::precomputeSolver() {
+    // 几何只在构造时确定，伪逆在此一次算好，热路径只剩 3x3 矩阵乘
+    Vec3 diff[3];
     for (int i = 1; i < 4; ++i) {
-        Vec3 diff = config_.mic_positions[i] - config_.mic_positions[0];
-        float rangeD = tdoa[i - 1] * config_.sound_speed;
-        A[0][0] += diff.x * diff.x;
-        A[0][1] += diff.x * diff.y;
-        A[1][0] += diff.y * diff.x;
-        A[1][1] += diff.y * diff.y;
-        b[0] += diff.x * rangeD;
-        b[1] += diff.y * rangeD;
+        diff[i - 1] = config_.mic_positions[i] - config_.mic_positions[0];
+    }
+    solvable_ = false;
+    for (auto& row : pinv_) {
+        for (float& v : row) v = 0.0f;
     }
 
-    float det = A[0][0] * A[1][1] - A[0][1] * A[1][0];
-    if (std::fabs(det) < 1e-10f) return false;
-    float invDet = 1.0f / det;
-
-    direction.x = (A[1][1] * b[0] - A[0][1] * b[1]) * invDet;
-    direction.y = (A[0][0] * b[1] - A[1][0] * b[0]) * invDet;
-    direction.z = 0.0f;
-    return true;
-}
+    if (config_.is_planar) {
+        float A[2][2] = {{0}};
+        for (const Vec3& d : diff) {
+            A[0][0] += d.x * d.x;
+            A[0][1] += d.x * d.y;
+            A[1][1] += d.y * d.y;
+        }
+        A[1][0] = A[0][1];
+        float det = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+        if (std::fabs(det) < 1e-10f) return;
+        float invDet = 1.0f / det;
+        for (int i = 0; i < 3; ++i) {
+            pinv_[0][i] = (A[1][1] * diff[i].x - A[0][1] * diff[i].y) * invDet;
+            pinv_[1][i] = (A[0][0] * diff[i].y - A[1][0] * diff[i].x) * invDet;
+        }
+        solvable_ = true;
+        return;
+    }
 
-bool MicArrayLocalizer::solve3D(const std::array<float, 3>& tdoa, Vec3& direction) {
     float A[3][3] = {{0}};
-    float b[3] = {0};
-
-    for (int i = 1; i < 4; ++i) {
-        Vec3 diff = config_.mic_positions[i] - config_.mic_positions[0];
-        float rangeD = tdoa[i - 1] * config_.sound_speed;
-        A[0][0] += diff.x * diff.x;
-        A[0][1] += diff.x * diff.y;
-        A[0][2] += diff.x * diff.z;
-        A[1][0] += diff.y * diff.x;
-        A[1][1] += diff.y * diff.y;
-        A[1][2] += diff.y * diff.z;
-        A[2][0] += diff.z * diff.x;
-        A[2][1] += diff.z * diff.y;
-        A[2][2] += diff.z * diff.z;
-        b[0] += diff.x * rangeD;
-        b[1] += diff.y * rangeD;
-        b[2] += diff.z * rangeD;
+    for (const Vec3& d : diff) {
+        const float v[3] = {d.x, d.y, d.z};
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) A[r][c] += v[r] * v[c];
+        }
     }
 
     float det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
               - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
               + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
-    if (std::fabs(det) < 1e-10f) return false;
+    if (std::fabs(det) < 1e-10f) return;
     float invDet = 1.0f / det;
 
     float invA[3][3];
@@ -202,15 +202,34 @@ bool MicArrayLocalizer::solve3D(const std::array<float, 3>& tdoa, Vec3& directio
     invA[2][1] = (A[0][1] * A[2][0] - A[0][0] * A[2][1]) * invDet;
     invA[2][2] = (A[0][0] * A[1][1] - A[0][1] * A[1][0]) * invDet;
 
-    direction.x = invA[0][0] * b[0] + invA[0][1] * b[1] + invA[0][2] * b[2];
-    direction.y = invA[1][0] * b[0] + invA[1][1] * b[1] + invA[1][2] * b[2];
-    direction.z = invA[2][0] * b[0] + invA[2][1] * b[1] + invA[2][2] * b[2];
+    for (int r = 0; r < 3; ++r) {
+        for (int i = 0; i < 3; ++i) {
+            pinv_[r][i] = invA[r][0] * diff[i].x + invA[r][1] * diff[i].y + invA[r][2] * diff[i].z;
+        }
+    }
+    solvable_ = true;
+}
+
+bool MicArrayLocalizer::solve(const std::array<float, 3>& tdoa, Vec3& direction) const {
+    if (!solvable_) return false;
+    const float c = config_.sound_speed;
+    const float r0 = tdoa[0] * c;
+    const float r1 = tdoa[1] * c;
+    const float r2 = tdoa[2] * c;
+    direction.x = pinv_[0][0] * r0 + pinv_[0][1] * r1 + pinv_[0][2] * r2;
+    direction.y = pinv_[1][0] * r0 + pinv_[1][1] * r1 + pinv_[1][2] * r2;
+    direction.z = pinv_[2][0] * r0 + pinv_[2][1] * r1 + pinv_[2][2] * r2;
     return true;
 }
 
+void MicArrayLocalizer::inheritState(const MicArrayLocalizer& previous) {
+    smoothed_direction_ = previous.smoothed_direction_;
+    first_result_ = previous.first_result_;
+}
+
 float MicArrayLocalizer::computeCrossCorrelation(const float* sig1, const float* sig2,
                                                  uint32_t length, int32_t max_delay,
-                                                 int32_t& best_delay) {
+                                                 int32_t& best_delay) const {
     float max_corr = -1e30f;
     best_delay = 0;
 
@@ -243,85 +262,128 @@ float MicArrayLocalizer::computeCrossCorrelation(const float* sig1, const float*
     return max_corr;
 }
 
-MicArrayConfig MicArrayLocalizer::loadConfig(const std::string& filepath) {
-    MicArrayConfig config;
-    std::cout << "Loading microphone array configuration from: " << filepath << std::endl;
-    try {
-        YAML::Node yaml = YAML::LoadFile(filepath);
-        
-        // 阵列类型
-        if (yaml["microphones"] && yaml["microphones"]["array_type"]) {
-            config.array_type = yaml["microphones"]["array_type"].as<std::string>();
-        }
-        
-        // 音频参数
-        if (yaml["audio"]) {
-            if (yaml["audio"]["sample_rate"])
-                config.sample_rate = yaml["audio"]["sample_rate"].as<uint32_t>();
-            if (yaml["audio"]["frame_size"])
-                config.frame_size = yaml["audio"]["frame_size"].as<uint32_t>();
-            if (yaml["audio"]["max_delay_samples"])
-                config.max_delay_samples = yaml["audio"]["max_delay_samples"].as<int32_t>();
-            if (yaml["audio"]["channels"])
-                config.channels = yaml["audio"]["channels"].as<uint32_t>();
-            if (yaml["audio"]["gain"])
-                config.audio_gain = yaml["audio"]["gain"].as<float>();
-        }
-        
-        // 环境参数
-        if (yaml["environment"]) {
-            if (yaml["environment"]["sound_speed"])
-                config.sound_speed = yaml["environment"]["sound_speed"].as<float>();
-        }
-        
-        // 麦克风位置
-        if (yaml["microphones"]) {
-            // 检查是否使用预定义阵列
-            if (config.array_type == "tetrahedron" && yaml["microphones"]["tetrahedron"]) {
-                float edge_length = 0.08f;
-                if (yaml["microphones"]["tetrahedron"]["edge_length"]) {
-                    edge_length = yaml["microphones"]["tetrahedron"]["edge_length"].as<float>();
-                }
-                generateTetrahedronPositions(config.mic_positions, edge_length);
-                std::cout << "使用正四面体阵列，边长: " << (edge_length * 100) << " cm" << std::endl;
+/**
+ * @brief 从 YAML 节点解析配置（字段缺省时保留 config 中的值），解析失败抛异常
+ */
+static void parseConfigNode(const YAML::Node& yaml, MicArrayConfig& config) {
+    // 阵列类型
+    if (yaml["microphones"] && yaml["microphones"]["array_type"]) {
+        config.array_type = yaml["microphones"]["array_type"].as<std::string>();
+    }
+    
+    // 音频参数
+    if (yaml["audio"]) {
+        if (yaml["audio"]["sample_rate"])
+            config.sample_rate = yaml["audio"]["sample_rate"].as<uint32_t>();
+        if (yaml["audio"]["frame_size"])
+            config.frame_size = yaml["audio"]["frame_size"].as<uint32_t>();
+        if (yaml["audio"]["max_delay_samples"])
+            config.max_delay_samples = yaml["audio"]["max_delay_samples"].as<int32_t>();
+        if (yaml["audio"]["channels"])
+            config.channels = yaml["audio"]["channels"].as<uint32_t>();
+        if (yaml["audio"]["gain"])
+            config.audio_gain = yaml["audio"]["gain"].as<float>();
+    }
+    
+    // 环境参数
+    if (yaml["environment"]) {
+        if (yaml["environment"]["sound_speed"])
+            config.sound_speed = yaml["environment"]["sound_speed"].as<float>();
+    }
+    
+    // 麦克风位置
+    if (yaml["microphones"]) {
+        // 检查是否使用预定义阵列
+        if (config.array_type == "tetrahedron" && yaml["microphones"]["tetrahedron"]) {
+            float edge_length = 0.08f;
+            if (yaml["microphones"]["tetrahedron"]["edge_length"]) {
+                edge_length = yaml["microphones"]["tetrahedron"]["edge_length"].as<float>();
             }
-            else if (config.array_type == "square" && yaml["microphones"]["square"]) {
-                float edge_length = 0.08f;
-                if (yaml["microphones"]["square"]["edge_length"]) {
-                    edge_length = yaml["microphones"]["square"]["edge_length"].as<float>();
-                }
-                generateSquarePositions(config.mic_positions, edge_length);
-                std::cout << "使用正方形阵列，边长: " << (edge_length * 100) << " cm" << std::endl;
+            generateTetrahedronPositions(config.mic_positions, edge_length);
+            std::cout << "使用正四面体阵列，边长: " << (edge_length * 100) << " cm" << std::endl;
+        }
+        else if (config.array_type == "square" && yaml["microphones"]["square"]) {
+            float edge_length = 0.08f;
+            if (yaml["microphones"]["square"]["edge_length"]) {
+                edge_length = yaml["microphones"]["square"]["edge_length"].as<float>();
             }
-            else if (yaml["microphones"]["positions"]) {
-                // 自定义位置
-                for (int i = 0; i < 4; i++) {
-                    std::string key = "mic_" + std::to_string(i);
-                    if (yaml["microphones"]["positions"][key]) {
-                        config.mic_positions[i].x = yaml["microphones"]["positions"][key]["x"].as<float>();
-                        config.mic_positions[i].y = yaml["microphones"]["positions"][key]["y"].as<float>();
-                        config.mic_positions[i].z = yaml["microphones"]["positions"][key]["z"].as<float>();
-                    }
+            generateSquarePositions(config.mic_positions, edge_length);
+            std::cout << "使用正方形阵列，边长: " << (edge_length * 100) << " cm" << std::endl;
+        }
+        else if (yaml["microphones"]["positions"]) {
+            // 自定义位置
+            for (int i = 0; i < 4; i++) {
+                std::string key = "mic_" + std::to_string(i);
+                if (yaml["microphones"]["positions"][key]) {
+                    config.mic_positions[i].x = yaml["microphones"]["positions"][key]["x"].as<float>();
+                    config.mic_positions[i].y = yaml["microphones"]["positions"][key]["y"].as<float>();
+                    config.mic_positions[i].z = yaml["microphones"]["positions"][key]["z"].as<float>();
                 }
-                std::cout << "使用自定义麦克风位置" << std::endl;
             }
+            std::cout << "使用自定义麦克风位置" << std::endl;
         }
-        
-        // 自动检测是否为平面阵列
-        config.is_planar = checkPlanarArray(config.mic_positions);
-        
-        // 定位参数
-        if (yaml["localization"]) {
-            if (yaml["localization"]["min_confidence"])
-                config.min_confidence = yaml["localization"]["min_confidence"].as<float>();
-            if (yaml["localization"]["smoothing"]) {
-                if (yaml["localization"]["smoothing"]["enabled"])
-                    config.smoothing_enabled = yaml["localization"]["smoothing"]["enabled"].as<bool>();
-                if (yaml["localization"]["smoothing"]["alpha"])
-                    config.smoothing_alpha = yaml["localization"]["smoothing"]["alpha"].as<float>();
-            }
+    }
+    
+    // 自动检测是否为平面阵列
+    config.is_planar = checkPlanarArray(config.mic_positions);
+    
+    // 定位参数
+    if (yaml["localization"]) {
+        if (yaml["localization"]["min_confidence"])
+            config.min_confidence = yaml["localization"]["min_confidence"].as<float>();
+        if (yaml["localization"]["smoothing"]) {
+            if (yaml["localization"]["smoothing"]["enabled"])
+                config.smoothing_enabled = yaml["localization"]["smoothing"]["enabled"].as<bool>();
+            if (yaml["localization"]["smoothing"]["alpha"])
+                config.smoothing_alpha = yaml["localization"]["smoothing"]["alpha"].as<float>();
+        }
+        if (yaml["localization"]["sliding_window"]) {
+            const YAML::Node sw = yaml["localization"]["sliding_window"];
+            if (sw["enabled"])
+                config.sliding_window_enabled = sw["enabled"].as<bool>();
+            if (sw["window_size"])
+                config.window_size = sw["window_size"].as<uint32_t>();
+            if (sw["hop_size"])
+                config.hop_size = sw["hop_size"].as<uint32_t>();
+            if (sw["accumulate_hops"])
+                config.accumulate_hops = sw["accumulate_hops"].as<uint32_t>();
+        }
+        if (yaml["localization"]["tracking"]) {
+            const YAML::Node tr = yaml["localization"]["tracking"];
+            if (tr["enabled"])
+                config.tracking_enabled = tr["enabled"].as<bool>();
+            if (tr["max_tracks"])
+                config.max_tracks = tr["max_tracks"].as<uint32_t>();
+            if (tr["gate_deg"])
+                config.gate_deg = tr["gate_deg"].as<float>();
+            if (tr["birth_hits"])
+                config.birth_hits = tr["birth_hits"].as<uint32_t>();
+            if (tr["timeout_s"])
+                config.track_timeout_s = tr["timeout_s"].as<float>();
+            if (tr["process_noise"])
+                config.process_noise = tr["process_noise"].as<float>();
+            if (tr["measurement_noise_deg"])
+                config.measurement_noise_deg = tr["measurement_noise_deg"].as<float>();
         }
-          
+        if (yaml["localization"]["parallel_workers"])
+            config.parallel_workers = yaml["localization"]["parallel_workers"].as<uint32_t>();
+    }
+
+    // 波束形成
+    if (yaml["beamforming"]) {
+        if (yaml["beamforming"]["enabled"])
+            config.beamforming_enabled = yaml["beamforming"]["enabled"].as<bool>();
+        if (yaml["beamforming"]["taps"])
+            config.beamforming_taps = yaml["beamforming"]["taps"].as<int>();
+    }
+}
+
+MicArrayConfig MicArrayLocalizer::loadConfig(const std::string& filepath) {
+    MicArrayConfig config;
+    std::cout << "Loading microphone array configuration from: " << filepath << std::endl;
+    try {
+        YAML::Node yaml = YAML::LoadFile(filepath);
+        parseConfigNode(yaml, config);
         std::cout << "配置文件加载成功: " << filepath << std::endl;
     }
     catch (const std::exception& e) {
@@ -333,6 +395,32 @@ MicArrayConfig MicArrayLocalizer::loadConfig(const std::string& filepath) {
       return config;
 }
 
+bool MicArrayLocalizer::tryLoadConfig(const std::string& filepath, MicArrayConfig& out) {
+    try {
+        MicArrayConfig config;
+        parseConfigNode(YAML::LoadFile(filepath), config);
+        out = config;
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "加载配置文件失败: " << filepath << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool MicArrayLocalizer::parseConfig(const std::string& yaml_text, MicArrayConfig& out) {
+    try {
+        MicArrayConfig config;
+        parseConfigNode(YAML::Load(yaml_text), config);
+        out = config;
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "解析配置失败: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 void MicArrayLocalizer::calc4chSeparateDb(const std::array<std::vector<float>, 4>& channels,
                                           double* db_out) const {
     const int num_channels = 4;
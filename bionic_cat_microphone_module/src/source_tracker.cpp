@@ -0,0 +1,169 @@
+#include "source_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+// 角度差折算到 (-180, 180]
+static inline float wrapDeg(float a) {
+    while (a > 180.0f) a -= 360.0f;
+    while (a <= -180.0f) a += 360.0f;
+    return a;
+}
+
+SourceTracker::SourceTracker(const MicArrayConfig& config)
+    : max_tracks_(std::max(1, std::min<int>(static_cast<int>(config.max_tracks), kMaxTracks)))
+    , gate_deg_(config.gate_deg > 0.0f ? config.gate_deg : 25.0f)
+    , birth_hits_(std::max<uint32_t>(1, config.birth_hits))
+    , timeout_s_(config.track_timeout_s > 0.0f ? config.track_timeout_s : 1.5f)
+    , q_(config.process_noise > 0.0f ? config.process_noise : 400.0f)
+    , r_(config.measurement_noise_deg * config.measurement_noise_deg)
+    , min_confidence_(config.min_confidence) {
+    if (r_ <= 0.0f) r_ = 36.0f;
+}
+
+void SourceTracker::reset() {
+    for (Track& t : tracks_) t = Track{};
+}
+
+void SourceTracker::predict(Track& t, float dt) const {
+    // 匀速模型：F = [1 dt; 0 1]，Q 为连续白噪声加速度离散化
+    t.az = wrapDeg(t.az + t.az_rate * dt);
+    const float dt2 = dt * dt;
+    const float p00 = t.p00 + dt * (2.0f * t.p01 + dt * t.p11) + q_ * dt2 * dt / 3.0f;
+    const float p01 = t.p01 + dt * t.p11 + q_ * dt2 / 2.0f;
+    const float p11 = t.p11 + q_ * dt;
+    t.p00 = p00;
+    t.p01 = p01;
+    t.p11 = p11;
+    t.pel += q_ * dt2 * dt / 3.0f;
+    t.since_update_s += dt;
+    t.age_s += dt;
+}
+
+void SourceTracker::update(Track& t, const SourceMeasurement& m) const {
+    // 置信度越低观测噪声越大
+    const float r = r_ / std::max(0.05f, m.confidence);
+
+    const float innov = wrapDeg(m.azimuth - t.az);
+    const float s = t.p00 + r;
+    const float k0 = t.p00 / s;
+    const float k1 = t.p01 / s;
+    t.az = wrapDeg(t.az + k0 * innov);
+    t.az_rate += k1 * innov;
+    const float p00 = (1.0f - k0) * t.p00;
+    const float p01 = (1.0f - k0) * t.p01;
+    const float p11 = t.p11 - k1 * t.p01;
+    t.p00 = p00;
+    t.p01 = p01;
+    t.p11 = p11;
+
+    const float kel = t.pel / (t.pel + r);
+    t.el += kel * (m.elevation - t.el);
+    t.pel *= (1.0f - kel);
+
+    t.confidence = 0.7f * t.confidence + 0.3f * m.confidence;
+    t.since_update_s = 0.0f;
+    if (++t.hits >= birth_hits_) t.confirmed = true;
+}
+
+void SourceTracker::spawn(const SourceMeasurement& m) {
+    // 优先空槽，其次替换最弱的暂定轨迹，再次替换最弱的已确认轨迹
+    Track* slot = nullptr;
+    for (int i = 0; i < max_tracks_; ++i) {
+        if (!tracks_[i].used) { slot = &tracks_[i]; break; }
+    }
+    if (!slot) {
+        for (int pass = 0; pass < 2 && !slot; ++pass) {
+            const bool want_confirmed = (pass == 1);
+            for (int i = 0; i < max_tracks_; ++i) {
+                Track& t = tracks_[i];
+                if (t.confirmed != want_confirmed) continue;
+                if (!slot || t.confidence < slot->confidence) slot = &t;
+            }
+        }
+        // 新观测比现有最弱轨迹还弱时不替换
+        if (!slot || slot->confidence > m.confidence) return;
+    }
+
+    Track t{};
+    t.used = true;
+    t.id = next_id_++;
+    t.az = wrapDeg(m.azimuth);
+    t.el = m.elevation;
+    t.p00 = r_ * 4.0f;
+    t.p11 = 30.0f * 30.0f;
+    t.pel = r_ * 4.0f;
+    t.confidence = m.confidence;
+    t.hits = 1;
+    t.confirmed = (birth_hits_ <= 1);
+    *slot = t;
+}
+
+void SourceTracker::step(float dt, const SourceMeasurement* measurements, size_t count) {
+    if (dt < 0.0f) dt = 0.0f;
+    for (int i = 0; i < max_tracks_; ++i) {
+        Track& t = tracks_[i];
+        if (!t.used) continue;
+        predict(t, dt);
+    }
+
+    // 贪心最近邻关联：每条轨迹每步最多关联一个观测
+    bool assigned[kMaxTracks] = {};
+    for (size_t mi = 0; mi < count; ++mi) {
+        const SourceMeasurement& m = measurements[mi];
+        if (m.confidence < min_confidence_) continue;
+        int best = -1;
+        float best_dist = gate_deg_;
+        for (int i = 0; i < max_tracks_; ++i) {
+            const Track& t = tracks_[i];
+            if (!t.used || assigned[i]) continue;
+            // 门限随预测不确定度放宽，但不超过 2 倍基础门限，避免吞掉相邻声源
+            const float gate = std::min(gate_deg_ + 2.0f * std::sqrt(std::max(0.0f, t.p00)),
+                                        2.0f * gate_deg_);
+            const float d = std::fabs(wrapDeg(m.azimuth - t.az));
+            if (d <= gate && (best < 0 || d < best_dist)) {
+                best = i;
+                best_dist = d;
+            }
+        }
+        if (best >= 0) {
+            update(tracks_[best], m);
+            assigned[best] = true;
+        } else {
+            spawn(m);
+        }
+    }
+
+    for (int i = 0; i < max_tracks_; ++i) {
+        Track& t = tracks_[i];
+        if (!t.used || assigned[i]) continue;
+        t.confidence *= 0.97f;
+        // 暂定轨迹更快消亡
+        const float limit = t.confirmed ? timeout_s_ : timeout_s_ * 0.3f;
+        if (t.since_update_s > limit) t = Track{};
+    }
+}
+
+size_t SourceTracker::activeSources(std::array<TrackedSource, kMaxTracks>& out) const {
+    size_t n = 0;
+    for (int i = 0; i < max_tracks_; ++i) {
+        const Track& t = tracks_[i];
+        if (!t.used || !t.confirmed) continue;
+        TrackedSource& s = out[n++];
+        s.track_id = t.id;
+        s.azimuth = t.az;
+        s.elevation = t.el;
+        s.azimuth_rate = t.az_rate;
+        s.confidence = t.confidence;
+        s.age_ms = static_cast<uint32_t>(t.age_s * 1000.0f);
+    }
+    std::sort(out.begin(), out.begin() + n,
+              [](const TrackedSource& a, const TrackedSource& b) { return a.confidence > b.confidence; });
+    return n;
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -0,0 +1,75 @@
+#include "worker_pool.hpp"
+
+namespace BionicCat {
+namespace MicrophoneModule {
+
+WorkerPool::WorkerPool(uint32_t workers) {
+    threads_.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void WorkerPool::run(uint32_t count, TaskFn fn, void* ctx) {
+    if (count == 0) return;
+    if (threads_.empty() || count == 1) {
+        for (uint32_t i = 0; i < count; ++i) fn(ctx, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        fn_ = fn;
+        ctx_ = ctx;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        active_ = static_cast<uint32_t>(threads_.size());
+        ++generation_;
+    }
+    start_cv_.notify_all();
+
+    // 调用线程同样领取任务，避免一个核空等
+    drain();
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    done_cv_.wait(lk, [this] { return active_ == 0; });
+}
+
+void WorkerPool::drain() {
+    for (;;) {
+        const uint32_t i = next_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count_) break;
+        fn_(ctx_, i);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            start_cv_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        drain();
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (--active_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+} // namespace MicrophoneModule
+} // namespace BionicCat
@@ -0,0 +1,194 @@
+// 编码器 CPU 基准：每秒音频的编码耗时、实时系数与实际码率
+//
+// 不依赖声卡，在目标板上直接运行即可得到各编码器的 CPU 开销：
+//  - 默认合成近似语音的信号（基频抖动的谐波 + 音节包络 + 底噪）
+//  - --wav 使用真实录音（S16LE，取第 1 通道，采样率取自文件）
+//
+// 示例：
+//   microphone_codec_bench --sr 16000 --bitrate 24000 --secs 30
+//   microphone_codec_bench --wav speech_16k.wav --codec opus
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "audio_encoder.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace BionicCat::MicrophoneModule;
+
+namespace {
+
+struct Options {
+    std::string wav_path;
+    std::string codec{"all"}; // aac | opus | all
+    int sample_rate{16000};
+    int bitrate{32000};
+    float seconds{20.0f};
+};
+
+void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --codec <aac|opus|all>  Codec(s) to benchmark (default all)\n"
+              << "  --sr <hz>               Sample rate for the synthetic signal (default 16000)\n"
+              << "  --bitrate <bps>         Target bitrate (default 32000)\n"
+              << "  --secs <s>              Synthetic duration (default 20)\n"
+              << "  --wav <file>            Encode channel 0 of a S16LE WAV instead\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&](void) -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--codec" && (v = next())) o.codec = v;
+        else if (a == "--sr" && (v = next())) o.sample_rate = std::stoi(v);
+        else if (a == "--bitrate" && (v = next())) o.bitrate = std::stoi(v);
+        else if (a == "--secs" && (v = next())) o.seconds = std::stof(v);
+        else if (a == "--wav" && (v = next())) o.wav_path = v;
+        else if (a == "-h" || a == "--help") { usage(argv[0]); std::exit(0); }
+        else { std::cerr << "Unknown or incomplete arg: " << a << "\n"; return false; }
+    }
+    return true;
+}
+
+// 最小 WAV 读取：PCM S16LE，返回第 1 通道
+bool readWavCh0(const std::string& path, std::vector<int16_t>& out, int& sample_rate) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    char riff[12];
+    if (!f.read(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    uint16_t channels = 0, bits = 0;
+    uint32_t rate = 0;
+    char id[4];
+    uint32_t len = 0;
+    while (f.read(id, 4) && f.read(reinterpret_cast<char*>(&len), 4)) {
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            std::vector<char> fmt(len);
+            if (!f.read(fmt.data(), len) || len < 16) return false;
+            std::memcpy(&channels, fmt.data() + 2, 2);
+            std::memcpy(&rate, fmt.data() + 4, 4);
+            std::memcpy(&bits, fmt.data() + 14, 2);
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (channels == 0 || bits != 16) return false;
+            std::vector<int16_t> inter(len / 2);
+            f.read(reinterpret_cast<char*>(inter.data()), static_cast<std::streamsize>(inter.size() * 2));
+            const size_t frames = static_cast<size_t>(f.gcount()) / 2 / channels;
+            out.resize(frames);
+            for (size_t i = 0; i < frames; ++i) out[i] = inter[i * channels];
+            sample_rate = static_cast<int>(rate);
+            return true;
+        } else {
+            f.seekg(len + (len & 1), std::ios::cur);
+        }
+    }
+    return false;
+}
+
+// 近似语音：120..220 Hz 基频抖动的谐波串，按 ~4 Hz 音节节奏开合，叠加 -50 dB 底噪
+std::vector<int16_t> synthesizeSpeechLike(int sample_rate, float seconds) {
+    const size_t n = static_cast<size_t>(seconds * static_cast<float>(sample_rate));
+    std::vector<int16_t> out(n);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.003f);
+    double phase = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double t = static_cast<double>(i) / sample_rate;
+        const double f0 = 170.0 + 50.0 * std::sin(2.0 * M_PI * 0.7 * t);
+        phase += 2.0 * M_PI * f0 / sample_rate;
+        double v = 0.0;
+        for (int h = 1; h * f0 < sample_rate * 0.45 && h <= 30; ++h) {
+            v += std::sin(h * phase) / h;
+        }
+        const double syllable = std::max(0.0, std::sin(2.0 * M_PI * 4.0 * t));
+        const float s = static_cast<float>(0.25 * syllable * v) + noise(rng);
+        out[i] = static_cast<int16_t>(std::lrint(std::max(-1.0f, std::min(1.0f, s)) * 32767.0f));
+    }
+    return out;
+}
+
+double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+void benchCodec(AudioCodecType codec, const std::vector<int16_t>& pcm, int sample_rate, int bitrate) {
+    auto enc = createAudioEncoder(codec);
+    if (!enc || !enc->init(sample_rate, 1, bitrate, 2)) {
+        std::cout << "[CodecBench] " << audioCodecName(codec) << ": unavailable" << std::endl;
+        return;
+    }
+    const size_t frame = static_cast<size_t>(enc->frameSamplesPerCh());
+    std::vector<double> frame_us;
+    frame_us.reserve(pcm.size() / frame + 1);
+    size_t bytes = 0, packets = 0;
+
+    const double cpu0 = threadCpuSeconds();
+    for (size_t off = 0; off + frame <= pcm.size(); off += frame) {
+        const double t0 = threadCpuSeconds();
+        ByteSlice out;
+        if (!enc->encode(pcm.data() + off, frame, out)) {
+            std::cout << "[CodecBench] " << audioCodecName(codec) << ": encode failed" << std::endl;
+            return;
+        }
+        frame_us.push_back((threadCpuSeconds() - t0) * 1e6);
+        bytes += out.size();
+        if (!out.empty()) ++packets;
+    }
+    const double cpu_s = threadCpuSeconds() - cpu0;
+    enc->close();
+
+    const double audio_s = static_cast<double>(frame_us.size() * frame) / sample_rate;
+    std::sort(frame_us.begin(), frame_us.end());
+    const double p99 = frame_us.empty() ? 0.0 : frame_us[static_cast<size_t>(0.99 * (frame_us.size() - 1))];
+    const double frame_ms = 1000.0 * static_cast<double>(frame) / sample_rate;
+    std::cout << std::fixed << std::setprecision(2)
+              << "[CodecBench] " << std::setw(4) << audioCodecName(codec)
+              << "  frame=" << frame_ms << "ms"
+              << "  cpu=" << (cpu_s * 1000.0 / audio_s) << "ms per audio s"
+              << " (" << (100.0 * cpu_s / audio_s) << "% of one core)"
+              << "  p99 frame=" << p99 << "us"
+              << "  bitrate=" << (bytes * 8.0 / audio_s / 1000.0) << "kbps"
+              << "  packets=" << packets << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<int16_t> pcm;
+    int sample_rate = opt.sample_rate;
+    if (!opt.wav_path.empty()) {
+        if (!readWavCh0(opt.wav_path, pcm, sample_rate)) {
+            std::cerr << "Failed to read WAV: " << opt.wav_path << std::endl;
+            return 2;
+        }
+    } else {
+        pcm = synthesizeSpeechLike(sample_rate, opt.seconds);
+    }
+    std::cout << "[CodecBench] " << (static_cast<double>(pcm.size()) / sample_rate) << "s mono @ "
+              << sample_rate << " Hz, target " << opt.bitrate << " bps" << std::endl;
+
+    if (opt.codec == "aac" || opt.codec == "all") benchCodec(AudioCodecType::AAC_ADTS, pcm, sample_rate, opt.bitrate);
+    if (opt.codec == "opus" || opt.codec == "all") benchCodec(AudioCodecType::OPUS, pcm, sample_rate, opt.bitrate);
+    return 0;
+}
@@ -0,0 +1,550 @@
+// 离线声源定位回放 / 精度与性能基准
+//
+// 不依赖声卡与 4 麦阵列，可在 x86 主机上运行：
+//  1) 回放多通道 WAV（S16LE，≥4 通道，取前 4 路）
+//  2) 按 MicArrayConfig 几何生成合成信号：可控方位、分数延迟、噪声（SNR）与混响（RT60）
+// 输出角度误差、置信度校准表以及每帧耗时（µs）。
+//
+// 示例：
+//   microphone_localization_bench -c custom_3d_mic_config.yaml --sweep 30 --snr 10 --rt60 0.3
+//   microphone_localization_bench -c custom_3d_mic_config.yaml --wav rec_4ch.wav --az 90 --el 0
+//   microphone_localization_bench -c custom_3d_mic_config.yaml --workers 3   # 对比单线程与线程池耗时
+//   microphone_localization_bench -c custom_3d_mic_config.yaml --beamform    # 波束形成 SNR 增益与耗时
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sound_localization.hpp"
+#include "sliding_window_localizer.hpp"
+#include "worker_pool.hpp"
+#include "beamformer.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace BionicCat::MicrophoneModule;
+
+namespace {
+
+struct Options {
+    std::string config_path;
+    std::string wav_path;
+    bool has_truth{false};
+    float az_deg{45.0f};
+    float el_deg{0.0f};
+    float sweep_step{0.0f};     // >0 时按步长扫描方位角
+    float snr_db{20.0f};
+    float rt60_s{0.0f};
+    float seconds{2.0f};
+    std::string signal{"noise"}; // noise | burst
+    int sliding{-1};             // -1 跟随配置，0/1 强制
+    bool propagation{false};     // 以声波传播方向（声源反方向）作为真值
+    int workers{-1};             // -1 跟随配置；>=0 时同时测单线程基线与该线程数
+    bool beamform{false};        // 评估延迟求和波束形成
+    uint32_t seed{1};
+};
+
+struct FrameStat {
+    float error_deg{0.0f};
+    float confidence{0.0f};
+};
+
+struct Summary {
+    std::vector<FrameStat> frames;
+    std::vector<double> frame_us;
+    size_t failed{0};
+};
+
+void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  -c, --config <yaml>   MicArrayConfig YAML (default: built-in tetrahedron)\n"
+              << "  --wav <file>          Replay multichannel S16LE WAV instead of synthesizing\n"
+              << "  --az <deg>            Source azimuth (truth for WAV replay, default 45)\n"
+              << "  --el <deg>            Source elevation (default 0)\n"
+              << "  --sweep <step_deg>    Synthesize and sweep azimuth over [-180,180)\n"
+              << "  --snr <dB>            Additive white noise SNR (default 20)\n"
+              << "  --rt60 <s>            Synthetic diffuse reverb RT60 (default 0 = anechoic)\n"
+              << "  --secs <s>            Synthetic duration per angle (default 2)\n"
+              << "  --signal <noise|burst> Source signal (default noise)\n"
+              << "  --sliding <0|1>       Override localization.sliding_window.enabled\n"
+              << "  --propagation         Score against propagation direction (opposite of source)\n"
+              << "  --workers <n>         Compare single-thread timing with an n-thread worker pool\n"
+              << "  --beamform            Measure delay-and-sum SNR gain over ch0 and its cost\n"
+              << "  --seed <n>            RNG seed\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&](void) -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if ((a == "-c" || a == "--config") && (v = next())) o.config_path = v;
+        else if (a == "--wav" && (v = next())) o.wav_path = v;
+        else if (a == "--az" && (v = next())) { o.az_deg = std::stof(v); o.has_truth = true; }
+        else if (a == "--el" && (v = next())) { o.el_deg = std::stof(v); o.has_truth = true; }
+        else if (a == "--sweep" && (v = next())) o.sweep_step = std::stof(v);
+        else if (a == "--snr" && (v = next())) o.snr_db = std::stof(v);
+        else if (a == "--rt60" && (v = next())) o.rt60_s = std::stof(v);
+        else if (a == "--secs" && (v = next())) o.seconds = std::stof(v);
+        else if (a == "--signal" && (v = next())) o.signal = v;
+        else if (a == "--sliding" && (v = next())) o.sliding = std::stoi(v);
+        else if (a == "--propagation") o.propagation = true;
+        else if (a == "--workers" && (v = next())) o.workers = std::stoi(v);
+        else if (a == "--beamform") o.beamform = true;
+        else if (a == "--seed" && (v = next())) o.seed = static_cast<uint32_t>(std::stoul(v));
+        else if (a == "-h" || a == "--help") { usage(argv[0]); std::exit(0); }
+        else { std::cerr << "Unknown or incomplete arg: " << a << "\n"; return false; }
+    }
+    return true;
+}
+
+Vec3 directionFromAngles(float az_deg, float el_deg) {
+    const float az = az_deg * static_cast<float>(M_PI) / 180.0f;
+    const float el = el_deg * static_cast<float>(M_PI) / 180.0f;
+    return Vec3(std::cos(el) * std::cos(az), std::cos(el) * std::sin(az), std::sin(el));
+}
+
+float angularErrorDeg(const Vec3& truth, float az_deg, float el_deg, bool planar) {
+    if (planar) {
+        // 平面阵列无法区分上下半球，只比较方位角
+        float d = std::fabs(az_deg - std::atan2(truth.y, truth.x) * 180.0f / static_cast<float>(M_PI));
+        while (d > 180.0f) d = std::fabs(d - 360.0f);
+        return d;
+    }
+    const Vec3 est = directionFromAngles(az_deg, el_deg);
+    const float c = std::max(-1.0f, std::min(1.0f, truth.dot(est)));
+    return std::acos(c) * 180.0f / static_cast<float>(M_PI);
+}
+
+// ---------------- 合成信号 ----------------
+
+// 窗函数 sinc 分数延迟：out[n] = in[n - delay]
+void fractionalDelay(const std::vector<float>& in, double delay, std::vector<float>& out) {
+    const int half = 16;
+    out.assign(in.size(), 0.0f);
+    const int di = static_cast<int>(std::floor(delay));
+    const double frac = delay - di;
+    float taps[2 * half + 1];
+    for (int k = -half; k <= half; ++k) {
+        const double x = k - frac;
+        const double sinc = (std::fabs(x) < 1e-9) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        const double w = 0.5 + 0.5 * std::cos(M_PI * x / (half + 1));
+        taps[k + half] = static_cast<float>(sinc * w);
+    }
+    const int n = static_cast<int>(in.size());
+    for (int i = 0; i < n; ++i) {
+        float acc = 0.0f;
+        for (int k = -half; k <= half; ++k) {
+            const int j = i - di - k;
+            if (j >= 0 && j < n) acc += taps[k + half] * in[static_cast<size_t>(j)];
+        }
+        out[static_cast<size_t>(i)] = acc;
+    }
+}
+
+// 漫射混响尾：每个麦克风独立的指数衰减噪声，起始于直达声后 3ms
+void addReverb(std::vector<float>& x, float rt60_s, uint32_t sample_rate, std::mt19937& rng) {
+    if (rt60_s <= 0.0f) return;
+    const size_t len = static_cast<size_t>(rt60_s * sample_rate);
+    const size_t onset = static_cast<size_t>(0.003f * sample_rate);
+    std::normal_distribution<float> nd(0.0f, 1.0f);
+    std::vector<float> ir(len, 0.0f);
+    const float decay = -6.9078f / (rt60_s * sample_rate); // ln(1e-3)
+    for (size_t i = onset; i < len; ++i) {
+        ir[i] = nd(rng) * std::exp(decay * static_cast<float>(i)) * 0.08f;
+    }
+    // 稀疏化卷积：只对较大系数累加，保持合成速度
+    std::vector<float> y(x);
+    for (size_t k = onset; k < len; k += 2) {
+        const float h = ir[k];
+        if (std::fabs(h) < 1e-4f) continue;
+        for (size_t i = k; i < x.size(); ++i) y[i] += h * x[i - k];
+    }
+    x.swap(y);
+}
+
+// noise_out 非空时噪声单独输出、不叠加到返回的信号上（用于分别测量信号与噪声经过处理后的能量）
+std::array<std::vector<float>, 4> synthesize(const MicArrayConfig& cfg, const Options& o,
+                                             float az_deg, float el_deg, std::mt19937& rng,
+                                             std::array<std::vector<float>, 4>* noise_out = nullptr) {
+    const size_t n = static_cast<size_t>(o.seconds * cfg.sample_rate);
+    std::normal_distribution<float> nd(0.0f, 1.0f);
+    std::vector<float> src(n, 0.0f);
+    if (o.signal == "burst") {
+        // 每 250ms 一个 20ms 的衰减噪声脉冲（类似拍手）
+        const size_t period = cfg.sample_rate / 4;
+        const size_t burst = cfg.sample_rate / 50;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t p = i % period;
+            if (p < burst) src[i] = nd(rng) * 0.3f * std::exp(-5.0f * p / burst);
+        }
+    } else {
+        for (auto& v : src) v = nd(rng) * 0.1f;
+    }
+
+    // 远场平面波：到达时刻 t_m = -p_m·u / c
+    const Vec3 u = directionFromAngles(az_deg, el_deg);
+    std::array<std::vector<float>, 4> ch;
+    double min_delay = 1e9;
+    std::array<double, 4> delay{};
+    for (int m = 0; m < 4; ++m) {
+        delay[m] = -cfg.mic_positions[m].dot(u) / cfg.sound_speed * cfg.sample_rate;
+        min_delay = std::min(min_delay, delay[m]);
+    }
+
+    float sig_power = 0.0f;
+    for (float v : src) sig_power += v * v;
+    sig_power /= static_cast<float>(std::max<size_t>(1, n));
+    const float noise_std = std::sqrt(sig_power / std::pow(10.0f, o.snr_db / 10.0f));
+    std::normal_distribution<float> noise(0.0f, noise_std);
+
+    for (int m = 0; m < 4; ++m) {
+        fractionalDelay(src, delay[m] - min_delay + 20.0, ch[m]);
+        addReverb(ch[m], o.rt60_s, cfg.sample_rate, rng);
+        if (noise_out) {
+            (*noise_out)[m].resize(ch[m].size());
+            for (auto& v : (*noise_out)[m]) v = noise(rng);
+        } else {
+            for (auto& v : ch[m]) v += noise(rng);
+        }
+    }
+    return ch;
+}
+
+// ---------------- WAV 回放 ----------------
+
+bool readWav4ch(const std::string& path, uint32_t& sample_rate, std::array<std::vector<float>, 4>& ch) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) return false;
+    char riff[12];
+    if (!ifs.read(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    uint16_t fmt_tag = 0, channels = 0, bits = 0;
+    sample_rate = 0;
+    // 逐块遍历，跳过 LIST/fact 等附加块
+    while (ifs) {
+        char id[4];
+        uint32_t size = 0;
+        if (!ifs.read(id, 4) || !ifs.read(reinterpret_cast<char*>(&size), 4)) break;
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            std::vector<char> fmt(size);
+            ifs.read(fmt.data(), size);
+            if (size < 16) return false;
+            std::memcpy(&fmt_tag, fmt.data(), 2);
+            std::memcpy(&channels, fmt.data() + 2, 2);
+            std::memcpy(&sample_rate, fmt.data() + 4, 4);
+            std::memcpy(&bits, fmt.data() + 14, 2);
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (bits != 16 || channels < 4 || (fmt_tag != 1 && fmt_tag != 0xFFFE)) {
+                std::cerr << "WAV must be 16-bit PCM with >= 4 channels" << std::endl;
+                return false;
+            }
+            std::vector<int16_t> pcm(size / 2);
+            ifs.read(reinterpret_cast<char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * 2));
+            const size_t frames = pcm.size() / channels;
+            for (int c = 0; c < 4; ++c) {
+                ch[c].resize(frames);
+                for (size_t i = 0; i < frames; ++i) {
+                    ch[c][i] = static_cast<float>(pcm[i * channels + c]) / 32768.0f;
+                }
+            }
+            return true;
+        } else {
+            ifs.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+    return false;
+}
+
+// ---------------- 运行与统计 ----------------
+
+void runLocalizer(const MicArrayConfig& cfg, const std::array<std::vector<float>, 4>& ch,
+                  bool has_truth, const Vec3& truth, Summary& out) {
+    std::unique_ptr<WorkerPool> pool;
+    if (cfg.parallel_workers > 0) pool = std::make_unique<WorkerPool>(cfg.parallel_workers);
+    MicArrayLocalizer localizer(cfg);
+    localizer.setWorkerPool(pool.get());
+    std::unique_ptr<SlidingWindowAnalyzer> analyzer;
+    if (cfg.sliding_window_enabled) {
+        analyzer = std::make_unique<SlidingWindowAnalyzer>(
+            cfg, std::min<int32_t>(cfg.max_delay_samples, localizer.maxTheoreticalDelay()));
+        analyzer->setWorkerPool(pool.get());
+    }
+
+    const size_t frames = cfg.frame_size;
+    const size_t total = ch[0].size();
+    std::array<std::vector<float>, 4> block;
+    for (auto& b : block) b.resize(frames);
+    std::vector<TdoaEstimate> hops;
+
+    auto record = [&](bool ok, float az, float el, float conf) {
+        if (!ok) { ++out.failed; return; }
+        FrameStat s;
+        s.confidence = conf;
+        s.error_deg = has_truth ? angularErrorDeg(truth, az, el, cfg.is_planar) : 0.0f;
+        out.frames.push_back(s);
+    };
+
+    for (size_t off = 0; off + frames <= total; off += frames) {
+        for (int c = 0; c < 4; ++c) {
+            std::copy(ch[c].begin() + off, ch[c].begin() + off + frames, block[c].begin());
+        }
+        float az = 0.0f, el = 0.0f, conf = 0.0f;
+        const auto t0 = std::chrono::steady_clock::now();
+        if (analyzer) {
+            analyzer->process(block, static_cast<uint32_t>(frames), hops);
+            const auto t1 = std::chrono::steady_clock::now();
+            out.frame_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            for (const TdoaEstimate& e : hops) {
+                const bool ok = e.confidence > 0.0f && localizer.resolveDirection(e.tdoa, az, el);
+                record(ok, az, el, e.confidence);
+            }
+        } else {
+            const bool ok = localizer.localize(block, static_cast<uint32_t>(frames), az, el, conf);
+            const auto t1 = std::chrono::steady_clock::now();
+            out.frame_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            record(ok, az, el, conf);
+        }
+    }
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t idx = std::min(v.size() - 1, static_cast<size_t>(p * (v.size() - 1) + 0.5));
+    return v[idx];
+}
+
+// 真值方向：默认指向声源，--propagation 时取反
+Vec3 truthDirection(const Options& o, float az_deg, float el_deg) {
+    const Vec3 u = directionFromAngles(az_deg, el_deg);
+    return o.propagation ? Vec3(-u.x, -u.y, -u.z) : u;
+}
+
+void printAccuracy(const Summary& s, bool has_truth) {
+    if (s.frames.empty()) {
+        std::cout << "  no localization results (failed=" << s.failed << ")" << std::endl;
+        return;
+    }
+    if (has_truth) {
+        std::vector<double> err;
+        for (const auto& f : s.frames) err.push_back(f.error_deg);
+        double mean = 0.0;
+        for (double e : err) mean += e;
+        mean /= err.size();
+        std::cout << "  angular error: mean=" << mean
+                  << " p50=" << percentile(err, 0.5)
+                  << " p90=" << percentile(err, 0.9)
+                  << " max=" << percentile(err, 1.0)
+                  << " (n=" << err.size() << ", failed=" << s.failed << ")" << std::endl;
+        if (mean > 150.0) {
+            std::cout << "  WARNING: estimates point along the propagation direction;"
+                         " check mic position sign convention (or score with --propagation)" << std::endl;
+        }
+    }
+}
+
+void printCalibration(const Summary& s) {
+    // 置信度分桶：每桶的平均误差与 10° 内命中率
+    const int kBins = 5;
+    size_t count[kBins] = {};
+    double err_sum[kBins] = {};
+    size_t hit[kBins] = {};
+    for (const auto& f : s.frames) {
+        int b = static_cast<int>(f.confidence * kBins);
+        b = std::max(0, std::min(kBins - 1, b));
+        ++count[b];
+        err_sum[b] += f.error_deg;
+        if (f.error_deg <= 10.0f) ++hit[b];
+    }
+    const std::streamsize prec = std::cout.precision();
+    std::cout << "  confidence calibration:" << std::endl;
+    for (int b = 0; b < kBins; ++b) {
+        std::cout << "    [" << std::fixed << std::setprecision(1) << (b / static_cast<float>(kBins))
+                  << ", " << ((b + 1) / static_cast<float>(kBins)) << ")  n=" << count[b];
+        if (count[b]) {
+            std::cout << "  mean_err=" << (err_sum[b] / count[b])
+                      << "  within10=" << (100.0 * hit[b] / count[b]) << "%";
+        }
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(prec);
+}
+
+double meanUs(const Summary& s) {
+    double mean = 0.0;
+    for (double v : s.frame_us) mean += v;
+    return s.frame_us.empty() ? 0.0 : mean / s.frame_us.size();
+}
+
+void printTiming(const Summary& s, const MicArrayConfig& cfg) {
+    const double mean = meanUs(s);
+    const double budget_us = 1e6 * cfg.frame_size / cfg.sample_rate;
+    std::cout << "  time per frame: mean=" << mean << "us p50=" << percentile(s.frame_us, 0.5)
+              << "us p95=" << percentile(s.frame_us, 0.95) << "us max=" << percentile(s.frame_us, 1.0)
+              << "us (budget " << budget_us << "us, load " << (100.0 * mean / budget_us) << "%)" << std::endl;
+}
+
+// 按定位结果指向，分别让信号与噪声通过波束形成器，比较输出与 ch0 的 SNR
+void benchBeamformer(const MicArrayConfig& cfg, const Options& o, float az_deg, std::mt19937& rng) {
+    std::array<std::vector<float>, 4> noise;
+    const auto clean = synthesize(cfg, o, az_deg, o.el_deg, rng, &noise);
+    const size_t frames = cfg.frame_size;
+    const size_t total = clean[0].size();
+
+    MicArrayLocalizer localizer(cfg);
+    DelayAndSumBeamformer bf_sig(cfg, cfg.frame_size, cfg.beamforming_taps);
+    DelayAndSumBeamformer bf_noise(cfg, cfg.frame_size, cfg.beamforming_taps);
+
+    std::array<std::vector<float>, 4> mix;
+    std::vector<std::vector<int16_t>> in_sig(4, std::vector<int16_t>(frames));
+    std::vector<std::vector<int16_t>> in_noise(4, std::vector<int16_t>(frames));
+    for (auto& m : mix) m.resize(frames);
+    std::vector<int16_t> out_sig, out_noise;
+    std::vector<double> us;
+    auto to16 = [](float v) {
+        const float s = std::max(-1.0f, std::min(1.0f, v)) * 32767.0f;
+        return static_cast<int16_t>(std::lrint(s));
+    };
+
+    double e_ch0_sig = 0.0, e_ch0_noise = 0.0, e_bf_sig = 0.0, e_bf_noise = 0.0;
+    for (size_t off = 0; off + frames <= total; off += frames) {
+        for (int c = 0; c < 4; ++c) {
+            for (size_t i = 0; i < frames; ++i) {
+                mix[c][i] = clean[c][off + i] + noise[c][off + i];
+                in_sig[c][i] = to16(clean[c][off + i]);
+                in_noise[c][i] = to16(noise[c][off + i]);
+            }
+        }
+        float az = 0.0f, el = 0.0f, conf = 0.0f;
+        if (localizer.localize(mix, static_cast<uint32_t>(frames), az, el, conf) && conf >= cfg.min_confidence) {
+            bf_sig.steer(az, el);
+            bf_noise.steer(az, el);
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        bf_sig.process(in_sig, frames, out_sig);
+        const auto t1 = std::chrono::steady_clock::now();
+        us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        bf_noise.process(in_noise, frames, out_noise);
+        // 跳过首帧（滤波器历史未填满）
+        if (off == 0) continue;
+        for (size_t i = 0; i < frames; ++i) {
+            e_ch0_sig += static_cast<double>(in_sig[0][i]) * in_sig[0][i];
+            e_ch0_noise += static_cast<double>(in_noise[0][i]) * in_noise[0][i];
+            e_bf_sig += static_cast<double>(out_sig[i]) * out_sig[i];
+            e_bf_noise += static_cast<double>(out_noise[i]) * out_noise[i];
+        }
+    }
+    auto snr = [](double s, double n) { return n > 0.0 ? 10.0 * std::log10(s / n) : 0.0; };
+    const double snr_ch0 = snr(e_ch0_sig, e_ch0_noise);
+    const double snr_bf = snr(e_bf_sig, e_bf_noise);
+    std::cout << "[Bench] beamform az=" << az_deg << " taps=" << cfg.beamforming_taps
+              << " snr ch0=" << snr_ch0 << "dB beam=" << snr_bf << "dB gain=" << (snr_bf - snr_ch0)
+              << "dB  time per period: p50=" << percentile(us, 0.5) << "us max=" << percentile(us, 1.0)
+              << "us" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    MicArrayConfig cfg = MicArrayLocalizer::loadConfig(opt.config_path);
+    if (opt.sliding >= 0) cfg.sliding_window_enabled = (opt.sliding != 0);
+    if (opt.workers >= 0) cfg.parallel_workers = static_cast<uint32_t>(opt.workers);
+    // 基准只评估原始观测，EMA 会掩盖单帧误差
+    cfg.smoothing_enabled = false;
+
+    std::cout << "[Bench] array=" << cfg.array_type << (cfg.is_planar ? " (planar)" : " (3D)")
+              << " sr=" << cfg.sample_rate << " frame=" << cfg.frame_size
+              << " mode=" << (cfg.sliding_window_enabled ? "sliding-window" : "per-period") << std::endl;
+
+    std::mt19937 rng(opt.seed);
+
+    if (!opt.wav_path.empty()) {
+        std::array<std::vector<float>, 4> ch;
+        uint32_t sr = 0;
+        if (!readWav4ch(opt.wav_path, sr, ch)) {
+            std::cerr << "Failed to read WAV: " << opt.wav_path << std::endl;
+            return 2;
+        }
+        if (sr != cfg.sample_rate) {
+            std::cerr << "WARNING: WAV sample rate " << sr << " != config " << cfg.sample_rate << std::endl;
+        }
+        Summary s;
+        runLocalizer(cfg, ch, opt.has_truth, truthDirection(opt, opt.az_deg, opt.el_deg), s);
+        std::cout << "[Bench] replay " << opt.wav_path << " frames=" << s.frame_us.size() << std::endl;
+        printAccuracy(s, opt.has_truth);
+        if (opt.has_truth) printCalibration(s);
+        printTiming(s, cfg);
+        return 0;
+    }
+
+    std::vector<float> angles;
+    if (opt.sweep_step > 0.0f) {
+        for (float a = -180.0f; a < 180.0f; a += opt.sweep_step) angles.push_back(a);
+    } else {
+        angles.push_back(opt.az_deg);
+    }
+
+    Summary all;
+    for (float az : angles) {
+        const auto ch = synthesize(cfg, opt, az, opt.el_deg, rng);
+        Summary s;
+        runLocalizer(cfg, ch, true, truthDirection(opt, az, opt.el_deg), s);
+        std::cout << "[Bench] az=" << az << " el=" << opt.el_deg
+                  << " snr=" << opt.snr_db << "dB rt60=" << opt.rt60_s << "s" << std::endl;
+        printAccuracy(s, true);
+        all.frames.insert(all.frames.end(), s.frames.begin(), s.frames.end());
+        all.frame_us.insert(all.frame_us.end(), s.frame_us.begin(), s.frame_us.end());
+        all.failed += s.failed;
+    }
+
+    std::cout << "[Bench] overall (" << angles.size() << " angle(s))" << std::endl;
+    printAccuracy(all, true);
+    printCalibration(all);
+    printTiming(all, cfg);
+
+    if (opt.beamform) {
+        for (float az : angles) benchBeamformer(cfg, opt, az, rng);
+    }
+
+    if (opt.workers >= 0) {
+        // 同一段信号分别以单线程与线程池运行，对比每帧耗时
+        const auto ch = synthesize(cfg, opt, angles.front(), opt.el_deg, rng);
+        const Vec3 truth = truthDirection(opt, angles.front(), opt.el_deg);
+        MicArrayConfig serial_cfg = cfg;
+        serial_cfg.parallel_workers = 0;
+        MicArrayConfig pool_cfg = cfg;
+        pool_cfg.parallel_workers = static_cast<uint32_t>(opt.workers);
+        Summary serial, pooled;
+        runLocalizer(serial_cfg, ch, true, truth, serial);
+        runLocalizer(pool_cfg, ch, true, truth, pooled);
+        const double t_serial = meanUs(serial);
+        const double t_pool = meanUs(pooled);
+        std::cout << "[Bench] parallel: hw_threads=" << std::thread::hardware_concurrency()
+                  << " serial=" << t_serial << "us workers=" << opt.workers << ": " << t_pool
+                  << "us speedup=" << (t_pool > 0.0 ? t_serial / t_pool : 0.0) << "x" << std::endl;
+    }
+    return 0;
+}
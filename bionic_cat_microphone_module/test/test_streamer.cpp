@@ -104,8 +104,16 @@ int main(int argc, char** argv) {
         if (secs > 0 && elapsed >= secs) break;
     }
 
+    const StreamerStats st = streamer.stats();
     streamer.stop();
     ofs.flush();
+    std::cout << "Stats: periods=" << st.periods_captured
+              << ", xruns=" << st.capture_xruns
+              << ", encode_drops=" << st.encode_queue_drops
+              << ", encode_hw=" << st.encode_queue_high_water << "/" << st.queue_capacity
+              << ", frames=" << st.frames_encoded
+              << ", encode_us avg/max=" << st.encode_us_avg << "/" << st.encode_us_max
+              << " (period " << st.period_us << "us)" << std::endl;
     ofs.close();
 
     std::cout << "Done. frames=" << totalFrames.load()
@@ -243,13 +243,24 @@ struct EyeballDispalyCommand
     bool enable_tracking; // 是否使能追踪
 };
 
+// 音频播放方式
+enum class AudioPlayMode : uint8_t {
+    REPLACE = 0,     // 停止正在播放的声音后播放（旧行为），排队中未执行的指令一并作废
+    MIX = 1,         // 与正在播放的声音叠加混音
+    ENQUEUE = 2,     // 排队，等正在播放的声音全部结束后再播放
+    DROP_IF_BUSY = 3 // 轮到它时若有声音在播放则丢弃
+};
+
 struct AudioPlayCommand
 {
     Header header;
-    std::string file_path;
+    std::string file_path;  // 为空表示停止全部声音
     float speed;
     float volume;
     bool loop;
+    AudioPlayMode mode = AudioPlayMode::REPLACE; // 末尾追加字段，旧消息缺省为 REPLACE
+    uint8_t priority = 0;                        // 声部用满时可抢占、REPLACE 可停止优先级不高于它的声部；排队时高优先级先执行
+    int64_t start_at_ns = 0;                     // 扬声器板 CLOCK_MONOTONIC 的出声时刻（纳秒），0 表示立即播放
 };
 
 struct LedControlMsg
@@ -320,15 +331,21 @@ struct ActionGroupExecuteCommand
 
 
 // 流开始/配置（便于订阅端建立解码器与缓存）
+// 音频流编码格式
+enum class AudioCodec : uint8_t {
+    AAC_ADTS = 0,   // AAC，每帧带 ADTS 头
+    OPUS = 1        // Opus 原始包（每个数据包一帧，无封装）
+};
+
 struct AdtsStreamControlMsg {
     Header header;
     // uint32_t stream_id = 0;                // 流唯一ID（同一设备内）
-    bool is_start = true;               // true=开始，false=结束    
-    //AudioCodec codec = AudioCodec::AAC_ADTS;
+    bool is_start = true;               // true=开始，false=结束；流进行中再次收到 true 表示参数变更（如自适应码率）
     uint32_t sample_rate = 48000;          // 采样率
     uint8_t channels = 1;                  // 声道数
     uint32_t bit_rate = 64000;             // 目标码率（可选）
     uint8_t aot = 2;                       // AAC 对象类型：2=LC，与 FDK AOT_AAC_LC 对齐
+    AudioCodec codec = AudioCodec::AAC_ADTS; // 编码格式（末尾追加字段，旧消息缺省为 AAC）
 };
 
 // 数据分片：每个 MQTT 包携带若干 ADTS 帧，或某一帧的一个分片
@@ -344,12 +361,81 @@ struct AdtsStreamDataMsg {
     std::vector<uint8_t> payload;           // 原始 ADTS 字节（可含多帧或分片）
 };
 
+// 多声源跟踪输出的单个声源
+struct SoundSourceTrack {
+    uint32_t track_id = 0;         // 轨迹ID（同一声源持续不变）
+    float azimuth_deg = 0.0f;
+    float elevation_deg = 0.0f;
+    float azimuth_rate_dps = 0.0f; // 方位角变化率，度/秒
+    float confidence = 0.0f;       // 轨迹置信度，范围0.0-1.0
+    uint32_t age_ms = 0;           // 轨迹存活时长
+};
+
 struct SoundLocalizationMsg {
     Header header;
-    float azimuth_deg = 0.0f;    // 声源方位角，单位度
+    float azimuth_deg = 0.0f;    // 声源方位角，单位度（启用跟踪时为最强轨迹）
     float elevation_deg = 0.0f;  // 声源仰俯角，单位度
     float confidence = 0.0f;     // 置信度，范围0.0-1.0
     float loudness[4] = {0.0f};        // 声源响度，单位分贝 ,采用dBFS标准
+    std::vector<SoundSourceTrack> sources; // 当前活跃声源（未启用跟踪时为空）
+};
+
+// 声源定位配置热更新：携带完整 YAML 文本（格式同 custom_3d_mic_config.yaml）
+struct LocalizationConfigMsg {
+    Header header;
+    std::string yaml_text;
+};
+
+// 麦克风采集/编码/定位流水线统计（周期发布）
+// 计数为开流以来累计；high_water 与耗时统计只覆盖本周期（window_ms）
+struct MicrophoneStreamStatsMsg {
+    Header header;
+    uint32_t window_ms = 0;                 // 本统计周期时长
+    uint64_t periods_captured = 0;          // 已采集 period 数
+    uint64_t capture_xruns = 0;             // 采集溢出（数据丢失）次数
+    uint32_t queue_capacity = 0;            // 编码/定位队列容量（period）
+    uint64_t encode_queue_drops = 0;        // 编码队列满丢弃的 period 数
+    uint64_t localize_queue_drops = 0;      // 定位队列满丢弃的 period 数
+    uint32_t encode_queue_high_water = 0;   // 本周期编码队列最大深度
+    uint32_t localize_queue_high_water = 0; // 本周期定位队列最大深度
+    uint64_t frames_encoded = 0;            // 已编码帧数
+    float encode_us_avg = 0.0f;             // 单帧编码耗时（微秒）
+    float encode_us_max = 0.0f;
+    uint64_t periods_localized = 0;         // 已定位 period 数
+    float localize_us_avg = 0.0f;           // 单 period 定位耗时（微秒）
+    float localize_us_max = 0.0f;
+    float period_us = 0.0f;                 // 一个 period 的时长，即各阶段的实时预算
+    uint32_t bit_rate = 0;                  // 当前编码码率
+    uint32_t publish_in_flight = 0;         // 数据包 MQTT 在途数
+    uint64_t publish_dropped = 0;           // 发布侧丢弃的数据包
+    float input_dbfs = -120.0f;             // 本周期 ch0 单个 period 的 RMS 电平最大值（dBFS）
+};
+
+// 固定桶直方图：第 i 桶计入 (upper[i-1], upper[i]] 的样本，最后一桶计入大于 upper.back() 的样本
+struct PlaybackHistogram {
+    uint64_t count = 0;
+    float avg = 0.0f;
+    uint32_t max = 0;
+    std::vector<uint32_t> upper;   // 桶上界
+    std::vector<uint64_t> buckets; // upper.size() + 1 个
+};
+
+// 扬声器播放统计（周期发布）
+// 计数为节点启动以来累计；直方图只覆盖本周期（window_ms）
+struct SpeakerPlaybackStatsMsg {
+    Header header;
+    uint32_t window_ms = 0;             // 本统计周期时长
+    uint8_t output = 0;                 // 当前输出：0 空闲，1 混音器，2 流播放
+    uint64_t device_opens = 0;          // pcm_open 成功次数
+    uint64_t device_open_failures = 0;
+    uint64_t periods_written = 0;       // 成功写入设备的周期数
+    uint64_t xruns = 0;                 // pcm_write 返回 -EPIPE 的次数
+    uint64_t underruns = 0;             // 数据源跟不上、补静音的周期数
+    float period_us = 0.0f;             // 当前输出一个周期的时长，即写入耗时的实时预算
+    PlaybackHistogram device_open_us;   // pcm_open 耗时（微秒）
+    PlaybackHistogram first_write_us;   // 播放请求/首包 → 首个周期写入设备（微秒）
+    PlaybackHistogram write_us;         // 每周期 pcm_write 耗时（含等待设备空间，微秒）
+    PlaybackHistogram buffer_fill_pct;  // 写入前设备缓冲中待播帧占缓冲的百分比
 };
 
 }  // namespace mqttMsgs
@@ -36,15 +36,22 @@ using ::BionicCat::MqttMsgs::LLMEmotionIntention;
 using ::BionicCat::MqttMsgs::VisualFeatureFrame;
 using ::BionicCat::MqttMsgs::EyeballDispalyCommand;
 using ::BionicCat::MqttMsgs::AudioPlayCommand;
+using ::BionicCat::MqttMsgs::AudioPlayMode;
 using ::BionicCat::MqttMsgs::LedControlMsg;
 using ::BionicCat::MqttMsgs::MotorControllerType;
 using ::BionicCat::MqttMsgs::MotorControllerConfig;
 using ::BionicCat::MqttMsgs::ActionGroupExecuteCommand;
 using ::BionicCat::MqttMsgs::AdtsStreamControlMsg;
 using ::BionicCat::MqttMsgs::AdtsStreamDataMsg;
+using ::BionicCat::MqttMsgs::AudioCodec;
 using ::BionicCat::MqttMsgs::SystemStatInfo;
 using ::BionicCat::MqttMsgs::ButtonStatusEventMsg;
 using ::BionicCat::MqttMsgs::SoundLocalizationMsg; // 新增
+using ::BionicCat::MqttMsgs::SoundSourceTrack;
+using ::BionicCat::MqttMsgs::LocalizationConfigMsg;
+using ::BionicCat::MqttMsgs::MicrophoneStreamStatsMsg;
+using ::BionicCat::MqttMsgs::PlaybackHistogram;
+using ::BionicCat::MqttMsgs::SpeakerPlaybackStatsMsg;
 
 /**
  * @brief Binary serializer/deserializer utilities (big-endian)
@@ -766,7 +773,8 @@ public:
     // --------- AUDIO_PLAY_COMMAND ---------
     /** 
      * @brief Serialize AudioPlayCommand
-     * Field order: Header, file_path(string), speed(float), volume(float), loop(u8)
+     * Field order: Header, file_path(string), speed(float), volume(float), loop(u8), mode(u8), priority(u8),
+     *              start_at_ns(i64)
      */
     static std::vector<uint8_t> serializeAudioPlayCommand(const AudioPlayCommand& m) {
         std::vector<uint8_t> buf;
@@ -775,6 +783,9 @@ public:
         serializeFloat(buf, m.speed);
         serializeFloat(buf, m.volume);
         serializeUInt8(buf, static_cast<uint8_t>(m.loop ? 1 : 0));
+        serializeUInt8(buf, static_cast<uint8_t>(m.mode));
+        serializeUInt8(buf, m.priority);
+        serializeInt64(buf, m.start_at_ns);
         return buf;
     }
     
@@ -788,6 +799,15 @@ public:
         m.speed = deserializeFloat(data, off, size);
         m.volume = deserializeFloat(data, off, size);
         m.loop = (deserializeUInt8(data, off, size) != 0);
+        // 旧版本消息不含 mode/priority，按 REPLACE、优先级 0 处理
+        if (off < size) {
+            m.mode = static_cast<AudioPlayMode>(deserializeUInt8(data, off, size));
+            m.priority = deserializeUInt8(data, off, size);
+        }
+        // 旧版本消息不含 start_at_ns，立即播放
+        if (off < size) {
+            m.start_at_ns = deserializeInt64(data, off, size);
+        }
         
         return m;
     }
@@ -979,7 +999,7 @@ public:
     // ---------------- ADTS STREAM ----------------
     /**
      * @brief Serialize AdtsStreamControlMsg
-     * Field order: Header, is_start(u8), sample_rate(i32), channels(u8), bit_rate(i32), aot(u8)
+     * Field order: Header, is_start(u8), sample_rate(i32), channels(u8), bit_rate(i32), aot(u8), codec(u8)
      */
     static std::vector<uint8_t> serializeAdtsStreamControl(const AdtsStreamControlMsg& m) {
         std::vector<uint8_t> buf;
@@ -989,6 +1009,7 @@ public:
         serializeUInt8(buf, m.channels);
         serializeInt32(buf, static_cast<int32_t>(m.bit_rate));
         serializeUInt8(buf, m.aot);
+        serializeUInt8(buf, static_cast<uint8_t>(m.codec));
         return buf;
     }
 
@@ -1002,6 +1023,10 @@ public:
         m.channels = deserializeUInt8(data, off, size);
         m.bit_rate = static_cast<uint32_t>(deserializeInt32(data, off, size));
         m.aot = deserializeUInt8(data, off, size);
+        // 旧版本消息不含 codec，按 AAC 处理
+        if (off < size) {
+            m.codec = static_cast<AudioCodec>(deserializeUInt8(data, off, size));
+        }
         return m;
     }
 
@@ -1011,14 +1036,25 @@ public:
      */
     static std::vector<uint8_t> serializeAdtsStreamData(const AdtsStreamDataMsg& m) {
         std::vector<uint8_t> buf;
+        const uint32_t plen = static_cast<uint32_t>(m.payload.size());
+        serializeAdtsStreamDataPrefix(buf, m, plen);
+        buf.insert(buf.end(), m.payload.begin(), m.payload.end());
+        return buf;
+    }
+
+    /**
+     * @brief Append the AdtsStreamDataMsg fields that precede the payload bytes
+     * Field order: Header, seq(i32), pts_ms(i64), frame_count(i16), payload_len(i32)
+     * m.payload is ignored; the caller places payload_len bytes right after the prefix
+     * (e.g. in the headroom of an existing buffer) to avoid copying the payload.
+     */
+    static void serializeAdtsStreamDataPrefix(std::vector<uint8_t>& buf, const AdtsStreamDataMsg& m,
+                                              uint32_t payload_len) {
         serializeHeader(buf, m.header);
         serializeInt32(buf, static_cast<int32_t>(m.seq));
         serializeInt64(buf, static_cast<int64_t>(m.pts_ms));
         serializeInt16(buf, static_cast<int16_t>(m.frame_count));
-        const uint32_t plen = static_cast<uint32_t>(m.payload.size());
-        serializeInt32(buf, static_cast<int32_t>(plen));
-        buf.insert(buf.end(), m.payload.begin(), m.payload.end());
-        return buf;
+        serializeInt32(buf, static_cast<int32_t>(payload_len));
     }
 
     /** @brief Deserialize AdtsStreamDataMsg */
@@ -1077,7 +1113,9 @@ public:
     // ---------------- SOUND LOCALIZATION ----------------
     /**
      * Serialize SoundLocalizationMsg
-     * Field order: Header, azimuth_deg(float), elevation_deg(float), confidence(float), loudness(float)
+     * Field order: Header, azimuth_deg(float), elevation_deg(float), confidence(float), loudness[4](float),
+     *              source_count(i32), sources[](track_id(i32), azimuth_deg, elevation_deg,
+     *              azimuth_rate_dps, confidence(float), age_ms(i32))
      */
     static std::vector<uint8_t> serializeSoundLocalization(const SoundLocalizationMsg& m) {
         std::vector<uint8_t> buf;
@@ -1088,6 +1126,15 @@ public:
         for(float val : m.loudness){
             serializeFloat(buf, val);
         }
+        serializeInt32(buf, static_cast<int32_t>(m.sources.size()));
+        for (const auto& src : m.sources) {
+            serializeInt32(buf, static_cast<int32_t>(src.track_id));
+            serializeFloat(buf, src.azimuth_deg);
+            serializeFloat(buf, src.elevation_deg);
+            serializeFloat(buf, src.azimuth_rate_dps);
+            serializeFloat(buf, src.confidence);
+            serializeInt32(buf, static_cast<int32_t>(src.age_ms));
+        }
         return buf;
     }
 
@@ -1104,6 +1151,184 @@ public:
         for(auto& val : m.loudness){
             val = deserializeFloat(data, off, size);
         }
+        // 旧版本消息不含声源列表
+        if (off < size) {
+            int32_t count = deserializeInt32(data, off, size);
+            // 每条声源 24 字节：先按剩余长度检查，畸形包不会在越界检查之前申请巨量内存
+            if (count < 0 || static_cast<size_t>(count) > (size - off) / 24) {
+                throw std::runtime_error("Invalid SoundLocalization source count");
+            }
+            m.sources.reserve(static_cast<size_t>(count));
+            for (int32_t i = 0; i < count; ++i) {
+                SoundSourceTrack src{};
+                src.track_id = static_cast<uint32_t>(deserializeInt32(data, off, size));
+                src.azimuth_deg = deserializeFloat(data, off, size);
+                src.elevation_deg = deserializeFloat(data, off, size);
+                src.azimuth_rate_dps = deserializeFloat(data, off, size);
+                src.confidence = deserializeFloat(data, off, size);
+                src.age_ms = static_cast<uint32_t>(deserializeInt32(data, off, size));
+                m.sources.push_back(src);
+            }
+        }
+        return m;
+    }
+
+    /**
+     * Serialize LocalizationConfigMsg
+     * Field order: Header, yaml_text(string)
+     */
+    static std::vector<uint8_t> serializeLocalizationConfig(const LocalizationConfigMsg& m) {
+        std::vector<uint8_t> buf;
+        serializeHeader(buf, m.header);
+        serializeString(buf, m.yaml_text);
+        return buf;
+    }
+
+    /** @brief Deserialize LocalizationConfigMsg */
+    static LocalizationConfigMsg deserializeLocalizationConfig(const uint8_t* data, size_t size) {
+        LocalizationConfigMsg m{};
+        size_t off = 0;
+        m.header = deserializeHeader(data, off, size);
+        m.yaml_text = deserializeString(data, off, size);
+        return m;
+    }
+
+    /**
+     * Serialize MicrophoneStreamStatsMsg
+     * Field order: Header, window_ms(i32), periods_captured(i64), capture_xruns(i64), queue_capacity(i32),
+     *              encode_queue_drops(i64), localize_queue_drops(i64), encode_queue_high_water(i32),
+     *              localize_queue_high_water(i32), frames_encoded(i64), encode_us_avg(f32), encode_us_max(f32),
+     *              periods_localized(i64), localize_us_avg(f32), localize_us_max(f32), period_us(f32),
+     *              bit_rate(i32), publish_in_flight(i32), publish_dropped(i64), input_dbfs(f32, 可选)
+     */
+    static std::vector<uint8_t> serializeMicrophoneStreamStats(const MicrophoneStreamStatsMsg& m) {
+        std::vector<uint8_t> buf;
+        serializeHeader(buf, m.header);
+        serializeInt32(buf, static_cast<int32_t>(m.window_ms));
+        serializeInt64(buf, static_cast<int64_t>(m.periods_captured));
+        serializeInt64(buf, static_cast<int64_t>(m.capture_xruns));
+        serializeInt32(buf, static_cast<int32_t>(m.queue_capacity));
+        serializeInt64(buf, static_cast<int64_t>(m.encode_queue_drops));
+        serializeInt64(buf, static_cast<int64_t>(m.localize_queue_drops));
+        serializeInt32(buf, static_cast<int32_t>(m.encode_queue_high_water));
+        serializeInt32(buf, static_cast<int32_t>(m.localize_queue_high_water));
+        serializeInt64(buf, static_cast<int64_t>(m.frames_encoded));
+        serializeFloat(buf, m.encode_us_avg);
+        serializeFloat(buf, m.encode_us_max);
+        serializeInt64(buf, static_cast<int64_t>(m.periods_localized));
+        serializeFloat(buf, m.localize_us_avg);
+        serializeFloat(buf, m.localize_us_max);
+        serializeFloat(buf, m.period_us);
+        serializeInt32(buf, static_cast<int32_t>(m.bit_rate));
+        serializeInt32(buf, static_cast<int32_t>(m.publish_in_flight));
+        serializeInt64(buf, static_cast<int64_t>(m.publish_dropped));
+        serializeFloat(buf, m.input_dbfs);
+        return buf;
+    }
+
+    /** @brief Deserialize MicrophoneStreamStatsMsg */
+    static MicrophoneStreamStatsMsg deserializeMicrophoneStreamStats(const uint8_t* data, size_t size) {
+        MicrophoneStreamStatsMsg m{};
+        size_t off = 0;
+        m.header = deserializeHeader(data, off, size);
+        m.window_ms = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.periods_captured = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.capture_xruns = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.queue_capacity = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.encode_queue_drops = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.localize_queue_drops = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.encode_queue_high_water = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.localize_queue_high_water = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.frames_encoded = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.encode_us_avg = deserializeFloat(data, off, size);
+        m.encode_us_max = deserializeFloat(data, off, size);
+        m.periods_localized = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.localize_us_avg = deserializeFloat(data, off, size);
+        m.localize_us_max = deserializeFloat(data, off, size);
+        m.period_us = deserializeFloat(data, off, size);
+        m.bit_rate = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.publish_in_flight = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.publish_dropped = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        // 旧版本消息不含输入电平
+        if (off < size) {
+            m.input_dbfs = deserializeFloat(data, off, size);
+        }
+        return m;
+    }
+
+    /**
+     * Serialize PlaybackHistogram
+     * Field order: count(i64), avg(f32), max(i32), bound_count(i32), upper[](i32), buckets[bound_count + 1](i64)
+     */
+    static void serializePlaybackHistogram(std::vector<uint8_t>& buf, const PlaybackHistogram& h) {
+        serializeInt64(buf, static_cast<int64_t>(h.count));
+        serializeFloat(buf, h.avg);
+        serializeInt32(buf, static_cast<int32_t>(h.max));
+        serializeInt32(buf, static_cast<int32_t>(h.upper.size()));
+        for (uint32_t u : h.upper) serializeInt32(buf, static_cast<int32_t>(u));
+        for (size_t i = 0; i <= h.upper.size(); ++i) {
+            serializeInt64(buf, static_cast<int64_t>(i < h.buckets.size() ? h.buckets[i] : 0));
+        }
+    }
+
+    static PlaybackHistogram deserializePlaybackHistogram(const uint8_t* data, size_t& off, size_t size) {
+        PlaybackHistogram h{};
+        h.count = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        h.avg = deserializeFloat(data, off, size);
+        h.max = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        int32_t bounds = deserializeInt32(data, off, size);
+        // 每个上界 4 字节、每个桶 8 字节：先按剩余长度检查，畸形包不会在越界检查之前申请巨量内存
+        if (bounds < 0 || static_cast<size_t>(bounds) > (size - off) / 12) {
+            throw std::runtime_error("Invalid PlaybackHistogram bucket count");
+        }
+        h.upper.reserve(static_cast<size_t>(bounds));
+        for (int32_t i = 0; i < bounds; ++i) h.upper.push_back(static_cast<uint32_t>(deserializeInt32(data, off, size)));
+        h.buckets.reserve(static_cast<size_t>(bounds) + 1);
+        for (int32_t i = 0; i <= bounds; ++i) h.buckets.push_back(static_cast<uint64_t>(deserializeInt64(data, off, size)));
+        return h;
+    }
+
+    /**
+     * Serialize SpeakerPlaybackStatsMsg
+     * Field order: Header, window_ms(i32), output(u8), device_opens(i64), device_open_failures(i64),
+     *              periods_written(i64), xruns(i64), underruns(i64), period_us(f32),
+     *              device_open_us, first_write_us, write_us, buffer_fill_pct(PlaybackHistogram)
+     */
+    static std::vector<uint8_t> serializeSpeakerPlaybackStats(const SpeakerPlaybackStatsMsg& m) {
+        std::vector<uint8_t> buf;
+        serializeHeader(buf, m.header);
+        serializeInt32(buf, static_cast<int32_t>(m.window_ms));
+        serializeUInt8(buf, m.output);
+        serializeInt64(buf, static_cast<int64_t>(m.device_opens));
+        serializeInt64(buf, static_cast<int64_t>(m.device_open_failures));
+        serializeInt64(buf, static_cast<int64_t>(m.periods_written));
+        serializeInt64(buf, static_cast<int64_t>(m.xruns));
+        serializeInt64(buf, static_cast<int64_t>(m.underruns));
+        serializeFloat(buf, m.period_us);
+        serializePlaybackHistogram(buf, m.device_open_us);
+        serializePlaybackHistogram(buf, m.first_write_us);
+        serializePlaybackHistogram(buf, m.write_us);
+        serializePlaybackHistogram(buf, m.buffer_fill_pct);
+        return buf;
+    }
+
+    /** @brief Deserialize SpeakerPlaybackStatsMsg */
+    static SpeakerPlaybackStatsMsg deserializeSpeakerPlaybackStats(const uint8_t* data, size_t size) {
+        SpeakerPlaybackStatsMsg m{};
+        size_t off = 0;
+        m.header = deserializeHeader(data, off, size);
+        m.window_ms = static_cast<uint32_t>(deserializeInt32(data, off, size));
+        m.output = deserializeUInt8(data, off, size);
+        m.device_opens = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.device_open_failures = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.periods_written = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.xruns = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.underruns = static_cast<uint64_t>(deserializeInt64(data, off, size));
+        m.period_us = deserializeFloat(data, off, size);
+        m.device_open_us = deserializePlaybackHistogram(data, off, size);
+        m.first_write_us = deserializePlaybackHistogram(data, off, size);
+        m.write_us = deserializePlaybackHistogram(data, off, size);
+        m.buffer_fill_pct = deserializePlaybackHistogram(data, off, size);
         return m;
     }
 };
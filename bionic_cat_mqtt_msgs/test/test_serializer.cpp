@@ -1,12 +1,10 @@
 #include "serializer.hpp"
-#include "alarm_mqtt_msg.hpp"
 #include <iostream>
 #include <chrono>
 #include <cstring>
 #include <cmath>
 #include <iomanip>
-
-using namespace waterworld::alarm;
+#include <limits>
 
 // ANSI color codes
 #define COLOR_GREEN "\033[32m"
@@ -30,6 +28,13 @@ void printTestResult(const std::string& test_name, bool passed) {
     }
 }
 
+// 以下为沿用的 waterworld 告警消息用例，需要 alarm_mqtt_msg.hpp 才能编译
+#if __has_include("alarm_mqtt_msg.hpp")
+#include "alarm_mqtt_msg.hpp"
+#define HAVE_ALARM_MSGS 1
+
+using namespace waterworld::alarm;
+
 // Test Header serialization/deserialization
 bool testHeader() {
     Header original;
@@ -698,6 +703,307 @@ bool testFieldCompleteness() {
     
     return all_passed;
 }
+#endif // __has_include("alarm_mqtt_msg.hpp")
+
+// ==================== BionicCat 消息用例 ====================
+// 放在独立命名空间中，避免与上面的 waterworld 消息类型重名
+namespace bionic_cat_tests {
+
+using namespace BionicCat::MqttMsgs;
+namespace bcs = BionicCat::MsgsSerializer;
+
+static Header makeHeader(const std::string& frame_id) {
+    Header h;
+    h.frame_id = frame_id;
+    h.device_id = "catlink_b";
+    h.timestamp = 1729358400123456LL;
+    return h;
+}
+
+static bool sameHeader(const Header& a, const Header& b) {
+    return a.frame_id == b.frame_id && a.device_id == b.device_id && a.timestamp == b.timestamp;
+}
+
+// 截断到 len 字节后期望解析抛异常（字段被截在中间）
+template <typename Fn>
+static bool throwsWhenCut(const std::vector<uint8_t>& buf, size_t len, Fn deserialize) {
+    try {
+        deserialize(buf.data(), len);
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+static AudioPlayCommand makePlayCommand() {
+    AudioPlayCommand m{};
+    m.header = makeHeader("audio_play");
+    m.file_path = "/opt/sounds/meow.wav";
+    m.speed = 1.25f;
+    m.volume = 0.5f;
+    m.loop = true;
+    m.mode = AudioPlayMode::DROP_IF_BUSY;
+    m.priority = 7;
+    m.start_at_ns = 1234567890123LL;
+    return m;
+}
+
+// Test AudioPlayCommand round trip including trailing mode/priority/start_at_ns
+bool testAudioPlayCommand() {
+    AudioPlayCommand original = makePlayCommand();
+    std::vector<uint8_t> buf = bcs::Serializer::serializeAudioPlayCommand(original);
+    AudioPlayCommand d = bcs::Serializer::deserializeAudioPlayCommand(buf.data(), buf.size());
+
+    return sameHeader(original.header, d.header) &&
+           d.file_path == original.file_path &&
+           d.speed == original.speed &&
+           d.volume == original.volume &&
+           d.loop == original.loop &&
+           d.mode == original.mode &&
+           d.priority == original.priority &&
+           d.start_at_ns == original.start_at_ns;
+}
+
+// 旧版本发送端：loop 之后没有 mode/priority，或 priority 之后没有 start_at_ns
+bool testAudioPlayCommandOldSenders() {
+    bool all_passed = true;
+    AudioPlayCommand original = makePlayCommand();
+    std::vector<uint8_t> buf = bcs::Serializer::serializeAudioPlayCommand(original);
+    const size_t full_len = buf.size();
+    const size_t no_start_len = full_len - 8;    // 不含 start_at_ns(i64)
+    const size_t no_mode_len = no_start_len - 2; // 不含 mode(u8)、priority(u8)
+
+    {
+        AudioPlayCommand d = bcs::Serializer::deserializeAudioPlayCommand(buf.data(), no_mode_len);
+        bool passed = d.file_path == original.file_path && d.loop == original.loop &&
+                      d.mode == AudioPlayMode::REPLACE && d.priority == 0 && d.start_at_ns == 0;
+        printTestResult("  AudioPlayCommand: payload without mode/priority/start_at_ns", passed);
+        all_passed &= passed;
+    }
+
+    {
+        AudioPlayCommand d = bcs::Serializer::deserializeAudioPlayCommand(buf.data(), no_start_len);
+        bool passed = d.mode == original.mode && d.priority == original.priority && d.start_at_ns == 0;
+        printTestResult("  AudioPlayCommand: payload without start_at_ns", passed);
+        all_passed &= passed;
+    }
+
+    {
+        auto fn = [](const uint8_t* data, size_t size) { bcs::Serializer::deserializeAudioPlayCommand(data, size); };
+        bool passed = throwsWhenCut(buf, no_mode_len + 1, fn) &&
+                      throwsWhenCut(buf, full_len - 4, fn);
+        printTestResult("  AudioPlayCommand: payload cut inside a trailing field throws", passed);
+        all_passed &= passed;
+    }
+
+    return all_passed;
+}
+
+// Test SoundLocalizationMsg with source list, old payload without it, and a malformed count
+bool testSoundLocalization() {
+    bool all_passed = true;
+    SoundLocalizationMsg original{};
+    original.header = makeHeader("sound_localization");
+    original.azimuth_deg = -42.5f;
+    original.elevation_deg = 12.0f;
+    original.confidence = 0.83f;
+    for (int i = 0; i < 4; ++i) original.loudness[i] = -30.0f - i;
+    for (uint32_t i = 0; i < 3; ++i) {
+        SoundSourceTrack t;
+        t.track_id = 100 + i;
+        t.azimuth_deg = 10.0f * i - 90.0f;
+        t.elevation_deg = 5.0f * i;
+        t.azimuth_rate_dps = -3.5f * i;
+        t.confidence = 0.9f - 0.1f * i;
+        t.age_ms = 1500 * i;
+        original.sources.push_back(t);
+    }
+    std::vector<uint8_t> buf = bcs::Serializer::serializeSoundLocalization(original);
+
+    {
+        SoundLocalizationMsg d = bcs::Serializer::deserializeSoundLocalization(buf.data(), buf.size());
+        bool passed = sameHeader(original.header, d.header) &&
+                      d.azimuth_deg == original.azimuth_deg &&
+                      d.elevation_deg == original.elevation_deg &&
+                      d.confidence == original.confidence &&
+                      std::memcmp(d.loudness, original.loudness, sizeof(d.loudness)) == 0 &&
+                      d.sources.size() == original.sources.size();
+        for (size_t i = 0; passed && i < d.sources.size(); ++i) {
+            const SoundSourceTrack& a = original.sources[i];
+            const SoundSourceTrack& b = d.sources[i];
+            passed = a.track_id == b.track_id && a.azimuth_deg == b.azimuth_deg &&
+                     a.elevation_deg == b.elevation_deg && a.azimuth_rate_dps == b.azimuth_rate_dps &&
+                     a.confidence == b.confidence && a.age_ms == b.age_ms;
+        }
+        printTestResult("  SoundLocalizationMsg: round trip with 3 sources", passed);
+        all_passed &= passed;
+    }
+
+    // 旧版本消息在 loudness 之后结束
+    const size_t old_len = buf.size() - 4 - 24 * original.sources.size();
+    {
+        SoundLocalizationMsg d = bcs::Serializer::deserializeSoundLocalization(buf.data(), old_len);
+        bool passed = d.confidence == original.confidence &&
+                      d.loudness[3] == original.loudness[3] && d.sources.empty();
+        printTestResult("  SoundLocalizationMsg: payload without source list", passed);
+        all_passed &= passed;
+    }
+
+    {
+        // 声源数改成 INT32_MAX：必须在申请内存之前被拒绝
+        std::vector<uint8_t> bad(buf.begin(), buf.begin() + old_len);
+        bcs::Serializer::serializeInt32(bad, std::numeric_limits<int32_t>::max());
+        auto fn = [](const uint8_t* data, size_t size) { bcs::Serializer::deserializeSoundLocalization(data, size); };
+        bool passed = throwsWhenCut(bad, bad.size(), fn) && throwsWhenCut(buf, buf.size() - 1, fn);
+        printTestResult("  SoundLocalizationMsg: malformed source count / truncated source throws", passed);
+        all_passed &= passed;
+    }
+
+    return all_passed;
+}
+
+// Test LocalizationConfigMsg round trip
+bool testLocalizationConfig() {
+    LocalizationConfigMsg original{};
+    original.header = makeHeader("localization_config");
+    original.yaml_text = "mic_array:\n  sample_rate: 48000\n  min_confidence: 0.35\n";
+    std::vector<uint8_t> buf = bcs::Serializer::serializeLocalizationConfig(original);
+    LocalizationConfigMsg d = bcs::Serializer::deserializeLocalizationConfig(buf.data(), buf.size());
+    return sameHeader(original.header, d.header) && d.yaml_text == original.yaml_text;
+}
+
+// Test MicrophoneStreamStatsMsg round trip and the payload without input_dbfs
+bool testMicrophoneStreamStats() {
+    bool all_passed = true;
+    MicrophoneStreamStatsMsg original{};
+    original.header = makeHeader("microphone_stats");
+    original.window_ms = 5000;
+    original.periods_captured = 0x1122334455ULL;
+    original.capture_xruns = 3;
+    original.queue_capacity = 64;
+    original.encode_queue_drops = 11;
+    original.localize_queue_drops = 12;
+    original.encode_queue_high_water = 40;
+    original.localize_queue_high_water = 41;
+    original.frames_encoded = 987654;
+    original.encode_us_avg = 812.5f;
+    original.encode_us_max = 2400.0f;
+    original.periods_localized = 123456;
+    original.localize_us_avg = 1500.25f;
+    original.localize_us_max = 6100.0f;
+    original.period_us = 21333.3f;
+    original.bit_rate = 48000;
+    original.publish_in_flight = 5;
+    original.publish_dropped = 2;
+    original.input_dbfs = -23.5f;
+    std::vector<uint8_t> buf = bcs::Serializer::serializeMicrophoneStreamStats(original);
+
+    auto same = [&](const MicrophoneStreamStatsMsg& d) {
+        return sameHeader(original.header, d.header) &&
+               d.window_ms == original.window_ms && d.periods_captured == original.periods_captured &&
+               d.capture_xruns == original.capture_xruns && d.queue_capacity == original.queue_capacity &&
+               d.encode_queue_drops == original.encode_queue_drops &&
+               d.localize_queue_drops == original.localize_queue_drops &&
+               d.encode_queue_high_water == original.encode_queue_high_water &&
+               d.localize_queue_high_water == original.localize_queue_high_water &&
+               d.frames_encoded == original.frames_encoded &&
+               d.encode_us_avg == original.encode_us_avg && d.encode_us_max == original.encode_us_max &&
+               d.periods_localized == original.periods_localized &&
+               d.localize_us_avg == original.localize_us_avg && d.localize_us_max == original.localize_us_max &&
+               d.period_us == original.period_us && d.bit_rate == original.bit_rate &&
+               d.publish_in_flight == original.publish_in_flight &&
+               d.publish_dropped == original.publish_dropped;
+    };
+
+    {
+        MicrophoneStreamStatsMsg d = bcs::Serializer::deserializeMicrophoneStreamStats(buf.data(), buf.size());
+        bool passed = same(d) && d.input_dbfs == original.input_dbfs;
+        printTestResult("  MicrophoneStreamStatsMsg: round trip", passed);
+        all_passed &= passed;
+    }
+
+    {
+        // 旧版本消息不含 input_dbfs，保持缺省 -120 dBFS
+        MicrophoneStreamStatsMsg d = bcs::Serializer::deserializeMicrophoneStreamStats(buf.data(), buf.size() - 4);
+        bool passed = same(d) && d.input_dbfs == -120.0f;
+        printTestResult("  MicrophoneStreamStatsMsg: payload without input_dbfs", passed);
+        all_passed &= passed;
+    }
+
+    return all_passed;
+}
+
+static PlaybackHistogram makeHistogram(uint32_t scale) {
+    PlaybackHistogram h;
+    h.upper = {1 * scale, 2 * scale, 5 * scale, 10 * scale};
+    h.buckets = {4, 3, 2, 1, 7};
+    h.count = 17;
+    h.avg = 3.75f * scale;
+    h.max = 42 * scale;
+    return h;
+}
+
+static bool sameHistogram(const PlaybackHistogram& a, const PlaybackHistogram& b) {
+    return a.count == b.count && a.avg == b.avg && a.max == b.max &&
+           a.upper == b.upper && a.buckets == b.buckets;
+}
+
+// Test SpeakerPlaybackStatsMsg round trip and malformed histogram sizes
+bool testSpeakerPlaybackStats() {
+    bool all_passed = true;
+    SpeakerPlaybackStatsMsg original{};
+    original.header = makeHeader("speaker_stats");
+    original.window_ms = 10000;
+    original.output = 2;
+    original.device_opens = 4;
+    original.device_open_failures = 1;
+    original.periods_written = 0x0102030405ULL;
+    original.xruns = 6;
+    original.underruns = 9;
+    original.period_us = 10666.7f;
+    original.device_open_us = makeHistogram(1000);
+    original.first_write_us = makeHistogram(100);
+    original.write_us = makeHistogram(10);
+    original.buffer_fill_pct = makeHistogram(1);
+    original.buffer_fill_pct.upper.clear();
+    original.buffer_fill_pct.buckets = {5};
+    std::vector<uint8_t> buf = bcs::Serializer::serializeSpeakerPlaybackStats(original);
+
+    {
+        SpeakerPlaybackStatsMsg d = bcs::Serializer::deserializeSpeakerPlaybackStats(buf.data(), buf.size());
+        bool passed = sameHeader(original.header, d.header) &&
+                      d.window_ms == original.window_ms && d.output == original.output &&
+                      d.device_opens == original.device_opens &&
+                      d.device_open_failures == original.device_open_failures &&
+                      d.periods_written == original.periods_written &&
+                      d.xruns == original.xruns && d.underruns == original.underruns &&
+                      d.period_us == original.period_us &&
+                      sameHistogram(d.device_open_us, original.device_open_us) &&
+                      sameHistogram(d.first_write_us, original.first_write_us) &&
+                      sameHistogram(d.write_us, original.write_us) &&
+                      sameHistogram(d.buffer_fill_pct, original.buffer_fill_pct);
+        printTestResult("  SpeakerPlaybackStatsMsg: round trip with 4 histograms", passed);
+        all_passed &= passed;
+    }
+
+    {
+        // 只保留第一个直方图的 count/avg/max，再写入巨大的上界个数
+        PlaybackHistogram empty;
+        std::vector<uint8_t> tail;
+        bcs::Serializer::serializePlaybackHistogram(tail, empty);
+        std::vector<uint8_t> bad = bcs::Serializer::serializeSpeakerPlaybackStats(SpeakerPlaybackStatsMsg{});
+        bad.resize(bad.size() - 4 * tail.size() + 16);
+        bcs::Serializer::serializeInt32(bad, std::numeric_limits<int32_t>::max());
+        auto fn = [](const uint8_t* data, size_t size) { bcs::Serializer::deserializeSpeakerPlaybackStats(data, size); };
+        bool passed = throwsWhenCut(bad, bad.size(), fn) && throwsWhenCut(buf, buf.size() - 1, fn);
+        printTestResult("  SpeakerPlaybackStatsMsg: malformed bucket count / truncated histogram throws", passed);
+        all_passed &= passed;
+    }
+
+    return all_passed;
+}
+
+} // namespace bionic_cat_tests
 
 int main() {
     std::cout << COLOR_BLUE << "========================================" << COLOR_RESET << std::endl;
@@ -705,6 +1011,7 @@ int main() {
     std::cout << COLOR_BLUE << "========================================" << COLOR_RESET << std::endl;
     std::cout << std::endl;
     
+#ifdef HAVE_ALARM_MSGS
     // Run basic tests
     std::cout << COLOR_YELLOW << "Running basic serialization tests..." << COLOR_RESET << std::endl;
     printTestResult("Header serialization", testHeader());
@@ -726,6 +1033,15 @@ int main() {
     
     // Run performance tests
     performanceTestMMWaveData();
+#endif
+
+    std::cout << "\n" << COLOR_YELLOW << "Running BionicCat message tests..." << COLOR_RESET << std::endl;
+    printTestResult("AudioPlayCommand serialization", bionic_cat_tests::testAudioPlayCommand());
+    printTestResult("LocalizationConfigMsg serialization", bionic_cat_tests::testLocalizationConfig());
+    bionic_cat_tests::testAudioPlayCommandOldSenders();
+    bionic_cat_tests::testSoundLocalization();
+    bionic_cat_tests::testMicrophoneStreamStats();
+    bionic_cat_tests::testSpeakerPlaybackStats();
     
     // Print summary
     std::cout << "\n" << COLOR_BLUE << "========================================" << COLOR_RESET << std::endl;
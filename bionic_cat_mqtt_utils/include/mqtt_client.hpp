@@ -101,6 +101,21 @@ public:
  */
 class MQTTPublisher {
 private:
+    /**
+     * @brief Tracks completion of publishes sent via publishAsyncTracked()
+     */
+    class InFlightListener : public virtual mqtt::iaction_listener {
+    public:
+        explicit InFlightListener(std::atomic<size_t>& count) : count_(count) {}
+        void on_failure(const mqtt::token& /*tok*/) override { count_.fetch_sub(1); }
+        void on_success(const mqtt::token& /*tok*/) override { count_.fetch_sub(1); }
+    private:
+        std::atomic<size_t>& count_;
+    };
+
+    // Declared before client_ so the listener outlives any callback fired while the client shuts down
+    std::atomic<size_t> inFlight_{0};
+    InFlightListener inFlightListener_{inFlight_};
     mqtt::async_client client_;
     mqtt::connect_options connOpts_;
     std::string serverAddress_;
@@ -191,6 +206,40 @@ public:
         }
     }
 
+    /**
+     * @brief Publish a raw byte buffer to the specified topic
+     * Avoids building an intermediate std::string when the caller already
+     * holds the serialized bytes (e.g. pooled audio buffers).
+     * @param topic Topic to publish to
+     * @param payload Pointer to the message bytes
+     * @param len Number of bytes
+     * @param qos Quality of Service level (optional, uses default if not specified)
+     * @param retained Whether the message should be retained by the broker
+     * @return true if publish successful, false otherwise
+     */
+    bool publish(const std::string& topic,
+                 const void* payload,
+                 size_t len,
+                 int qos = -1,
+                 bool retained = false) {
+        try {
+            int actualQos = (qos < 0) ? defaultQos_ : qos;
+
+            auto msg = mqtt::make_message(topic, payload, len);
+            msg->set_qos(actualQos);
+            msg->set_retained(retained);
+
+            mqtt::token_ptr pubtok = client_.publish(msg);
+            pubtok->wait();
+
+            return true;
+        }
+        catch (const mqtt::exception& exc) {
+            std::cerr << "Error publishing: " << exc.what() << std::endl;
+            return false;
+        }
+    }
+
     /**
      * @brief Publish a message asynchronously
      * @param topic Topic to publish to
@@ -212,6 +261,43 @@ public:
         return client_.publish(msg);
     }
 
+    /**
+     * @brief Publish a raw byte buffer without waiting for delivery
+     * The bytes are copied into the outgoing message before returning. Completion
+     * is counted by inFlight(), which lets callers detect a backed-up link.
+     * @param topic Topic to publish to
+     * @param payload Pointer to the message bytes
+     * @param len Number of bytes
+     * @param qos Quality of Service level (optional, uses default if not specified)
+     * @param retained Whether the message should be retained by the broker
+     * @return true if the message was queued, false otherwise
+     */
+    bool publishAsyncTracked(const std::string& topic,
+                             const void* payload,
+                             size_t len,
+                             int qos = -1,
+                             bool retained = false) {
+        int actualQos = (qos < 0) ? defaultQos_ : qos;
+        inFlight_.fetch_add(1);
+        try {
+            client_.publish(topic, payload, len, actualQos, retained, nullptr, inFlightListener_);
+            return true;
+        }
+        catch (const mqtt::exception& exc) {
+            inFlight_.fetch_sub(1);
+            std::cerr << "Error publishing: " << exc.what() << std::endl;
+            return false;
+        }
+    }
+
+    /**
+     * @brief Number of publishAsyncTracked() messages not yet acknowledged
+     * (QoS 0: not yet written to the socket)
+     */
+    size_t inFlight() const {
+        return inFlight_.load();
+    }
+
     /**
      * @brief Disconnect from the MQTT broker
      */
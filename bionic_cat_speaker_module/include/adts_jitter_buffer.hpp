@@ -0,0 +1,116 @@
+#ifndef ADTS_JITTER_BUFFER_HPP
+#define ADTS_JITTER_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+struct JitterBufferConfig {
+    uint32_t frame_ms{64};          // 每包音频时长初值（AAC 1024 点 @16 kHz = 64 ms），流格式已知后由 setFrameMs 改写
+    uint32_t min_delay_ms{64};      // 目标缓冲时延下限
+    uint32_t max_delay_ms{640};     // 目标缓冲时延上限
+    uint32_t initial_delay_ms{192}; // 尚无抖动估计时的目标时延
+    float jitter_multiplier{3.0f};  // 目标时延 = 一帧 + k × 到达抖动
+    size_t capacity{64};            // 最多缓存的包数（按 seq 取模的环形槽）
+};
+
+struct JitterBufferStats {
+    uint64_t received{0};         // 接受入队的包
+    uint64_t duplicates{0};
+    uint64_t late_dropped{0};     // 到达时已过播放点
+    uint64_t overflow_resets{0};  // seq 跳变超出容量（发送端重启或长时间断流）后重新同步
+    uint64_t played{0};
+    uint64_t lost{0};             // 播放点上缺包，需隐藏
+    uint64_t underruns{0};        // 缓冲取空后重新缓冲的次数
+    uint64_t shrink_dropped{0};   // 缓冲长期高于目标时主动丢弃以降低时延
+    float jitter_ms{0.0f};
+    float target_delay_ms{0.0f};
+    float buffered_ms{0.0f};
+};
+
+// 接收端抖动缓冲：按 seq 排序，播放时钟每帧调用一次 pop
+// - 目标时延随到达抖动（RFC 3550 估计）自适应，欠载后重新缓冲到目标时延
+// - 晚于播放点的包直接丢弃；播放点上缺失的包报告为 Lost，由调用方做丢包隐藏
+// push 与 pop 可在不同线程调用
+class AdtsJitterBuffer {
+public:
+    enum class PushResult { Accepted, Duplicate, Late, Resync };
+    enum class PopStatus {
+        Frame,     // out 为下一包
+        Lost,      // 下一包缺失（out.seq 为缺失序号），需隐藏
+        Buffering  // 缓冲中，尚未开始/恢复播放
+    };
+
+    struct Packet {
+        uint32_t seq{0};
+        uint64_t pts_ms{0};
+        std::vector<uint8_t> payload;
+    };
+
+    // 连续缺包区间：[first_seq, first_seq + count)
+    using GapCallback = std::function<void(uint32_t first_seq, uint32_t count)>;
+
+    explicit AdtsJitterBuffer(const JitterBufferConfig& cfg = JitterBufferConfig{});
+
+    PushResult push(uint32_t seq, uint64_t pts_ms, const uint8_t* data, size_t len, uint64_t arrival_ms);
+    PopStatus pop(Packet& out);
+
+    void onGap(GapCallback cb) { gap_cb_ = std::move(cb); }
+    void reset();
+
+    // 每包时长随采样率变化（AAC 1024 点 @48 kHz ≈ 21.3 ms），缓冲时长、目标时延与回收门限都以它换算
+    void setFrameMs(float ms);
+    float frameMs() const;
+
+    JitterBufferStats stats() const;
+    const JitterBufferConfig& config() const { return cfg_; }
+
+private:
+    struct Slot {
+        bool used{false};
+        uint32_t seq{0};
+        uint64_t pts_ms{0};
+        std::vector<uint8_t> payload; // 容量复用，稳态下不分配
+    };
+
+    static int32_t seqDiff(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b); }
+    void resetLocked();
+    void updateJitter(uint64_t pts_ms, uint64_t arrival_ms);
+    uint32_t bufferedFramesLocked() const; // next_seq_ 到最高已收 seq 的帧数
+    void flushGapLocked();
+
+    JitterBufferConfig cfg_;
+    float frame_ms_{0.0f};
+    mutable std::mutex mtx_;
+    std::vector<Slot> slots_;
+    size_t count_{0};
+
+    bool have_next_{false};
+    bool playing_{false};
+    uint32_t next_seq_{0};
+    uint32_t highest_seq_{0};
+
+    // 到达抖动估计
+    bool have_transit_{false};
+    int64_t last_transit_ms_{0};
+    float jitter_ms_{0.0f};
+    float target_delay_ms_{0.0f};
+    uint32_t over_target_pops_{0};
+
+    // 缺包区间聚合后再回调
+    uint32_t gap_first_{0};
+    uint32_t gap_count_{0};
+    GapCallback gap_cb_{};
+
+    JitterBufferStats stats_{};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // ADTS_JITTER_BUFFER_HPP
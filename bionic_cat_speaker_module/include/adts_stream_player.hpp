@@ -0,0 +1,100 @@
+#ifndef ADTS_STREAM_PLAYER_HPP
+#define ADTS_STREAM_PLAYER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "adts_stream_receiver.hpp"
+#include "playback_telemetry.hpp"
+#include "spsc_ring.hpp"
+
+// 前向声明，避免头文件依赖
+struct pcm;
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+struct StreamPlayerStats {
+    uint64_t packets{0};             // push 的数据包
+    uint64_t frames_decoded{0};
+    uint64_t frames_concealed{0};    // 缺包/解码失败后隐藏的帧
+    uint64_t ring_underruns{0};      // 写设备时环形缓冲不足一个周期，补静音
+    uint64_t pcm_xruns{0};           // pcm_write 返回 -EPIPE 后恢复
+    int64_t startup_latency_ms{-1};  // 首包到达 → 首个周期写入设备；尚未出声为 -1
+    uint32_t sample_rate{0};
+    uint32_t channels{0};
+    JitterBufferStats jitter{};
+};
+
+// ADTS 流播放：MQTT 线程 push 数据包 → 抖动缓冲；
+// 解码线程按消耗节奏取帧解码写入无锁环形缓冲；写设备线程每周期 pcm_write 一次。
+// 设备在解出首帧（得知采样率/声道）后才打开，每包须为一个完整 ADTS 帧（与麦克风端一致）。
+class AdtsStreamPlayer {
+public:
+    struct Config {
+        int card{0};
+        int device{0};
+        uint32_t period_ms{20};       // 设备周期
+        uint32_t period_count{4};
+        uint32_t prefill_periods{2};  // 首次写设备前环形缓冲中预填的周期数
+        uint32_t ring_ms{500};        // 环形缓冲容量
+        JitterBufferConfig jitter{};
+        std::shared_ptr<PlaybackTelemetry> telemetry; // 可选：记录设备打开、首包到写入、写入耗时、缓冲填充度与欠载
+    };
+
+    explicit AdtsStreamPlayer(const Config& cfg);
+    ~AdtsStreamPlayer();
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // MQTT 线程调用
+    void push(uint32_t seq, uint64_t pts_ms, const uint8_t* data, size_t len);
+
+    // 距最后一次 push 的毫秒数（尚未收到数据时从 start 起算），用于判断流已结束
+    int64_t idleMs() const;
+
+    std::atomic<float> volume{1.0f};
+
+    StreamPlayerStats stats() const;
+
+private:
+    void decodeThread();
+    void writeThread();
+    bool openPcm(uint32_t rate, uint32_t channels);
+    void closePcm();
+    static int64_t nowMs();
+
+    Config cfg_;
+    AdtsStreamReceiver receiver_;
+    SpscRing<int16_t> ring_;
+
+    std::atomic<bool> running_{false};
+    std::thread decode_th_;
+    std::thread write_th_;
+
+    // 解码线程解出首帧后发布格式，写设备线程据此打开设备
+    std::atomic<uint32_t> sample_rate_{0};
+    std::atomic<uint32_t> channels_{0};
+    struct pcm* pcm_ = nullptr;
+
+    std::atomic<int64_t> start_ms_{0};
+    std::atomic<int64_t> first_packet_ms_{-1};
+    std::atomic<int64_t> last_packet_ms_{-1};
+    std::atomic<int64_t> startup_latency_ms_{-1};
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> frames_decoded_{0};
+    std::atomic<uint64_t> frames_concealed_{0};
+    std::atomic<uint64_t> ring_underruns_{0};
+    std::atomic<uint64_t> pcm_xruns_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // ADTS_STREAM_PLAYER_HPP
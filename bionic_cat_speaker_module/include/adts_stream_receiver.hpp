@@ -0,0 +1,75 @@
+#ifndef ADTS_STREAM_RECEIVER_HPP
+#define ADTS_STREAM_RECEIVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <fdk-aac/aacdecoder_lib.h>
+#include "adts_jitter_buffer.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// FDK AAC 解码（ADTS 输入，S16 交织输出），丢包时用 FDK 噪声替代做隐藏
+class AacDecoder {
+public:
+    AacDecoder();
+    ~AacDecoder();
+
+    bool open();
+    void close();
+
+    // 解码一个完整 ADTS 帧
+    bool decode(const uint8_t* adts, size_t len, std::vector<int16_t>& pcm);
+    // 生成一帧隐藏音频；尚未解出过有效帧（采样率/帧长未知）时返回 false
+    bool conceal(std::vector<int16_t>& pcm);
+
+    int sampleRate() const { return sample_rate_; }
+    int channels() const { return channels_; }
+    int frameSize() const { return frame_size_; }
+
+private:
+    bool decodeFrame(std::vector<int16_t>& pcm, UINT flags);
+
+    HANDLE_AACDECODER handle_{nullptr};
+    std::vector<INT_PCM> out_; // 解码输出暂存，容量复用
+    int sample_rate_{0};
+    int channels_{0};
+    int frame_size_{0};
+};
+
+// 抖动缓冲 + AAC 解码：网络线程 push（AdtsStreamDataMsg 的 seq/pts_ms/payload），
+// 播放线程每帧 nextFrame 取一帧 PCM，缺包时自动隐藏
+class AdtsStreamReceiver {
+public:
+    explicit AdtsStreamReceiver(const JitterBufferConfig& cfg = JitterBufferConfig{});
+
+    bool open() { return decoder_.open(); }
+    void close() { decoder_.close(); }
+
+    // 按 ADTS 头的采样率与块数更新抖动缓冲的每包时长，首次出队判断前即为实际值
+    AdtsJitterBuffer::PushResult push(uint32_t seq, uint64_t pts_ms, const uint8_t* data, size_t len,
+                                      uint64_t arrival_ms);
+
+    // Frame：pcm 为解码结果；Lost：pcm 为隐藏音频（解码失败也按此处理）；
+    // Buffering：pcm 为一帧静音（帧长未知时为空）
+    AdtsJitterBuffer::PopStatus nextFrame(std::vector<int16_t>& pcm);
+
+    AdtsJitterBuffer& jitterBuffer() { return jitter_; }
+    const AdtsJitterBuffer& jitterBuffer() const { return jitter_; }
+    const AacDecoder& decoder() const { return decoder_; }
+    uint64_t decodeErrors() const { return decode_errors_; }
+
+private:
+    AdtsJitterBuffer jitter_;
+    AacDecoder decoder_;
+    float frame_ms_{0.0f}; // 已告知抖动缓冲的每包时长（push 线程），格式不变时不再加锁更新
+    AdtsJitterBuffer::Packet packet_; // 复用的出队缓冲
+    uint64_t decode_errors_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // ADTS_STREAM_RECEIVER_HPP
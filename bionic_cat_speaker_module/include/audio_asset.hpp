@@ -0,0 +1,45 @@
+#ifndef AUDIO_ASSET_HPP
+#define AUDIO_ASSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "pcm_cache.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 音效资源容器，按文件开头的魔数识别（不看扩展名）
+enum class AssetFormat {
+    Unknown,
+    Wav,   // RIFF/WAVE，整数 PCM
+    Adts,  // AAC ADTS 裸流（.aac），可带 ID3v2 标签
+    Flac,  // 识别但未内置解码器
+    Ogg,   // Opus/Vorbis，识别但未内置解码器
+};
+
+const char* assetFormatName(AssetFormat fmt);
+AssetFormat probeAssetFormat(const uint8_t* head, size_t len);
+
+// WAV 的格式与 data 块位置
+struct WavLayout {
+    WavHeader header{};     // 规整为 44 字节头的字段：fmt_size 为 16，data_size 为实际可读长度
+    uint64_t data_offset{0};
+    uint64_t data_size{0};
+};
+
+// 遍历 RIFF 块：fmt 可长于 16 字节（WAVE_FORMAT_EXTENSIBLE 取子格式），data 前的 LIST/fact 等块按偶数对齐跳过；
+// data 长度为 0 或超出文件（流式写出的文件）时取到文件末尾。只接受整数 PCM
+bool readWavLayout(FILE* fp, WavLayout& layout);
+
+// 整段载入资源为 PcmClip：WAV 按原格式读入 data，ADTS 经 FDK 解码为 S16；
+// data 已按整帧截断。格式无效或无解码器时返回 nullptr
+std::shared_ptr<PcmClip> loadAudioAsset(const std::string& path);
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // AUDIO_ASSET_HPP
@@ -0,0 +1,209 @@
+#ifndef AUDIO_MIXER_HPP
+#define AUDIO_MIXER_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pcm_cache.hpp"
+#include "pcm_stream.hpp"
+#include "playback_telemetry.hpp"
+#include "resampler.hpp"
+
+// 前向声明，避免头文件依赖
+struct pcm;
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 实时多声部混音：N 个预分配声部各自带音量/循环/速度，饱和相加为一路 PCM，
+// 混音线程每个周期 pcm_write 一次（无声部时写静音，设备常开即热备）。
+// 声部数据来自内存中的 PcmClip（S16、与输出同声道），或来自 PcmStream（长 WAV 边预读边播，混音线程只从窗口取样）；
+// 采样率不同或变速时用多相 sinc 重采样。
+// 声部可指定 CLOCK_MONOTONIC 出声时刻：混音线程由设备时间戳推算每个周期首帧的出声时间，换算为周期内的帧偏移。
+class AudioMixer {
+public:
+    // 声部用满时的抢占策略；只会抢占优先级不高于新声部的声部
+    enum class StealPolicy {
+        None,           // 不抢占，新声部被拒绝
+        Oldest,         // 抢占最早开始的声部
+        Quietest,       // 抢占最近一个周期电平最低的声部
+        LowestPriority  // 先比优先级，同优先级抢占最早的
+    };
+
+    struct Config {
+        int card{0};
+        int device{0};
+        uint32_t rate{48000};
+        uint16_t channels{2};
+        uint32_t period_frames{256};
+        uint32_t period_count{4};
+        size_t voices{8};
+        StealPolicy steal{StealPolicy::LowestPriority};
+        uint32_t fade_ms{5}; // 停止/被抢占/调音量时的渐变时长，避免爆音；起播不淡入
+        ResampleQuality quality{ResampleQuality::Medium};
+        int32_t output_latency_us{0}; // 设备时间戳之后的固定延迟（DAC/功放），计入出声时刻
+        std::shared_ptr<PlaybackTelemetry> telemetry; // 可选：记录设备打开、触发到写入、写入耗时与缓冲填充度
+    };
+
+    struct VoiceParams {
+        float volume{1.0f};
+        float speed{1.0f};
+        bool loop{false};
+        int priority{0};
+        int64_t start_at_ns{0}; // CLOCK_MONOTONIC 出声时刻，0 表示下个周期立即开始
+    };
+
+    struct Stats {
+        uint64_t periods{0};
+        uint64_t xruns{0};
+        uint64_t started{0};
+        uint64_t steals{0};
+        uint64_t rejected{0};
+        uint64_t scheduled{0};   // 带出声时刻的声部数
+        uint64_t late_starts{0}; // 到达时出声时刻已过、从周期首帧开始的声部数
+        uint64_t stream_underruns{0}; // 流式声部的预读没跟上、本周期余下部分补静音的次数
+        uint32_t active{0};
+        uint32_t peak_active{0};
+    };
+
+    using VoiceId = uint32_t; // 0 表示无效
+
+    explicit AudioMixer(const Config& cfg);
+    ~AudioMixer();
+
+    bool open();  // 打开设备并启动混音线程
+    void close();
+    bool isOpen() const { return running_.load(); }
+
+    // 以下接口可在任意非实时线程调用；命令在下一个周期边界生效
+    VoiceId play(std::shared_ptr<const PcmClip> clip, const VoiceParams& params);
+    // 流式声部：stream 的声道数须与输出一致，交给混音器后调用方不能再访问它；循环在 PcmStream::open 时指定，params.loop 不起作用
+    VoiceId play(std::shared_ptr<PcmStream> stream, const VoiceParams& params);
+    void stop(VoiceId id);
+    // at_ns 非 0 时在该时刻停止（不影响在此时刻及之后才开始的声部）；只停止优先级不高于 max_priority 的声部
+    void stopAll(int64_t at_ns = 0, int max_priority = INT_MAX);
+    void setVolume(VoiceId id, float volume);
+    bool isActive(VoiceId id) const;
+    size_t activeVoices() const;
+
+    const Config& config() const { return cfg_; }
+    Stats stats() const;
+
+    // 应用待处理命令并混出一个周期（period_frames × channels 个样本）。
+    // out_ns 为本周期首帧的出声时刻（CLOCK_MONOTONIC），0 表示未知，此时定时声部立即开始。
+    // 由混音线程调用；未 open() 时可直接调用做离线渲染/测试
+    void renderPeriod(int16_t* out, int64_t out_ns = 0);
+
+    static int64_t monotonicNowNs();
+
+private:
+    enum class CmdType { Start, Stop, StopAll, SetVolume };
+    struct Command {
+        CmdType type{CmdType::Stop};
+        size_t slot{0};
+        VoiceId id{0};
+        std::shared_ptr<const PcmClip> clip;
+        std::shared_ptr<PcmStream> stream;
+        const SincKernel* kernel{nullptr};
+        VoiceParams params{};
+        int64_t issued_us{0}; // play() 调用时刻，统计触发到写入的时延
+    };
+
+    // 仅混音线程访问
+    struct Voice {
+        VoiceId id{0};
+        std::shared_ptr<const PcmClip> clip;
+        std::shared_ptr<PcmStream> stream; // 流式声部：data/frames 每周期取自窗口，pos 为源帧序号
+        const int16_t* data{nullptr};
+        size_t frames{0};
+        double pos{0.0};  // 小数帧位置，跨周期保持
+        double step{1.0}; // 每输出帧前进的源帧数 = 源采样率 / 输出采样率 × 速度
+        const SincKernel* kernel{nullptr}; // step != 1 时使用；由 kernels_ 持有，实时线程不负责释放
+        bool loop{false};
+        float gain{0.0f};
+        float target{0.0f};
+        bool stopping{false}; // 渐变到 0 后结束
+        int64_t start_ns{0};  // 未到出声时刻的定时声部，开始后清零
+        int priority{0};
+    };
+
+    struct ScheduledStop {
+        int64_t at_ns{0};
+        int max_priority{INT_MAX};
+    };
+
+    // 控制侧可见的槽位状态
+    struct SlotState {
+        std::atomic<VoiceId> id{0};    // 0 = 空闲；混音线程在声部结束时清零
+        std::atomic<float> level{0.0f}; // 最近一个周期的峰值（0~1）
+        int priority{0};                // 以下仅控制侧读写（ctl_mtx_）
+        uint64_t order{0};
+    };
+
+    // 分配槽位与重采样核后把启动命令交给混音线程；src_rate 为声部源采样率
+    VoiceId submit(Command& c, uint32_t src_rate, const VoiceParams& params);
+    void releaseRetired(); // 在控制侧释放混音线程交回的片段与流
+    void mixThread();
+    bool openPcm();
+    void closePcm();
+    void applyCommands();
+    void startVoice(Command& c);
+    void retireVoice(Voice& v);
+    void stopVoice(Voice& v);
+    // 下一次写入的首帧出声时刻；queued_frames 为设备缓冲中尚未播放的帧数，设备未起播时为 -1
+    int64_t nextOutputNs(uint64_t written_frames, long& queued_frames);
+    const SincKernel* kernelFor(double step); // 需持有 ctl_mtx_
+    // 渲染一个声部到 scratch_（前 skip 帧为静音），返回 false 表示声部已结束
+    bool renderVoice(Voice& v, size_t skip, size_t frames);
+
+    Config cfg_;
+    struct pcm* pcm_ = nullptr;
+    std::atomic<bool> running_{false};
+    std::thread th_;
+
+    std::vector<Voice> voices_;
+    std::vector<Voice> tails_;  // 被抢占声部的淡出尾巴
+    std::unique_ptr<SlotState[]> slots_;
+
+    mutable std::mutex ctl_mtx_; // 控制侧分配槽位
+    uint64_t order_counter_{0};
+    uint32_t next_gen_{1};
+    std::vector<std::unique_ptr<const SincKernel>> kernels_; // 按截止频率共用，生命周期同混音器
+
+    std::mutex cmd_mtx_;               // 混音线程只 try_lock，从不阻塞
+    std::vector<Command> pending_;     // 控制侧写入
+    std::vector<Command> applying_;    // 混音线程交换取出
+    // 结束声部的片段/流交回控制侧释放，避免实时线程 free 或等读线程退出
+    std::vector<std::shared_ptr<const void>> retired_;
+    std::vector<std::shared_ptr<const void>> retired_local_; // 未拿到锁时暂存
+
+    std::vector<int16_t> mix_;
+    std::vector<int16_t> scratch_;
+    std::vector<float> coef_;   // 当前帧的插值滤波系数
+    std::vector<float> gather_; // 当前帧、当前声道的源样本窗口
+    float ramp_delta_{1.0f}; // 每帧增益变化量（gainRampStep，与 WavPlayer 同斜率）；0 表示立即生效
+    float level_{0.0f};      // renderVoice 输出的本周期峰值
+    int64_t first_issued_us_{0}; // 本周期开始的立即声部中最早的 play() 时刻，写入设备后计入遥测
+    std::vector<ScheduledStop> stop_at_; // 尚未到期的定时 stopAll，仅混音线程访问（预留容量，满时立即执行）
+
+    std::atomic<uint64_t> periods_{0};
+    std::atomic<uint64_t> xruns_{0};
+    std::atomic<uint64_t> started_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> scheduled_{0};
+    std::atomic<uint64_t> late_starts_{0};
+    std::atomic<uint64_t> stream_underruns_{0};
+    std::atomic<uint32_t> peak_active_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // AUDIO_MIXER_HPP
@@ -0,0 +1,98 @@
+#ifndef FILE_PREFETCHER_HPP
+#define FILE_PREFETCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 文件区间预读：普通优先级的读线程按块 pread 到无锁环形缓冲，播放线程只从环形缓冲取数据，
+// 不再在 SCHED_FIFO 线程上做文件 I/O。读线程同时用 posix_fadvise 提示内核顺序预读后续区域。
+// 循环播放时由读线程在区间末尾自行回绕，首尾数据在环形缓冲中连续。
+// 消费端：SpeakerNode 经 PcmStream 用于混音器的流式声部（不入缓存的长 WAV），独立的 WavPlayer 用于未命中缓存的文件。
+class FilePrefetcher {
+public:
+    struct Config {
+        size_t ring_bytes{128 * 1024};  // 环形缓冲容量（48 kHz 双声道 S16 约 680 ms）
+        size_t chunk_bytes{16 * 1024};  // 每次 pread 的字节数
+        size_t readahead_bytes{256 * 1024}; // 提示内核预读的窗口
+        uint32_t prefill_timeout_ms{500};   // rewind() 等待首块数据的上限
+    };
+
+    struct Stats {
+        uint64_t bytes_read{0};
+        uint64_t io_errors{0};  // pread 失败（读线程随即按区间结束处理）
+        uint64_t wraps{0};      // 循环回绕次数
+    };
+
+    FilePrefetcher();
+    explicit FilePrefetcher(const Config& cfg);
+    ~FilePrefetcher();
+
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    // 打开文件并启动读线程，读取 [offset, offset + length)；length 为 0 或超出文件时读到文件末尾。
+    // align 为帧长，消费端每次只取整帧
+    bool open(const std::string& path, uint64_t offset, uint64_t length, size_t align);
+    void close();
+
+    // 读线程到达区间末尾时是否回绕到开头；可在播放中修改，对尚未读到的末尾生效
+    void setLoop(bool on) { loop_.store(on); }
+
+    // ---- 消费端（播放线程），无锁、不做 I/O ----
+    // 取最多 n 字节（按整帧截断），返回实际字节数；返回 0 时用 eof() 区分“读完”与“数据未到”
+    size_t read(uint8_t* dst, size_t n);
+    bool eof() const;
+
+    // ---- 消费端的非实时操作 ----
+    // 回到区间开头：尚未取过数据时直接返回，否则等读线程清空环形缓冲并重新预读（最多 prefill_timeout_ms）
+    void rewind();
+    // 等到环形缓冲中至少有 bytes 字节或区间已读完，超时返回 false
+    bool waitReady(size_t bytes, std::chrono::milliseconds timeout);
+
+    Stats stats() const;
+
+private:
+    void readerThread();
+    void adviseAhead(uint64_t pos);
+
+    Config cfg_;
+    int fd_{-1};
+    size_t align_{1};
+    uint64_t begin_{0};
+    uint64_t end_{0};
+    uint64_t pos_{0};            // 读线程的下一个读取位置
+    uint64_t advised_until_{0};  // 已提示预读到的位置
+
+    SpscRing<uint8_t> ring_;
+    std::vector<uint8_t> chunk_;
+    std::thread th_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    bool quit_{false};
+    bool rewind_req_{false};
+    std::atomic<bool> done_{false};     // 读线程已读到区间末尾（且不回绕）
+    std::atomic<bool> consumed_{false}; // 自上次 rewind 以来消费端是否取过数据
+    std::atomic<bool> loop_{false};
+
+    std::atomic<uint64_t> bytes_read_{0};
+    std::atomic<uint64_t> io_errors_{0};
+    std::atomic<uint64_t> wraps_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // FILE_PREFETCHER_HPP
@@ -0,0 +1,39 @@
+#ifndef OUTPUT_ARBITER_HPP
+#define OUTPUT_ARBITER_HPP
+
+#include <cstdint>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 流播放与混音器共用一个 PCM 设备，后到的一方停止另一方。SpeakerNode 在 stream_mtx_ 下调用，本身不加锁。
+// 流数据在没有流播放器时会自动开流；但播放指令刚停掉的流若仍在发数据，下一个数据包就会重新开流、
+// 关闭混音器，把刚开始的音效掐断。因此播放指令停掉流后锁存“流已被指令停止”，直到：
+//  - 收到显式的流控制消息（is_start 开流或结束流），或
+//  - 该流停发超过 idle_timeout_ms，之后的数据视为一个新的流
+// 锁存期间的数据包丢弃并计数
+class OutputArbiter {
+public:
+    explicit OutputArbiter(int64_t idle_timeout_ms) : idle_timeout_ms_(idle_timeout_ms) {}
+
+    // 播放指令（含停止指令）停止了正在进行的流
+    void onCommandStoppedStream(int64_t now_ms);
+    // 收到显式的流控制消息
+    void onStreamControl() { latched_ = false; }
+    // 收到流数据而流播放器未运行：是否允许按数据自动开流
+    bool allowAutoStart(int64_t now_ms);
+
+    bool latched() const { return latched_; }
+    uint64_t suppressedPackets() const { return suppressed_; }
+
+private:
+    int64_t idle_timeout_ms_;
+    bool latched_{false};
+    int64_t last_data_ms_{0}; // 锁存后最近一次收到数据（或锁存）的时刻
+    uint64_t suppressed_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // OUTPUT_ARBITER_HPP
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "play_wav_tinyalsa.hpp"
+
+// 已解析、可直接写入设备的 PCM 片段（data 已按整帧截断）
+struct PcmClip {
+    WavHeader header{};
+    std::vector<uint8_t> data;
+};
+
+// 转为 S16、指定声道数（0 = 保持原声道），逐帧规则见 pcm_convert.hpp 的 convertFramesToS16
+// （与 WavPlayer、流式声部相同）。格式不支持或声道数超过 kMaxPcmChannels 时返回 nullptr
+std::shared_ptr<const PcmClip> convertPcmClip(const PcmClip& src, uint16_t channels);
+
+// 短音效（喵叫、呼噜声等）的 PCM 缓存：按 路径 + mtime + 文件大小 作键，LRU 淘汰，总字节数受上限约束
+// 命中时播放线程直接读内存，不再有磁盘 I/O；正在播放的片段由 shared_ptr 持有，淘汰不影响播放。
+// 资源可以是 WAV 或 AAC（ADTS），压缩资源在载入时解码，缓存中保存的是 PCM
+class PcmCache {
+public:
+    struct Stats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+        uint64_t too_large{0}; // 超过单条上限、不缓存的文件
+        size_t bytes{0};
+        size_t entries{0};
+    };
+
+    // max_bytes：缓存总上限；max_entry_bytes：单个文件上限（0 表示取 max_bytes / 4）
+    explicit PcmCache(size_t max_bytes = 8 * 1024 * 1024, size_t max_entry_bytes = 0);
+
+    // 取片段：命中且文件未变化直接返回；否则读盘解析（解码）后入缓存。
+    // 解码后超过单条上限时返回结果但不入缓存；文件本身过大、不存在或格式无效时返回 nullptr，调用方退回流式读文件
+    std::shared_ptr<const PcmClip> get(const std::string& path);
+
+    // 预加载，便于启动时把常用音效放进缓存
+    bool preload(const std::string& path) { return get(path) != nullptr; }
+
+    // 读入整个文件但不入缓存（超过单条上限的压缩资源；长 WAV 应交给 PcmStream 流式播放），格式转换规则同缓存条目。
+    // 文件超过 max_file_bytes 时不读、返回 nullptr（0 表示不限）
+    std::shared_ptr<const PcmClip> loadUncached(const std::string& path, size_t max_file_bytes = 0) const;
+
+    // 入缓存前统一转换为 S16、指定声道数（0 = 仅转位深），命中即可直接混音/写设备；修改后清空缓存
+    void setOutputChannels(uint16_t channels);
+
+    void clear();
+    void setMaxBytes(size_t max_bytes);
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string path;
+        struct timespec mtime{};
+        off_t file_size{0};
+        std::shared_ptr<const PcmClip> clip;
+    };
+
+    std::shared_ptr<const PcmClip> loadFile(const std::string& path) const;
+    void evictLocked();
+
+    mutable std::mutex mtx_;
+    size_t max_bytes_;
+    size_t max_entry_bytes_;
+    uint16_t out_channels_{0};
+    bool convert_{false};
+    std::list<Entry> lru_; // 前端为最近使用
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    Stats stats_{};
+};
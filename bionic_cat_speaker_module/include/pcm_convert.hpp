@@ -0,0 +1,51 @@
+#ifndef PCM_CONVERT_HPP
+#define PCM_CONVERT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 播放链路上的样本格式转换。S16 ↔ float 转发到 bionic_cat_audio_dsp 的向量内核（运行时选择 NEON/SSE2/标量），
+// 其余走标量；float 统一按 [-1, 1) 满幅。WavPlayer、混音器的缓存片段与流式声部都经这里转换，规则一致
+
+// 可转换的最大声道数；超过的文件在载入/打开时拒绝
+constexpr uint16_t kMaxPcmChannels = 32;
+
+// S16 → float
+void s16ToFloat(const int16_t* in, float* out, size_t n);
+
+// float × gain → S16，饱和后四舍五入（远离零）
+void floatToS16(const float* in, float gain, int16_t* out, size_t n);
+
+// WAV 样本（8 bit 无符号，16/24/32 bit 有符号，小端）→ float；bits 不支持时返回 false
+bool pcmToFloat(const uint8_t* in, size_t samples, uint16_t bits, float* out);
+
+// 交错声道重排：升混 out[c] = in[c % in_ch]，降混 out[c] = 所有 i % out_ch == c 的输入声道均值
+// （目标为单声道时即全部声道平均）
+void remixChannels(const float* in, uint16_t in_ch, float* out, uint16_t out_ch, size_t frames);
+
+// WAV 帧 → 指定声道数的 S16：pcmToFloat → remixChannels → floatToS16（四舍五入、饱和），按栈上小块处理、不分配内存，
+// 可在混音线程上调用。bits 须为 8/16/24/32，in_ch/out_ch 为 1..kMaxPcmChannels；16 bit 且声道相同时直接复制
+void convertFramesToS16(const uint8_t* in, size_t frames, uint16_t in_ch, uint16_t bits, int16_t* out, uint16_t out_ch);
+
+// 增益渐变的每帧步长：满幅 0 ↔ 1 在 fade_ms 内走完；fade_ms <= 0 时返回 0（不渐变）。
+// WavPlayer 与混音器声部共用，两者同一 fade_ms 下斜率相同
+float gainRampStep(float fade_ms, uint32_t rate);
+
+// 增益向 target 走一步（step <= 0 时直接到 target），不越过 target。混音器逐帧调用，故内联
+inline float stepGain(float gain, float target, float step) {
+    if (step <= 0.0f) return target;
+    return gain < target ? std::min(target, gain + step) : std::max(target, gain - step);
+}
+
+// 逐帧线性增益渐变：gain 每帧向 target 移动 step（step <= 0 时立即跳到 target）并乘到该帧所有声道上，
+// 到达 target 即停止；返回已处理的帧数（含到达的那一帧），其余帧留给调用方按常量 target 处理。gain 原地更新
+size_t applyGainRamp(float* x, size_t frames, uint16_t ch, float& gain, float target, float step);
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // PCM_CONVERT_HPP
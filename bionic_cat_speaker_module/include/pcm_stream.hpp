@@ -0,0 +1,71 @@
+#ifndef PCM_STREAM_HPP
+#define PCM_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file_prefetcher.hpp"
+#include "pcm_cache.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 混音器声部的流式数据源：超过缓存单条上限的 WAV 不再整段读入内存。
+// FilePrefetcher 的读线程（普通调度）把 data 区间读进环形缓冲；混音线程每个周期按需取块，
+// 转换为 S16、混音器声道数（规则同 convertPcmClip）后放进一段滑动窗口，声部按源帧序号从窗口取样（含重采样前后的抽头）。
+// 内存占用为环形缓冲加窗口，与文件长度无关。循环播放由读线程在区间末尾回绕，源帧序号跨轮继续递增
+class PcmStream {
+public:
+    // 打开 WAV 并等预读填入首段数据。不是 WAV（压缩资源）时静默返回 nullptr，由调用方改为整段解码；
+    // 文件打不开或格式不支持时打印错误并返回 nullptr
+    static std::shared_ptr<PcmStream> open(const std::string& path, uint16_t out_channels, bool loop,
+                                           const FilePrefetcher::Config& cfg = FilePrefetcher::Config{});
+
+    ~PcmStream();
+
+    PcmStream(const PcmStream&) = delete;
+    PcmStream& operator=(const PcmStream&) = delete;
+
+    const WavHeader& sourceHeader() const { return header_; }
+    uint32_t sampleRate() const { return header_.sample_rate; }
+    uint16_t channels() const { return out_channels_; } // 窗口中的声道数
+    bool loop() const { return loop_; }
+
+    // 控制侧、交给混音线程之前调用：窗口至少容纳 frames 帧（丢弃已有内容）
+    void reserveWindow(size_t frames);
+    size_t windowFrames() const { return window_frames_; }
+
+    // ---- 混音线程：无锁、不分配、不做 I/O ----
+    // 丢弃源帧 keep_from 之前的帧，再从环形缓冲补到覆盖 need_end 或窗口满；预读没跟上时窗口可能仍不到 need_end
+    void fill(size_t keep_from, size_t need_end);
+    const int16_t* data() const { return window_.data(); } // 窗口首帧
+    size_t base() const { return base_; }                   // 窗口首帧的源帧序号
+    size_t end() const { return base_ + count_; }           // 窗口末尾（不含）的源帧序号
+    // 不循环且文件已全部进入窗口：end() 之后不会再有数据
+    bool finished() const { return !loop_ && file_.eof(); }
+
+    FilePrefetcher::Stats prefetchStats() const { return file_.stats(); }
+
+private:
+    PcmStream(const FilePrefetcher::Config& cfg, uint16_t out_channels, bool loop);
+
+    FilePrefetcher file_;
+    WavHeader header_{};
+    uint16_t out_channels_;
+    bool loop_;
+    size_t frame_bytes_{0}; // 源文件一帧的字节数
+
+    std::vector<int16_t> window_; // window_frames_ × out_channels_
+    std::vector<uint8_t> raw_;    // 一次最多取整个窗口的源数据
+    size_t window_frames_{0};
+    size_t base_{0};
+    size_t count_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // PCM_STREAM_HPP
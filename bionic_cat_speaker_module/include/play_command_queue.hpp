@@ -0,0 +1,79 @@
+#ifndef PLAY_COMMAND_QUEUE_HPP
+#define PLAY_COMMAND_QUEUE_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "bionic_cat_mqtt_msg.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 播放指令队列：MQTT 回调线程只入队，SpeakerNode 的指令线程取出后载入并执行，慢的载入不再堵住后续指令。
+// 按 AudioPlayMode 与 priority 处理：
+//  - REPLACE 与停止指令（file_path 为空）作废排队中优先级不高于它的指令；停止指令视为最高优先级。
+//    已取出、正在载入的指令在执行前用 superseded() 检查，被后到的 REPLACE/停止作废的直接丢弃
+//  - 取出顺序：优先级高的先取，同优先级先到先取
+//  - ENQUEUE 只在输出空闲（没有声部在播放）时才能取出
+//  - DROP_IF_BUSY 轮到它时输出忙则丢弃
+// 队满时挤掉优先级最低、最早的一条；新指令优先级更低时丢弃新指令
+class PlayCommandQueue {
+public:
+    using Command = BionicCat::MqttMsgs::AudioPlayCommand;
+
+    struct Ticket {
+        uint64_t seq{0}; // 入队序号，从 1 递增
+        Command cmd;
+    };
+
+    struct Stats {
+        uint64_t submitted{0};
+        uint64_t taken{0};        // pop 取出交给执行的
+        uint64_t coalesced{0};    // 排队中或载入中被后到的 REPLACE/停止作废
+        uint64_t dropped_busy{0}; // DROP_IF_BUSY 遇到输出忙
+        uint64_t overflowed{0};   // 队满被挤掉或被拒绝
+        size_t depth{0};
+        size_t peak_depth{0};
+    };
+
+    explicit PlayCommandQueue(size_t capacity = 16);
+
+    void push(const Command& cmd);
+    // 取出下一条可执行的指令，不阻塞；output_busy 为当前是否有声音在播放（含流播放）
+    bool pop(Ticket& out, bool output_busy);
+    // 取出后是否又入队了能作废它的 REPLACE/停止；为 true 时计入 coalesced，调用方应放弃执行
+    bool superseded(const Ticket& t);
+
+    // 入队或 close() 时递增；指令线程在 pop 前取值，pop 落空后用它等待，避免漏掉其间的 push
+    uint64_t version() const;
+    void waitChanged(uint64_t version, int timeout_ms);
+    void close(); // 清空排队并唤醒等待者
+
+    Stats stats() const;
+
+    static bool replaces(const Command& cmd); // REPLACE 或停止指令
+    static bool isStop(const Command& cmd) { return cmd.file_path.empty(); }
+
+private:
+    void removeAt(size_t i);
+
+    size_t capacity_;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<Ticket> pending_;
+    uint64_t next_seq_{1};
+    uint64_t version_{0};
+    bool closed_{false};
+    // replace_floor_[p]：优先级不低于 p 的 REPLACE/停止中最晚的序号，低于它的优先级 p 指令已被作废
+    std::array<uint64_t, 256> replace_floor_{};
+    Stats stats_;
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // PLAY_COMMAND_QUEUE_HPP
@@ -4,12 +4,18 @@
 #include <thread>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 
+#include "resampler.hpp"
+
 // 前向声明，避免头文件依赖
 struct pcm;
 struct pcm_config;
+class PcmCache;
+struct PcmClip;
+namespace BionicCat { namespace SpeakerModule { class FilePrefetcher; class PlaybackTelemetry; } }
 
 // 简单的 WAV 头结构
 struct WavHeader {
@@ -37,41 +43,131 @@ public:
     std::string file_path;
     std::atomic<float> speed{1.0f};  // 支持原子操作，便于运行时调整（虽目前主逻辑未动态调）
     std::atomic<float> volume{1.0f};
+    // 增益渐变时长：满幅 0 ↔ 1 在 fade_ms 内走完。起播淡入、音量变化与 stop() 淡出都按此斜率逐样本过渡；
+    // 0 表示不渐变（立即生效）。混音器声部与此共用 gainRampStep/stepGain，但起播不淡入，见 AudioMixer::Config::fade_ms
+    std::atomic<float> fade_ms{5.0f};
     std::atomic<bool> loop{false};
+    // 重采样质量，在下一次 play() 时生效
+    std::atomic<BionicCat::SpeakerModule::ResampleQuality> resample_quality{BionicCat::SpeakerModule::ResampleQuality::Medium};
+
+    // 设置 PCM 缓存（可多个播放器共享）；命中时不再打开文件，播放线程直接读内存
+    void setCache(std::shared_ptr<PcmCache> cache) { cache_ = std::move(cache); }
+
+    // 设置播放遥测（可与其他播放器共享），在 load()/warmUp() 之前调用：
+    // 记录设备打开耗时、play() 到首次写入、每次 pcm_write 耗时、设备缓冲填充度、欠载与 xrun
+    void setTelemetry(std::shared_ptr<BionicCat::SpeakerModule::PlaybackTelemetry> telemetry) {
+        telemetry_ = std::move(telemetry);
+    }
+
+    // 设备固定输出格式（S16_LE，默认 48 kHz 双声道）：任意采样率/声道/位深的文件都在播放线程内
+    // 转换到该格式，切换文件无需重开设备；修改后在下一次 load()/warmUp() 时重开一次。
+    // SpeakerNode 的混音器本身就以固定格式常开设备，这里只影响独立使用的 WavPlayer；
+    // 位深/声道转换规则两者相同（pcm_convert.hpp）
+    void setOutputFormat(uint32_t rate, uint16_t channels);
+    uint32_t outputRate() const { return out_rate_; }
+    uint16_t outputChannels() const { return out_channels_; }
 
-    // 加载文件并准备设备 (如果参数匹配则复用设备)
+    // 加载文件并准备设备（设备已按输出格式打开时直接复用）
     bool load(int card = 0, int device = 0);
 
     // 开始播放 (异步)
     bool play();
 
-    // 停止播放 (但不关闭音频设备，以便复用)
+    // 停止播放 (但不关闭音频设备，以便复用)：先按 fade_ms 淡出到静音再停，最多等待淡出完成约一个周期
     void stop();
 
+    // 请求淡出停止后立即返回：当前播放（或离线渲染）淡到静音后结束
+    void fadeOut();
+
     // 完全关闭 (停止播放并关闭音频设备)
     void close();
 
     bool isPlaying() const { return playing_.load(); }
 
+    // 热备模式：设备保持打开并以静音持续运行（仅排队约半个到一个周期），
+    // 播放请求在下一个周期边界接入，触发到出声约一个周期；关闭后回到按需 prepare
+    void setWarmStandby(bool on);
+    bool warmStandby() const { return warm_standby_.load(); }
+    // 尚未加载文件时按输出格式预先打开设备并进入热备
+    bool warmUp(int card, int device);
+
+    // 最近一次 play() 到首个样本出声的估计时延：分派（请求 → 首次写入）+ 写入时设备中已排队的帧
+    struct TriggerLatency {
+        int64_t dispatch_us{-1};
+        int64_t queue_us{-1};
+        int64_t total_us{-1};
+        bool warm{false};
+    };
+    TriggerLatency lastTriggerLatency() const;
+
+    // 欠载统计（累计值）：文件源由预读线程读入环形缓冲，播放线程不做文件 I/O；
+    // 预读跟不上时补一块静音并计入 reader_underruns，设备侧 xrun 计入 device_xruns
+    struct PlaybackStats {
+        uint64_t reader_underruns{0};
+        uint64_t device_xruns{0};
+        uint64_t prefetch_io_errors{0}; // 当前文件
+        uint64_t prefetched_bytes{0};   // 当前文件
+    };
+    PlaybackStats playbackStats() const;
+
+    // 离线渲染：不打开设备、不经过播放线程，走与播放线程相同的处理链（格式转换、变速、音量渐变），
+    // 便于单元测试与预渲染。不能与 play() 同时使用。
+    // loadSource() 只解析源（缓存或文件）；beginRender() 从头开始一轮；
+    // renderNext() 每次向 out 追加一块输出格式的 S16 交织样本，源结束（非循环）或淡出完成后返回 false
+    bool loadSource();
+    bool beginRender();
+    bool renderNext(std::vector<int16_t>& out);
+
 private:
+    // 源读取位置：缓存命中时为内存片段偏移，否则从预读环形缓冲取。
+    // blocking 为 true（离线渲染）时等待预读，否则数据未到即补静音
+    struct SourceCursor {
+        std::shared_ptr<const PcmClip> clip;
+        size_t clip_pos = 0;
+        std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher> file;
+        bool blocking = false;
+    };
+
     void playbackThread();
+    bool rewindSource(SourceCursor& cur);
+    // 读一块源数据并处理为输出格式；源结束时排空变速尾巴，都没有时返回 false（循环播放自动回绕）
+    bool produceBlock(SourceCursor& cur, std::vector<uint8_t>& inBuf, std::vector<uint8_t>& out);
     bool openPcm(int card, int device);
     bool readHeader();
+    bool sourceFormatSupported() const;
+    // 源数据 → 输出格式：位深转 float、声道重排、变速/重采样、音量，最后饱和转 S16
     void applyVolumeAndSpeed(const uint8_t* in, size_t inBytes, std::vector<uint8_t>& out);
+    void resetSpeedState();                          // 每轮播放开始时清空变速器历史与相位
+    bool flushSpeedState(std::vector<uint8_t>& out); // 文件结束时排空变速器尾巴，无数据返回 false
+    // 按本块的开关把 x（输出声道数）送入重采样，结果追加到 fout_；刚关闭重采样时先排空
+    void runSpeedChain(const float* x, size_t frames, bool resample, float speed);
+    // fout_ → S16：增益到达目标前逐帧渐变，之后按常量目标增益在同一次转换中完成；淡出停止到 0 时截断
+    void finishBlock(float target, std::vector<uint8_t>& out);
+    float targetGain() const; // 淡出停止时为 0，否则为 volume
     
     // 内部控制
     void stopPlaybackThread(); // 仅停止线程（改为仅供析构调用）
     void closeDevice();        // 仅关闭设备
     void ensureThreadStarted();
+    void feedStandbySilence();  // 热备：设备排队不足半个周期时补半个周期静音
+    long queuedFramesLocked();  // 设备中尚未播放的帧数（未运行时为 0），需持有 dev_mtx_
 
-    FILE* fp_ = nullptr;
+    FILE* fp_ = nullptr;  // 仅在 loadSource() 中读文件头
     long data_start_pos_ = 0;
-    WavHeader header_{};
+    std::shared_ptr<PcmCache> cache_;
+    std::shared_ptr<BionicCat::SpeakerModule::PlaybackTelemetry> telemetry_;
+    // 数据源二选一：缓存命中时为内存片段，否则为文件预读器；跨线程用 atomic_load/store
+    std::shared_ptr<const PcmClip> clip_;
+    std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher> prefetch_;
+    WavHeader header_{};  // 当前源文件格式
+    uint32_t out_rate_ = 48000;
+    uint16_t out_channels_ = 2;
 
     struct pcm* pcm_ = nullptr;
     struct pcm_config* cfg_ = nullptr;
 
     std::atomic<bool> stop_flag_{false};
+    std::atomic<bool> fade_stop_{false}; // 淡出停止请求，淡出完成后播放线程自行结束
     std::atomic<bool> playing_{false};
     std::thread th_;
 
@@ -79,7 +175,6 @@ private:
     bool device_opened_ = false;
     uint16_t last_channels_ = 0;
     uint32_t last_rate_ = 0;
-    uint16_t last_bits_ = 0;
     int last_card_ = -1;
     int last_device_ = -1;
 
@@ -89,4 +184,32 @@ private:
     std::atomic<bool> play_request_{false};
     std::atomic<bool> terminate_{false};
     bool thread_started_ = false;
+
+    // 热备与触发时延统计
+    std::atomic<bool> warm_standby_{false};
+    std::mutex dev_mtx_; // 播放线程写设备与 load/close 切换设备之间互斥
+    std::vector<uint8_t> silence_;
+    std::atomic<int64_t> trigger_ns_{0};
+    mutable std::mutex lat_mtx_;
+    TriggerLatency last_latency_{};
+    std::atomic<uint64_t> reader_underruns_{0};
+    std::atomic<uint64_t> device_xruns_{0};
+
+    // 格式转换与变速状态（仅播放线程访问）：跨 4 KB 块保持小数相位与滤波器历史，块边界无跳变。
+    // 采样率不同或变速时重采样（变速即变调）
+    bool resample_on_ = false;
+    std::unique_ptr<BionicCat::SpeakerModule::Resampler> resampler_;
+    std::vector<float> fin_;   // 源声道数
+    std::vector<float> fmix_;  // 输出声道数
+    std::vector<float> fout_;
+
+    // 增益渐变状态（仅播放线程/离线渲染访问）
+    float gain_ = 1.0f;        // 当前实际增益
+    bool faded_out_ = false;   // 淡出停止已到静音
+
+    // 离线渲染状态
+    SourceCursor render_cur_;
+    std::vector<uint8_t> render_in_;
+    std::vector<uint8_t> render_out_;
+    bool render_end_ = false;
 };
\ No newline at end of file
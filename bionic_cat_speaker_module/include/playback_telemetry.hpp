@@ -0,0 +1,92 @@
+#ifndef PLAYBACK_TELEMETRY_HPP
+#define PLAYBACK_TELEMETRY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 固定桶直方图：第 i 桶计入 (upper[i-1], upper[i]] 的样本，最后一桶计入大于最后一个上界的样本。
+// record() 只做 relaxed 原子操作，可在实时线程调用
+class Histogram {
+public:
+    static constexpr size_t kMaxBounds = 7;
+
+    struct Snapshot {
+        uint64_t count{0};
+        float avg{0.0f};
+        uint32_t max{0};
+        size_t bounds{0};
+        std::array<uint32_t, kMaxBounds> upper{};
+        std::array<uint64_t, kMaxBounds + 1> buckets{};
+        // 按桶估计分位数：返回第 p（0~1）分位所在桶的上界，落在最后一桶时返回 max
+        uint32_t percentile(float p) const;
+    };
+
+    Histogram(const uint32_t* upper, size_t bounds); // upper 递增，超过 kMaxBounds 个的部分忽略
+
+    void record(uint32_t v);
+    Snapshot snapshot(bool reset);
+
+private:
+    std::array<uint32_t, kMaxBounds> upper_{};
+    size_t bounds_{0};
+    std::array<std::atomic<uint64_t>, kMaxBounds + 1> buckets_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint32_t> max_{0};
+};
+
+// 播放统计：计数为创建以来累计；直方图只覆盖当前统计窗口（stats(true) 开启新窗口）
+struct PlaybackTelemetryStats {
+    uint32_t window_ms{0};
+    uint64_t device_opens{0};
+    uint64_t device_open_failures{0};
+    uint64_t periods_written{0};
+    uint64_t xruns{0};
+    uint64_t underruns{0};
+    float period_us{0.0f};             // 最近打开的设备一个周期的时长
+    Histogram::Snapshot open_us;       // pcm_open 耗时
+    Histogram::Snapshot first_write_us; // 播放请求/首包 → 首个周期写入设备
+    Histogram::Snapshot write_us;      // 每周期 pcm_write 耗时（含阻塞等待设备空间）
+    Histogram::Snapshot buffer_fill_pct; // 写入前设备缓冲中待播帧的百分比，持续偏低说明写线程被延误
+};
+
+// 扬声器播放遥测：混音器、流播放与 WavPlayer 共用一个实例（三者轮流占用设备），
+// 写设备线程每周期记录一次，发布线程定期 stats(true) 取走窗口数据
+class PlaybackTelemetry {
+public:
+    PlaybackTelemetry();
+
+    void recordOpen(int64_t us, bool ok);
+    void recordFirstWrite(int64_t us);
+    void recordWrite(int64_t us);
+    void recordBufferFill(long queued_frames, long buffer_frames);
+    void recordXrun();
+    void recordUnderrun();
+    void setPeriod(uint32_t frames, uint32_t rate);
+
+    PlaybackTelemetryStats stats(bool reset_window = false);
+
+    static int64_t nowUs(); // steady_clock 微秒
+
+private:
+    Histogram open_us_;
+    Histogram first_write_us_;
+    Histogram write_us_;
+    Histogram buffer_fill_pct_;
+    std::atomic<uint64_t> device_opens_{0};
+    std::atomic<uint64_t> device_open_failures_{0};
+    std::atomic<uint64_t> periods_written_{0};
+    std::atomic<uint64_t> xruns_{0};
+    std::atomic<uint64_t> underruns_{0};
+    std::atomic<float> period_us_{0.0f};
+    std::atomic<int64_t> window_start_us_{0};
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // PLAYBACK_TELEMETRY_HPP
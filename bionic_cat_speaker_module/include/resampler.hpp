@@ -0,0 +1,93 @@
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 重采样质量档位：滤波器长度/相位数/Kaiser β 递增，CPU 开销随之增加
+enum class ResampleQuality : uint8_t {
+    Fast = 0,   // 8 抽头 × 32 相位，适合语音提示
+    Medium = 1, // 24 抽头 × 64 相位，默认
+    High = 2    // 64 抽头 × 256 相位，音乐
+};
+
+// 多相加窗 sinc 低通表：phases + 1 行，每行 taps 个系数（4 的倍数，便于 SIMD），每行和归一化为 1。
+// 行 p 对应小数相位 p / phases，作用于源帧 floor(pos) - taps/2 + 1 … floor(pos) + taps/2；
+// 相位之间线性插值，相位量化误差远低于各档的阻带衰减
+class SincKernel {
+public:
+    static constexpr size_t kMaxTaps = 256; // High 档加长 4 倍后的最大抽头数
+
+    // step：每输出帧前进的源帧数；step > 1（降采样/加速）时截止频率按 1/step 下移、抽头按比例加长以抗混叠
+    SincKernel(ResampleQuality quality, double step);
+
+    size_t taps() const { return taps_; }
+    size_t phases() const { return phases_; }
+    double cutoff() const { return cutoff_; }
+
+    // 按小数相位 frac ∈ [0, 1) 在相邻两行之间插值，写出 taps 个系数
+    void coefficients(double frac, float* out) const;
+
+    // 相同质量下截止频率相同即可共用一张表；step 按 1/8 量化，避免频繁重建
+    static double cutoffFor(double step);
+
+private:
+    size_t taps_;
+    size_t phases_;
+    double cutoff_;
+    std::vector<float> table_;
+};
+
+// 点积，n 必须为 4 的倍数；ARM 上用 NEON，x86 上用 SSE，其余走标量
+float dotProduct(const float* a, const float* b, size_t n);
+
+// 流式重采样/变速（变调）：交错 float 输入输出，小数相位与滤波器历史跨块保持，
+// 任意分块得到的输出与整段一次处理一致，块边界无跳变
+class Resampler {
+public:
+    explicit Resampler(uint16_t channels, ResampleQuality quality = ResampleQuality::Medium);
+
+    // step = 源采样率 / 目标采样率 × 速度；截止频率变化时重建滤波器表（不在每块重建）
+    void setStep(double step);
+    double step() const { return step_; }
+    uint16_t channels() const { return channels_; }
+    ResampleQuality quality() const { return quality_; }
+
+    // 处理 frames 帧输入，输出追加到 out 末尾；返回输出帧数。
+    // 输出帧 k 对应输入位置 k × step，需要 taps/2 帧前瞻，尚未凑够的部分留到下次调用
+    size_t process(const float* in, size_t frames, std::vector<float>& out);
+
+    // 流结束：补零把前瞻中剩余的输入推出
+    size_t flush(std::vector<float>& out);
+
+    // 清空历史与相位（新一轮播放前调用）
+    void reset();
+
+    // 尚未输出的已缓冲输入帧数
+    size_t pendingFrames() const;
+
+private:
+    size_t render(std::vector<float>& out, bool draining);
+    void compact();
+
+    uint16_t channels_;
+    ResampleQuality quality_;
+    double step_{1.0};
+    std::shared_ptr<const SincKernel> kernel_;
+    std::vector<std::vector<float>> hist_; // 按声道平面存储，点积可直接用连续内存
+    std::vector<float> coef_;              // 当前输出帧的插值系数，各声道共用
+    size_t ipos_{0};                       // hist_ 中下一输出帧中心的整数帧
+    double frac_{0.0};                     // 小数相位 [0, 1)；与整数部分分开，丢弃历史时不引入舍入
+    long origin_{0};                       // 输入帧 0 在 hist_ 中的位置（丢弃历史后可为负）
+    size_t fed_{0};                        // 自上次 reset 以来的真实输入帧数（flush 用）
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // RESAMPLER_HPP
@@ -9,7 +9,12 @@
 #include <iostream>
 #include "mqtt_client.hpp"
 #include "bionic_cat_mqtt_msg.hpp"
-#include "play_wav_tinyalsa.hpp"
+#include "adts_stream_player.hpp"
+#include "audio_mixer.hpp"
+#include "output_arbiter.hpp"
+#include "pcm_cache.hpp"
+#include "play_command_queue.hpp"
+#include "playback_telemetry.hpp"
 
 namespace BionicCat {
 namespace SpeakerModule {
@@ -30,8 +35,21 @@ public:
     void stop();
 
 private:
+    void handleMessage(mqtt::const_message_ptr msg);
     void handleAudioPlayCommand(mqtt::const_message_ptr msg);
-    void playCommand(const BionicCat::MqttMsgs::AudioPlayCommand& cmd);
+    void handleStreamControl(mqtt::const_message_ptr msg);
+    void handleStreamData(mqtt::const_message_ptr msg);
+    // 播放指令在专用线程上载入与执行，MQTT 回调只入队
+    void commandThread();
+    void executeCommand(const PlayCommandQueue::Ticket& t);
+    bool outputBusy(); // 有声部在播放或流播放进行中
+
+    // 流式播放与混音器共用同一 PCM 设备，二者互斥
+    bool startStream();
+    bool startStreamLocked();
+    void stopStream();
+
+    void publishPlaybackStats();
 
     std::string server_address_;
     std::string client_id_;
@@ -40,7 +58,26 @@ private:
     std::atomic<bool> running_;
 
     std::unique_ptr<BionicCat::MqttClient::MQTTSubscriber> subscriber_;
-    std::unique_ptr<WavPlayer> player_;
+    std::unique_ptr<BionicCat::MqttClient::MQTTPublisher> publisher_; // 播放统计
+    std::unique_ptr<AudioMixer> mixer_;   // 多声部混音输出，设备常开；创建/开关与流播放一样在 stream_mtx_ 下进行
+    std::shared_ptr<PcmCache> pcm_cache_; // 反复播放的短音效常驻内存（已转换为混音器声道数）
+
+    std::string subscribe_topic_stream_{"bionic_cat/speaker_audio_stream"};              // AdtsStreamDataMsg
+    std::string subscribe_topic_stream_ctrl_{"bionic_cat/speaker_audio_stream_control"}; // AdtsStreamControlMsg
+    std::mutex stream_mtx_;
+    std::unique_ptr<AdtsStreamPlayer> stream_player_;
+    // 最近一次流控制声明的编码（stream_mtx_）；未收到过控制消息时按旧版发送端的 AAC 处理
+    BionicCat::MqttMsgs::AudioCodec stream_codec_{BionicCat::MqttMsgs::AudioCodec::AAC_ADTS};
+    std::atomic<uint64_t> stream_dropped_packets_{0}; // 编码不是 AAC/ADTS 而丢弃的数据包
+    OutputArbiter stream_arbiter_; // 播放指令停掉流后，流数据不再自动开流（stream_mtx_）
+
+    static constexpr size_t kCommandQueueDepth = 16;
+    PlayCommandQueue commands_{kCommandQueueDepth};
+    std::thread cmd_thread_;
+
+    std::string publish_topic_stats_{"bionic_cat/speaker_playback_stats"}; // SpeakerPlaybackStatsMsg
+    std::shared_ptr<PlaybackTelemetry> telemetry_; // 混音器与流播放共用
+    static constexpr int kStatsIntervalMs = 5000;  // 统计发布周期
 
     int current_card_ = 0;
     int current_device_ = 0;
@@ -0,0 +1,75 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 单生产者/单消费者无锁环形缓冲（仅适用于可平凡复制的元素，如 PCM 样本）
+// 容量向上取 2 的幂；读写各自只修改自己的索引，不需要互斥锁
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing requires trivially copyable elements");
+
+public:
+    explicit SpscRing(size_t min_capacity = 0) { reset(min_capacity); }
+
+    // 非线程安全：仅在读写两端都未运行时调用
+    void reset(size_t min_capacity) {
+        size_t cap = 1;
+        while (cap < min_capacity) cap <<= 1;
+        buf_.assign(cap, T{});
+        mask_ = cap - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return buf_.size(); }
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    size_t space() const { return capacity() - size(); }
+
+    // 生产者：写入最多 n 个元素，返回实际写入数
+    size_t write(const T* src, size_t n) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        n = std::min(n, capacity() - (head - tail));
+        const size_t pos = head & mask_;
+        const size_t first = std::min(n, capacity() - pos);
+        std::memcpy(buf_.data() + pos, src, first * sizeof(T));
+        std::memcpy(buf_.data(), src + first, (n - first) * sizeof(T));
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // 消费者：读出最多 n 个元素，返回实际读出数
+    size_t read(T* dst, size_t n) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        n = std::min(n, head - tail);
+        const size_t pos = tail & mask_;
+        const size_t first = std::min(n, capacity() - pos);
+        std::memcpy(dst, buf_.data() + pos, first * sizeof(T));
+        std::memcpy(dst + first, buf_.data(), (n - first) * sizeof(T));
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    std::vector<T> buf_;
+    size_t mask_{0};
+    alignas(64) std::atomic<size_t> head_{0}; // 生产者写
+    alignas(64) std::atomic<size_t> tail_{0}; // 消费者写
+};
+
+} // namespace SpeakerModule
+} // namespace BionicCat
+
+#endif // SPSC_RING_HPP
@@ -0,0 +1,194 @@
+#include "adts_jitter_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 缓冲连续高于目标这么多帧后丢弃一帧以回收时延
+static constexpr uint32_t kShrinkAfterPops = 50;
+
+AdtsJitterBuffer::AdtsJitterBuffer(const JitterBufferConfig& cfg)
+    : cfg_(cfg) {
+    if (cfg_.capacity < 4) cfg_.capacity = 4;
+    if (cfg_.frame_ms == 0) cfg_.frame_ms = 1;
+    if (cfg_.max_delay_ms < cfg_.min_delay_ms) cfg_.max_delay_ms = cfg_.min_delay_ms;
+    frame_ms_ = static_cast<float>(cfg_.frame_ms);
+    slots_.resize(cfg_.capacity);
+    resetLocked();
+}
+
+void AdtsJitterBuffer::setFrameMs(float ms) {
+    if (!(ms > 0.0f)) return;
+    std::lock_guard<std::mutex> lk(mtx_);
+    frame_ms_ = ms;
+}
+
+float AdtsJitterBuffer::frameMs() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return frame_ms_;
+}
+
+void AdtsJitterBuffer::reset() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    resetLocked();
+}
+
+void AdtsJitterBuffer::resetLocked() {
+    for (auto& s : slots_) s.used = false;
+    count_ = 0;
+    have_next_ = false;
+    playing_ = false;
+    have_transit_ = false;
+    jitter_ms_ = 0.0f;
+    target_delay_ms_ = static_cast<float>(std::min(std::max(cfg_.initial_delay_ms, cfg_.min_delay_ms),
+                                                   cfg_.max_delay_ms));
+    over_target_pops_ = 0;
+    gap_count_ = 0;
+}
+
+void AdtsJitterBuffer::updateJitter(uint64_t pts_ms, uint64_t arrival_ms) {
+    // RFC 3550 到达间隔抖动：J += (|D| - J) / 16
+    const int64_t transit = static_cast<int64_t>(arrival_ms) - static_cast<int64_t>(pts_ms);
+    if (have_transit_) {
+        const float d = static_cast<float>(std::llabs(transit - last_transit_ms_));
+        jitter_ms_ += (d - jitter_ms_) / 16.0f;
+        const float target = frame_ms_ + cfg_.jitter_multiplier * jitter_ms_;
+        target_delay_ms_ = std::min(std::max(target, static_cast<float>(cfg_.min_delay_ms)),
+                                    static_cast<float>(cfg_.max_delay_ms));
+    }
+    have_transit_ = true;
+    last_transit_ms_ = transit;
+}
+
+uint32_t AdtsJitterBuffer::bufferedFramesLocked() const {
+    if (!have_next_ || count_ == 0) return 0;
+    const int32_t d = seqDiff(highest_seq_, next_seq_);
+    return d < 0 ? 0 : static_cast<uint32_t>(d) + 1;
+}
+
+AdtsJitterBuffer::PushResult AdtsJitterBuffer::push(uint32_t seq, uint64_t pts_ms, const uint8_t* data,
+                                                     size_t len, uint64_t arrival_ms) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    PushResult result = PushResult::Accepted;
+
+    if (have_next_) {
+        const int32_t d = seqDiff(seq, next_seq_);
+        const int32_t cap = static_cast<int32_t>(cfg_.capacity);
+        if (d >= cap || d < -4 * cap) {
+            // 远超容量：发送端重启或长时间断流，丢弃旧状态重新同步
+            resetLocked();
+            ++stats_.overflow_resets;
+            result = PushResult::Resync;
+        } else if (d < 0) {
+            if (playing_) {
+                ++stats_.late_dropped;
+                return PushResult::Late;
+            }
+            // 尚未开始播放：允许更早的包成为起点（乱序到达）
+            if (-d + bufferedFramesLocked() > cfg_.capacity) {
+                ++stats_.late_dropped;
+                return PushResult::Late;
+            }
+            next_seq_ = seq;
+        }
+    }
+
+    Slot& slot = slots_[seq % cfg_.capacity];
+    if (slot.used) {
+        if (slot.seq == seq) {
+            ++stats_.duplicates;
+            return PushResult::Duplicate;
+        }
+        // 槽位被更早的包占用只会发生在 next_seq_ 之前，已无播放机会
+        slot.used = false;
+        --count_;
+    }
+    slot.used = true;
+    slot.seq = seq;
+    slot.pts_ms = pts_ms;
+    slot.payload.assign(data, data + len);
+    ++count_;
+    ++stats_.received;
+
+    if (!have_next_) {
+        have_next_ = true;
+        next_seq_ = seq;
+        highest_seq_ = seq;
+    } else if (seqDiff(seq, highest_seq_) > 0) {
+        highest_seq_ = seq;
+    }
+    updateJitter(pts_ms, arrival_ms);
+    return result;
+}
+
+void AdtsJitterBuffer::flushGapLocked() {
+    if (gap_count_ == 0) return;
+    if (gap_cb_) gap_cb_(gap_first_, gap_count_);
+    gap_count_ = 0;
+}
+
+AdtsJitterBuffer::PopStatus AdtsJitterBuffer::pop(Packet& out) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    const float buffered_ms = static_cast<float>(bufferedFramesLocked()) * frame_ms_;
+
+    if (!playing_) {
+        if (!have_next_ || buffered_ms < target_delay_ms_) return PopStatus::Buffering;
+        playing_ = true;
+        over_target_pops_ = 0;
+    }
+
+    if (count_ == 0) {
+        // 取空：之后的包多半会晚到，先重新缓冲到目标时延；本帧按缺包隐藏
+        playing_ = false;
+        ++stats_.underruns;
+    } else if (buffered_ms > target_delay_ms_ + 2.0f * frame_ms_) {
+        if (++over_target_pops_ >= kShrinkAfterPops) {
+            // 时延长期偏高（抖动已回落）：丢弃最旧的一帧
+            over_target_pops_ = 0;
+            Slot& s = slots_[next_seq_ % cfg_.capacity];
+            if (s.used && s.seq == next_seq_) {
+                s.used = false;
+                --count_;
+            }
+            ++next_seq_;
+            ++stats_.shrink_dropped;
+        }
+    } else {
+        over_target_pops_ = 0;
+    }
+
+    Slot& slot = slots_[next_seq_ % cfg_.capacity];
+    out.seq = next_seq_;
+    ++next_seq_;
+    if (slot.used && slot.seq == out.seq) {
+        flushGapLocked();
+        out.pts_ms = slot.pts_ms;
+        out.payload.assign(slot.payload.begin(), slot.payload.end());
+        slot.used = false;
+        --count_;
+        ++stats_.played;
+        return PopStatus::Frame;
+    }
+
+    if (gap_count_ == 0) gap_first_ = out.seq;
+    ++gap_count_;
+    ++stats_.lost;
+    out.payload.clear();
+    if (count_ == 0) flushGapLocked();
+    return PopStatus::Lost;
+}
+
+JitterBufferStats AdtsJitterBuffer::stats() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    JitterBufferStats s = stats_;
+    s.jitter_ms = jitter_ms_;
+    s.target_delay_ms = target_delay_ms_;
+    s.buffered_ms = static_cast<float>(bufferedFramesLocked()) * frame_ms_;
+    return s;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,277 @@
+#include "adts_stream_player.hpp"
+#include "audio_dsp.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+
+// tinyalsa 头文件
+#if __has_include(<tinyalsa/asoundlib.h>)
+  #include <tinyalsa/asoundlib.h>
+#elif __has_include(<asoundlib.h>)
+  #include <asoundlib.h>
+#else
+  #error "tinyalsa asoundlib.h not found"
+#endif
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 环形缓冲按最大格式（48 kHz 双声道）分配，格式在首帧解出前未知
+static constexpr uint32_t kMaxRingRate = 48000;
+static constexpr uint32_t kMaxRingChannels = 2;
+
+AdtsStreamPlayer::AdtsStreamPlayer(const Config& cfg)
+    : cfg_(cfg)
+    , receiver_(cfg.jitter) {
+    if (cfg_.period_ms == 0) cfg_.period_ms = 20;
+    if (cfg_.period_count < 2) cfg_.period_count = 2;
+    if (cfg_.prefill_periods == 0) cfg_.prefill_periods = 1;
+    cfg_.ring_ms = std::max(cfg_.ring_ms, (cfg_.prefill_periods + 2) * cfg_.period_ms + cfg_.jitter.frame_ms);
+}
+
+AdtsStreamPlayer::~AdtsStreamPlayer() {
+    stop();
+}
+
+int64_t AdtsStreamPlayer::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool AdtsStreamPlayer::start() {
+    if (running_.load()) return true;
+    if (!receiver_.open()) {
+        std::cerr << "[AdtsStreamPlayer] AAC decoder open failed" << std::endl;
+        return false;
+    }
+    receiver_.jitterBuffer().reset();
+    ring_.reset(static_cast<size_t>(kMaxRingRate / 1000 * cfg_.ring_ms * kMaxRingChannels));
+    sample_rate_.store(0);
+    channels_.store(0);
+    start_ms_.store(nowMs());
+    first_packet_ms_.store(-1);
+    last_packet_ms_.store(-1);
+    startup_latency_ms_.store(-1);
+
+    running_.store(true);
+    decode_th_ = std::thread(&AdtsStreamPlayer::decodeThread, this);
+    write_th_ = std::thread(&AdtsStreamPlayer::writeThread, this);
+    std::cout << "[AdtsStreamPlayer] Started, card=" << cfg_.card << " device=" << cfg_.device << std::endl;
+    return true;
+}
+
+void AdtsStreamPlayer::stop() {
+    if (!running_.exchange(false)) return;
+    if (decode_th_.joinable()) decode_th_.join();
+    if (write_th_.joinable()) write_th_.join();
+    closePcm();
+    receiver_.close();
+
+    const StreamPlayerStats s = stats();
+    std::cout << "[AdtsStreamPlayer] Stopped: packets=" << s.packets
+              << " decoded=" << s.frames_decoded << " concealed=" << s.frames_concealed
+              << " late=" << s.jitter.late_dropped << " jb_underruns=" << s.jitter.underruns
+              << " ring_underruns=" << s.ring_underruns << " xruns=" << s.pcm_xruns
+              << " startup=" << s.startup_latency_ms << "ms" << std::endl;
+}
+
+void AdtsStreamPlayer::push(uint32_t seq, uint64_t pts_ms, const uint8_t* data, size_t len) {
+    if (!running_.load() || !data || len == 0) return;
+    const int64_t now = nowMs();
+    int64_t unset = -1;
+    first_packet_ms_.compare_exchange_strong(unset, now);
+    last_packet_ms_.store(now);
+    packets_.fetch_add(1, std::memory_order_relaxed);
+    receiver_.push(seq, pts_ms, data, len, static_cast<uint64_t>(now));
+}
+
+int64_t AdtsStreamPlayer::idleMs() const {
+    const int64_t last = last_packet_ms_.load();
+    return nowMs() - (last >= 0 ? last : start_ms_.load());
+}
+
+StreamPlayerStats AdtsStreamPlayer::stats() const {
+    StreamPlayerStats s;
+    s.packets = packets_.load();
+    s.frames_decoded = frames_decoded_.load();
+    s.frames_concealed = frames_concealed_.load();
+    s.ring_underruns = ring_underruns_.load();
+    s.pcm_xruns = pcm_xruns_.load();
+    s.startup_latency_ms = startup_latency_ms_.load();
+    s.sample_rate = sample_rate_.load();
+    s.channels = channels_.load();
+    s.jitter = receiver_.jitterBuffer().stats();
+    return s;
+}
+
+void AdtsStreamPlayer::decodeThread() {
+    std::vector<int16_t> pcm;
+    const auto idle_sleep = std::chrono::milliseconds(std::max<uint32_t>(1, cfg_.period_ms / 4));
+
+    while (running_.load()) {
+        const uint32_t rate = sample_rate_.load(std::memory_order_acquire);
+        if (first_packet_ms_.load() < 0) {
+            std::this_thread::sleep_for(idle_sleep);
+            continue;
+        }
+        if (rate != 0) {
+            // 环形缓冲只保持预填量 + 一帧，其余时延留在抖动缓冲里自适应
+            const size_t ch = channels_.load();
+            const size_t period = static_cast<size_t>(rate) * cfg_.period_ms / 1000 * ch;
+            const size_t frame = static_cast<size_t>(receiver_.decoder().frameSize()) * ch;
+            if (ring_.size() >= (cfg_.prefill_periods + 1) * period + frame) {
+                std::this_thread::sleep_for(idle_sleep);
+                continue;
+            }
+        }
+
+        const AdtsJitterBuffer::PopStatus st = receiver_.nextFrame(pcm);
+        if (pcm.empty()) {
+            // 尚未解出首帧，格式未知
+            std::this_thread::sleep_for(idle_sleep);
+            continue;
+        }
+        if (st == AdtsJitterBuffer::PopStatus::Frame) frames_decoded_.fetch_add(1, std::memory_order_relaxed);
+        else if (st == AdtsJitterBuffer::PopStatus::Lost) frames_concealed_.fetch_add(1, std::memory_order_relaxed);
+
+        if (rate == 0) {
+            channels_.store(static_cast<uint32_t>(receiver_.decoder().channels()));
+            sample_rate_.store(static_cast<uint32_t>(receiver_.decoder().sampleRate()), std::memory_order_release);
+            std::cout << "[AdtsStreamPlayer] Stream format: " << receiver_.decoder().sampleRate() << " Hz x"
+                      << receiver_.decoder().channels() << std::endl;
+        } else if (static_cast<uint32_t>(receiver_.decoder().sampleRate()) != rate) {
+            std::cerr << "[AdtsStreamPlayer] Sample rate changed mid-stream, frame dropped" << std::endl;
+            continue;
+        }
+
+        size_t off = 0;
+        while (off < pcm.size() && running_.load()) {
+            off += ring_.write(pcm.data() + off, pcm.size() - off);
+            if (off < pcm.size()) std::this_thread::sleep_for(idle_sleep);
+        }
+    }
+}
+
+bool AdtsStreamPlayer::openPcm(uint32_t rate, uint32_t channels) {
+    pcm_config cfg{};
+    std::memset(&cfg, 0, sizeof(cfg));
+    cfg.channels = channels;
+    cfg.rate = rate;
+    cfg.period_size = rate * cfg_.period_ms / 1000;
+    cfg.period_count = cfg_.period_count;
+    cfg.format = PCM_FORMAT_S16_LE;
+    cfg.start_threshold = cfg.period_size;
+    cfg.stop_threshold = cfg.period_size * cfg.period_count;
+    cfg.silence_threshold = 0;
+    cfg.avail_min = 1;
+
+    const int64_t t0 = PlaybackTelemetry::nowUs();
+    pcm_ = pcm_open(cfg_.card, cfg_.device, PCM_OUT | PCM_MONOTONIC, &cfg);
+    const bool ok = pcm_ && pcm_is_ready(pcm_);
+    if (cfg_.telemetry) {
+        cfg_.telemetry->recordOpen(PlaybackTelemetry::nowUs() - t0, ok);
+        if (ok) cfg_.telemetry->setPeriod(cfg.period_size, rate);
+    }
+    if (!ok) {
+        std::cerr << "[AdtsStreamPlayer] PCM open failed: " << (pcm_ ? pcm_get_error(pcm_) : "unknown") << std::endl;
+        closePcm();
+        return false;
+    }
+    std::cout << "[AdtsStreamPlayer] pcm_open ok, rate=" << rate << " ch=" << channels
+              << " period=" << cfg.period_size << "x" << cfg.period_count << std::endl;
+    return true;
+}
+
+void AdtsStreamPlayer::closePcm() {
+    if (pcm_) {
+        pcm_close(pcm_);
+        pcm_ = nullptr;
+    }
+}
+
+void AdtsStreamPlayer::writeThread() {
+    struct sched_param sch; sch.sched_priority = 20;
+    int pr = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sch);
+    if (pr != 0) {
+        std::cerr << "[AdtsStreamPlayer] writeThread: pthread_setschedparam failed: " << std::strerror(pr) << std::endl;
+    }
+
+    const auto poll = std::chrono::milliseconds(std::max<uint32_t>(1, cfg_.period_ms / 4));
+    uint32_t rate = 0;
+    while (running_.load() && (rate = sample_rate_.load(std::memory_order_acquire)) == 0) {
+        std::this_thread::sleep_for(poll);
+    }
+    if (!running_.load()) return;
+    const uint32_t ch = channels_.load();
+    if (!openPcm(rate, ch)) return;
+
+    const size_t period = static_cast<size_t>(rate) * cfg_.period_ms / 1000 * ch;
+    while (running_.load() && ring_.size() < cfg_.prefill_periods * period) {
+        std::this_thread::sleep_for(poll);
+    }
+    if (pcm_prepare(pcm_) != 0) {
+        std::cerr << "[AdtsStreamPlayer] pcm_prepare failed" << std::endl;
+    }
+
+    std::vector<int16_t> buf(period);
+    bool first_write = true;
+    PlaybackTelemetry* tel = cfg_.telemetry.get();
+    const long buffer_frames = static_cast<long>(pcm_get_buffer_size(pcm_));
+    while (running_.load()) {
+        const size_t n = ring_.read(buf.data(), period);
+        if (n < period) {
+            // 解码跟不上：补静音保持设备时钟，避免 xrun
+            std::fill(buf.begin() + static_cast<std::ptrdiff_t>(n), buf.end(), 0);
+            if (!first_write) {
+                ring_underruns_.fetch_add(1, std::memory_order_relaxed);
+                if (tel) tel->recordUnderrun();
+            }
+        }
+
+        const float vol = volume.load();
+        if (std::abs(vol - 1.0f) > 0.001f) {
+            bc_dsp_gain_s16(buf.data(), buf.size(), vol);
+        }
+
+        if (tel) {
+            unsigned int avail = 0;
+            struct timespec ts{};
+            // 设备未起播（首次写入前、xrun 后）时取不到时间戳，不计
+            if (pcm_get_htimestamp(pcm_, &avail, &ts) == 0) {
+                tel->recordBufferFill(buffer_frames - static_cast<long>(avail), buffer_frames);
+            }
+        }
+        const int64_t t_write = tel ? PlaybackTelemetry::nowUs() : 0;
+        int r = pcm_write(pcm_, buf.data(), static_cast<unsigned int>(buf.size() * sizeof(int16_t)));
+        if (r == 0) {
+            if (tel) tel->recordWrite(PlaybackTelemetry::nowUs() - t_write);
+            if (first_write) {
+                first_write = false;
+                const int64_t latency = nowMs() - first_packet_ms_.load();
+                startup_latency_ms_.store(latency);
+                if (tel) tel->recordFirstWrite(latency * 1000);
+                std::cout << "[AdtsStreamPlayer] First audio buffer written, startup latency=" << latency
+                          << "ms" << std::endl;
+            }
+        } else if (r == -EPIPE) {
+            pcm_xruns_.fetch_add(1, std::memory_order_relaxed);
+            if (tel) tel->recordXrun();
+            if (pcm_prepare(pcm_) != 0) {
+                std::cerr << "[AdtsStreamPlayer] Recovery failed" << std::endl;
+                break;
+            }
+        } else {
+            std::cerr << "[AdtsStreamPlayer] pcm_write error: " << r << " (" << pcm_get_error(pcm_) << ")" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(cfg_.period_ms));
+        }
+    }
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
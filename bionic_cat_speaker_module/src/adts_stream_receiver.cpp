@@ -0,0 +1,114 @@
+#include "adts_stream_receiver.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// AAC 单帧最多 2048 点（HE-AAC），按 8 通道上限预留
+static constexpr size_t kMaxDecodedSamples = 2048 * 8;
+
+// -------- AacDecoder --------
+AacDecoder::AacDecoder() = default;
+AacDecoder::~AacDecoder() { close(); }
+
+bool AacDecoder::open() {
+    close();
+    handle_ = aacDecoder_Open(TT_MP4_ADTS, 1);
+    if (!handle_) {
+        std::cerr << "[AacDecoder] aacDecoder_Open failed" << std::endl;
+        return false;
+    }
+    // 1 = 噪声替代：丢包时输出与前帧频谱包络一致的噪声并逐渐衰减，比静音/重复更自然
+    aacDecoder_SetParam(handle_, AAC_CONCEAL_METHOD, 1);
+    out_.resize(kMaxDecodedSamples);
+    sample_rate_ = channels_ = frame_size_ = 0;
+    return true;
+}
+
+void AacDecoder::close() {
+    if (handle_) {
+        aacDecoder_Close(handle_);
+        handle_ = nullptr;
+    }
+}
+
+bool AacDecoder::decodeFrame(std::vector<int16_t>& pcm, UINT flags) {
+    const AAC_DECODER_ERROR err = aacDecoder_DecodeFrame(handle_, out_.data(), static_cast<INT>(out_.size()), flags);
+    if (err != AAC_DEC_OK) {
+        std::fprintf(stderr, "aacDecoder_DecodeFrame(flags=%u): 0x%x\n", flags, err);
+        return false;
+    }
+    const CStreamInfo* info = aacDecoder_GetStreamInfo(handle_);
+    if (!info || info->frameSize <= 0 || info->numChannels <= 0) return false;
+    sample_rate_ = info->sampleRate;
+    channels_ = info->numChannels;
+    frame_size_ = info->frameSize;
+    const size_t n = static_cast<size_t>(frame_size_) * static_cast<size_t>(channels_);
+    pcm.assign(out_.begin(), out_.begin() + static_cast<std::ptrdiff_t>(n));
+    return true;
+}
+
+bool AacDecoder::decode(const uint8_t* adts, size_t len, std::vector<int16_t>& pcm) {
+    if (!handle_ || !adts || len == 0) return false;
+    UCHAR* in = const_cast<UCHAR*>(adts);
+    UINT size = static_cast<UINT>(len);
+    UINT valid = size;
+    const AAC_DECODER_ERROR err = aacDecoder_Fill(handle_, &in, &size, &valid);
+    if (err != AAC_DEC_OK) {
+        std::fprintf(stderr, "aacDecoder_Fill(): 0x%x\n", err);
+        return false;
+    }
+    return decodeFrame(pcm, 0);
+}
+
+bool AacDecoder::conceal(std::vector<int16_t>& pcm) {
+    if (!handle_ || frame_size_ == 0) return false;
+    return decodeFrame(pcm, AACDEC_CONCEAL);
+}
+
+// ADTS 头中的采样率索引（ISO/IEC 14496-3 表 1.18）
+static constexpr int kAdtsRates[13] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                       22050, 16000, 12000, 11025, 8000, 7350};
+
+// 一个 ADTS 帧的时长：(number_of_raw_data_blocks + 1) × 1024 点；头无效时返回 0
+static float adtsFrameMs(const uint8_t* p, size_t len) {
+    if (!p || len < 7 || p[0] != 0xFF || (p[1] & 0xF6) != 0xF0) return 0.0f;
+    const int rate_idx = (p[2] >> 2) & 0x0F;
+    if (rate_idx >= 13) return 0.0f;
+    const int blocks = (p[6] & 0x03) + 1;
+    return 1000.0f * static_cast<float>(1024 * blocks) / static_cast<float>(kAdtsRates[rate_idx]);
+}
+
+// -------- AdtsStreamReceiver --------
+AdtsStreamReceiver::AdtsStreamReceiver(const JitterBufferConfig& cfg)
+    : jitter_(cfg) {}
+
+AdtsJitterBuffer::PushResult AdtsStreamReceiver::push(uint32_t seq, uint64_t pts_ms, const uint8_t* data, size_t len,
+                                                      uint64_t arrival_ms) {
+    const float ms = adtsFrameMs(data, len);
+    if (ms > 0.0f && std::fabs(ms - frame_ms_) > 0.01f) {
+        frame_ms_ = ms;
+        jitter_.setFrameMs(ms);
+    }
+    return jitter_.push(seq, pts_ms, data, len, arrival_ms);
+}
+
+AdtsJitterBuffer::PopStatus AdtsStreamReceiver::nextFrame(std::vector<int16_t>& pcm) {
+    const AdtsJitterBuffer::PopStatus st = jitter_.pop(packet_);
+    if (st == AdtsJitterBuffer::PopStatus::Frame) {
+        if (decoder_.decode(packet_.payload.data(), packet_.payload.size(), pcm)) return st;
+        ++decode_errors_;
+    }
+    if (st != AdtsJitterBuffer::PopStatus::Buffering && decoder_.conceal(pcm)) {
+        return AdtsJitterBuffer::PopStatus::Lost;
+    }
+    // 缓冲中或无法隐藏（尚未解出过有效帧）：输出静音保持时钟连续
+    pcm.assign(static_cast<size_t>(decoder_.frameSize()) * static_cast<size_t>(decoder_.channels()), 0);
+    return st == AdtsJitterBuffer::PopStatus::Buffering ? st : AdtsJitterBuffer::PopStatus::Lost;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,225 @@
+#include "audio_asset.hpp"
+#include "adts_stream_receiver.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+static constexpr uint16_t kWaveFormatPcm = 0x0001;
+static constexpr uint16_t kWaveFormatExtensible = 0xFFFE;
+
+static uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// ID3v2 标签长度（含 10 字节头与可选的 10 字节尾），没有标签时为 0
+static size_t id3Size(const uint8_t* p, size_t len) {
+    if (len < 10 || std::memcmp(p, "ID3", 3) != 0) return 0;
+    // 标签长度为 syncsafe 整数，每字节只用低 7 位
+    const size_t body = (static_cast<size_t>(p[6] & 0x7F) << 21) | (static_cast<size_t>(p[7] & 0x7F) << 14) |
+                        (static_cast<size_t>(p[8] & 0x7F) << 7) | static_cast<size_t>(p[9] & 0x7F);
+    return 10 + body + ((p[5] & 0x10) ? 10 : 0);
+}
+
+// ADTS 帧头：12 位同步字 + MPEG 版本 + layer 固定为 00
+static bool isAdtsSync(const uint8_t* p) {
+    return p[0] == 0xFF && (p[1] & 0xF6) == 0xF0;
+}
+
+static WavHeader makePcmHeader(uint32_t rate, uint16_t channels, uint16_t bits, uint32_t data_size) {
+    WavHeader h{};
+    std::memcpy(h.riff, "RIFF", 4);
+    std::memcpy(h.wave, "WAVE", 4);
+    std::memcpy(h.fmt, "fmt ", 4);
+    std::memcpy(h.data, "data", 4);
+    h.fmt_size = 16;
+    h.audio_format = kWaveFormatPcm;
+    h.num_channels = channels;
+    h.sample_rate = rate;
+    h.bits_per_sample = bits;
+    h.block_align = static_cast<uint16_t>(channels * (bits / 8));
+    h.byte_rate = rate * h.block_align;
+    h.data_size = data_size;
+    h.file_size = 36 + data_size;
+    return h;
+}
+
+const char* assetFormatName(AssetFormat fmt) {
+    switch (fmt) {
+        case AssetFormat::Wav:  return "WAV";
+        case AssetFormat::Adts: return "AAC (ADTS)";
+        case AssetFormat::Flac: return "FLAC";
+        case AssetFormat::Ogg:  return "Ogg";
+        default:                return "unknown";
+    }
+}
+
+AssetFormat probeAssetFormat(const uint8_t* head, size_t len) {
+    if (len >= 12 && std::memcmp(head, "RIFF", 4) == 0 && std::memcmp(head + 8, "WAVE", 4) == 0) {
+        return AssetFormat::Wav;
+    }
+    if (len >= 4 && std::memcmp(head, "fLaC", 4) == 0) return AssetFormat::Flac;
+    if (len >= 4 && std::memcmp(head, "OggS", 4) == 0) return AssetFormat::Ogg;
+    const size_t skip = id3Size(head, len);
+    if (skip + 2 <= len && isAdtsSync(head + skip)) return AssetFormat::Adts;
+    return AssetFormat::Unknown;
+}
+
+bool readWavLayout(FILE* fp, WavLayout& layout) {
+    struct stat st{};
+    if (!fp || fstat(fileno(fp), &st) != 0) return false;
+    const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+
+    uint8_t riff[12];
+    if (std::fseek(fp, 0, SEEK_SET) != 0 || std::fread(riff, sizeof(riff), 1, fp) != 1) return false;
+    if (probeAssetFormat(riff, sizeof(riff)) != AssetFormat::Wav) return false;
+
+    bool have_fmt = false;
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    uint64_t pos = sizeof(riff);
+    while (pos + 8 <= file_size) {
+        uint8_t chunk[8];
+        if (std::fseek(fp, static_cast<long>(pos), SEEK_SET) != 0 || std::fread(chunk, sizeof(chunk), 1, fp) != 1) {
+            return false;
+        }
+        const uint64_t body = pos + 8;
+        uint64_t size = le32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            // 16 字节基本字段；EXTENSIBLE 另有 cbSize、有效位数、声道掩码与 16 字节子格式 GUID
+            uint8_t fmt[40] = {};
+            if (size < 16 || std::fread(fmt, std::min<uint64_t>(size, sizeof(fmt)), 1, fp) != 1) return false;
+            format = le16(fmt);
+            channels = le16(fmt + 2);
+            rate = le32(fmt + 4);
+            bits = le16(fmt + 14);
+            if (format == kWaveFormatExtensible && size >= 40) format = le16(fmt + 24);
+            have_fmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) {
+                std::cerr << "[AudioAsset] WAV data chunk before fmt chunk" << std::endl;
+                return false;
+            }
+            if (format != kWaveFormatPcm) {
+                std::cerr << "[AudioAsset] Unsupported WAV encoding: 0x" << std::hex << format << std::dec << std::endl;
+                return false;
+            }
+            const uint64_t avail = file_size - body;
+            if (size == 0 || size > avail) size = avail;
+            layout.data_offset = body;
+            layout.data_size = size;
+            layout.header = makePcmHeader(rate, channels, bits, static_cast<uint32_t>(std::min<uint64_t>(size, UINT32_MAX)));
+            return true;
+        }
+        // 其余块（LIST、fact、cue 等）跳过，块长为奇数时有 1 字节填充
+        pos = body + size + (size & 1);
+    }
+    std::cerr << "[AudioAsset] WAV has no data chunk" << std::endl;
+    return false;
+}
+
+static std::shared_ptr<PcmClip> loadWav(FILE* fp) {
+    WavLayout layout;
+    if (!readWavLayout(fp, layout)) return nullptr;
+    const size_t frame_bytes = static_cast<size_t>(layout.header.num_channels) * (layout.header.bits_per_sample / 8);
+    if (frame_bytes == 0) return nullptr;
+
+    auto clip = std::make_shared<PcmClip>();
+    clip->header = layout.header;
+    clip->data.resize(static_cast<size_t>(layout.data_size));
+    if (std::fseek(fp, static_cast<long>(layout.data_offset), SEEK_SET) != 0) return nullptr;
+    const size_t n = std::fread(clip->data.data(), 1, clip->data.size(), fp);
+    clip->data.resize(n - n % frame_bytes);
+    clip->data.shrink_to_fit();
+    clip->header.data_size = static_cast<uint32_t>(clip->data.size());
+    return clip;
+}
+
+static std::shared_ptr<PcmClip> decodeAdts(const std::vector<uint8_t>& file) {
+    AacDecoder dec;
+    if (!dec.open()) return nullptr;
+
+    std::vector<int16_t> pcm;
+    std::vector<int16_t> frame;
+    int rate = 0, channels = 0;
+    size_t bad_frames = 0;
+    size_t pos = id3Size(file.data(), file.size());
+    while (pos + 7 <= file.size()) {
+        const uint8_t* p = file.data() + pos;
+        const size_t len = (static_cast<size_t>(p[3] & 0x03) << 11) | (static_cast<size_t>(p[4]) << 3) | (p[5] >> 5);
+        if (!isAdtsSync(p) || len < 7 || pos + len > file.size()) {
+            ++pos; // 丢失同步（或末尾不完整的帧）：逐字节找下一个帧头
+            continue;
+        }
+        if (dec.decode(p, len, frame)) {
+            if (channels == 0) {
+                rate = dec.sampleRate();
+                channels = dec.channels();
+            }
+            if (dec.sampleRate() != rate || dec.channels() != channels) {
+                std::cerr << "[AudioAsset] ADTS format changes mid-stream, truncating" << std::endl;
+                break;
+            }
+            pcm.insert(pcm.end(), frame.begin(), frame.end());
+        } else {
+            ++bad_frames;
+        }
+        pos += len;
+    }
+    if (bad_frames > 0) std::cerr << "[AudioAsset] Skipped " << bad_frames << " undecodable ADTS frame(s)" << std::endl;
+    if (pcm.empty() || channels <= 0 || rate <= 0) return nullptr;
+
+    auto clip = std::make_shared<PcmClip>();
+    clip->data.resize(pcm.size() * sizeof(int16_t));
+    std::memcpy(clip->data.data(), pcm.data(), clip->data.size());
+    clip->header = makePcmHeader(static_cast<uint32_t>(rate), static_cast<uint16_t>(channels), 16,
+                                 static_cast<uint32_t>(clip->data.size()));
+    return clip;
+}
+
+std::shared_ptr<PcmClip> loadAudioAsset(const std::string& path) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return nullptr;
+
+    uint8_t head[64] = {};
+    const size_t head_len = std::fread(head, 1, sizeof(head), fp);
+    // ID3 标签可能比 64 字节长，ADTS 还要看标签之后的帧头，整段读入后再确认
+    AssetFormat fmt = probeAssetFormat(head, head_len);
+
+    std::shared_ptr<PcmClip> clip;
+    if (fmt == AssetFormat::Wav) {
+        clip = loadWav(fp);
+    } else if (fmt == AssetFormat::Flac || fmt == AssetFormat::Ogg) {
+        std::cerr << "[AudioAsset] " << assetFormatName(fmt) << " decoder is not bundled, convert to WAV or ADTS: "
+                  << path << std::endl;
+    } else {
+        std::vector<uint8_t> file;
+        struct stat st{};
+        if (fstat(fileno(fp), &st) == 0 && st.st_size > 0) {
+            file.resize(static_cast<size_t>(st.st_size));
+            std::fseek(fp, 0, SEEK_SET);
+            file.resize(std::fread(file.data(), 1, file.size(), fp));
+            fmt = probeAssetFormat(file.data(), file.size());
+        }
+        if (fmt == AssetFormat::Adts) clip = decodeAdts(file);
+    }
+    std::fclose(fp);
+
+    if (clip && clip->data.empty()) clip.reset();
+    if (!clip) std::cerr << "[AudioAsset] Cannot load " << assetFormatName(fmt) << " asset: " << path << std::endl;
+    return clip;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,632 @@
+#include "audio_mixer.hpp"
+#include "pcm_convert.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+// tinyalsa 头文件
+#if __has_include(<tinyalsa/asoundlib.h>)
+  #include <tinyalsa/asoundlib.h>
+#elif __has_include(<asoundlib.h>)
+  #include <asoundlib.h>
+#else
+  #error "tinyalsa asoundlib.h not found"
+#endif
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// dst = sat16(dst + src)
+static void mixSaturate(int16_t* dst, const int16_t* src, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 8 <= n; i += 8) {
+        vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), vld1q_s16(src + i)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epi16(a, b));
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = static_cast<int16_t>(std::clamp(static_cast<int32_t>(dst[i]) + src[i], -32768, 32767));
+    }
+}
+
+AudioMixer::AudioMixer(const Config& cfg)
+    : cfg_(cfg) {
+    if (cfg_.voices == 0) cfg_.voices = 1;
+    if (cfg_.channels == 0) cfg_.channels = 2;
+    if (cfg_.period_frames == 0) cfg_.period_frames = 256;
+    if (cfg_.period_count < 2) cfg_.period_count = 2;
+
+    voices_.resize(cfg_.voices);
+    tails_.reserve(cfg_.voices);
+    slots_.reset(new SlotState[cfg_.voices]);
+    pending_.reserve(64);
+    applying_.reserve(64);
+    retired_.reserve(cfg_.voices * 4);
+    retired_local_.reserve(cfg_.voices * 4);
+    stop_at_.reserve(cfg_.voices * 2);
+    mix_.resize(static_cast<size_t>(cfg_.period_frames) * cfg_.channels);
+    scratch_.resize(mix_.size());
+    coef_.resize(SincKernel::kMaxTaps);
+    gather_.resize(SincKernel::kMaxTaps);
+    ramp_delta_ = gainRampStep(static_cast<float>(cfg_.fade_ms), cfg_.rate);
+}
+
+AudioMixer::~AudioMixer() {
+    close();
+}
+
+bool AudioMixer::open() {
+    if (running_.load()) return true;
+    if (!openPcm()) return false;
+    running_.store(true);
+    th_ = std::thread(&AudioMixer::mixThread, this);
+    return true;
+}
+
+void AudioMixer::close() {
+    if (running_.exchange(false) && th_.joinable()) th_.join();
+    closePcm();
+    // 线程已停止，可直接清理
+    std::lock_guard<std::mutex> ctl(ctl_mtx_);
+    std::lock_guard<std::mutex> lk(cmd_mtx_);
+    pending_.clear();
+    for (auto& v : voices_) v = Voice{};
+    tails_.clear();
+    stop_at_.clear();
+    first_issued_us_ = 0;
+    for (size_t i = 0; i < cfg_.voices; ++i) slots_[i].id.store(0);
+    retired_.clear();
+    retired_local_.clear();
+}
+
+bool AudioMixer::openPcm() {
+    pcm_config cfg{};
+    std::memset(&cfg, 0, sizeof(cfg));
+    cfg.channels = cfg_.channels;
+    cfg.rate = cfg_.rate;
+    cfg.period_size = cfg_.period_frames;
+    cfg.period_count = cfg_.period_count;
+    cfg.format = PCM_FORMAT_S16_LE;
+    cfg.start_threshold = cfg.period_size;
+    cfg.stop_threshold = cfg.period_size * cfg.period_count;
+    cfg.silence_threshold = 0;
+    cfg.avail_min = 1;
+
+    const int64_t t0 = PlaybackTelemetry::nowUs();
+    pcm_ = pcm_open(cfg_.card, cfg_.device, PCM_OUT | PCM_MONOTONIC, &cfg);
+    const bool ok = pcm_ && pcm_is_ready(pcm_);
+    if (cfg_.telemetry) {
+        cfg_.telemetry->recordOpen(PlaybackTelemetry::nowUs() - t0, ok);
+        if (ok) cfg_.telemetry->setPeriod(cfg_.period_frames, cfg_.rate);
+    }
+    if (!ok) {
+        std::cerr << "[AudioMixer] PCM open failed: " << (pcm_ ? pcm_get_error(pcm_) : "unknown") << std::endl;
+        closePcm();
+        return false;
+    }
+    std::cout << "[AudioMixer] pcm_open ok, rate=" << cfg_.rate << " ch=" << cfg_.channels
+              << " period=" << cfg_.period_frames << "x" << cfg_.period_count
+              << " voices=" << cfg_.voices << std::endl;
+    return true;
+}
+
+void AudioMixer::closePcm() {
+    if (pcm_) {
+        pcm_close(pcm_);
+        pcm_ = nullptr;
+    }
+}
+
+// ---------------------- 控制侧 ----------------------
+
+AudioMixer::VoiceId AudioMixer::play(std::shared_ptr<const PcmClip> clip, const VoiceParams& params) {
+    if (!clip || clip->data.empty() || clip->header.sample_rate == 0) return 0;
+    if (clip->header.bits_per_sample != 16 || clip->header.num_channels != cfg_.channels) {
+        // 未经缓存预转换的片段：在控制线程转换，实时线程只处理 S16
+        clip = convertPcmClip(*clip, cfg_.channels);
+        if (!clip) return 0;
+    }
+    const uint32_t src_rate = clip->header.sample_rate;
+    Command c;
+    c.clip = std::move(clip);
+    return submit(c, src_rate, params);
+}
+
+AudioMixer::VoiceId AudioMixer::play(std::shared_ptr<PcmStream> stream, const VoiceParams& params) {
+    if (!stream || stream->sampleRate() == 0 || stream->channels() != cfg_.channels) return 0;
+    const uint32_t src_rate = stream->sampleRate();
+    Command c;
+    c.stream = std::move(stream);
+    return submit(c, src_rate, params);
+}
+
+AudioMixer::VoiceId AudioMixer::submit(Command& c, uint32_t src_rate, const VoiceParams& params) {
+    std::lock_guard<std::mutex> ctl(ctl_mtx_);
+    size_t slot = cfg_.voices;
+    for (size_t i = 0; i < cfg_.voices; ++i) {
+        if (slots_[i].id.load() == 0) { slot = i; break; }
+    }
+    if (slot == cfg_.voices && cfg_.steal != StealPolicy::None) {
+        for (size_t i = 0; i < cfg_.voices; ++i) {
+            const SlotState& c = slots_[i];
+            if (c.priority > params.priority) continue;
+            if (slot == cfg_.voices) { slot = i; continue; }
+            const SlotState& b = slots_[slot];
+            bool better = false;
+            switch (cfg_.steal) {
+                case StealPolicy::Oldest:
+                    better = c.order < b.order;
+                    break;
+                case StealPolicy::Quietest:
+                    better = c.level.load() < b.level.load();
+                    break;
+                default:
+                    better = c.priority < b.priority || (c.priority == b.priority && c.order < b.order);
+                    break;
+            }
+            if (better) slot = i;
+        }
+        if (slot != cfg_.voices) steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (slot == cfg_.voices) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    const double step = static_cast<double>(src_rate) / cfg_.rate * (params.speed > 0.0f ? params.speed : 1.0f);
+    const SincKernel* kernel = step == 1.0 ? nullptr : kernelFor(step);
+    if (c.stream) {
+        // 窗口容纳一个周期跨过的源帧加两侧抽头，分配在控制侧完成
+        const size_t taps = kernel ? kernel->taps() : 1;
+        c.stream->reserveWindow(static_cast<size_t>(std::ceil(cfg_.period_frames * step)) + taps + 4);
+    }
+
+    VoiceId id = next_gen_++;
+    if (id == 0) id = next_gen_++;
+    SlotState& st = slots_[slot];
+    st.id.store(id);
+    st.level.store(1.0f); // 刚开始的声部不应被“最安静”策略立即抢占
+    st.priority = params.priority;
+    st.order = ++order_counter_;
+
+    c.type = CmdType::Start;
+    c.slot = slot;
+    c.id = id;
+    c.kernel = kernel;
+    c.params = params;
+    c.issued_us = PlaybackTelemetry::nowUs();
+
+    std::vector<std::shared_ptr<const void>> dead;
+    {
+        std::lock_guard<std::mutex> lk(cmd_mtx_);
+        pending_.push_back(std::move(c));
+        dead.assign(std::make_move_iterator(retired_.begin()), std::make_move_iterator(retired_.end()));
+        retired_.clear();
+    }
+    started_.fetch_add(1, std::memory_order_relaxed);
+    if (params.start_at_ns != 0) scheduled_.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void AudioMixer::releaseRetired() {
+    // 流的析构要等读线程退出，在锁外进行
+    std::vector<std::shared_ptr<const void>> dead;
+    {
+        std::lock_guard<std::mutex> lk(cmd_mtx_);
+        dead.assign(std::make_move_iterator(retired_.begin()), std::make_move_iterator(retired_.end()));
+        retired_.clear();
+    }
+}
+
+const SincKernel* AudioMixer::kernelFor(double step) {
+    const double cutoff = SincKernel::cutoffFor(step);
+    for (const auto& k : kernels_) {
+        if (k->cutoff() == cutoff) return k.get();
+    }
+    kernels_.push_back(std::make_unique<const SincKernel>(cfg_.quality, step));
+    return kernels_.back().get();
+}
+
+void AudioMixer::stop(VoiceId id) {
+    if (id == 0) return;
+    releaseRetired();
+    std::lock_guard<std::mutex> ctl(ctl_mtx_);
+    for (size_t i = 0; i < cfg_.voices; ++i) {
+        if (slots_[i].id.load() == id) {
+            Command c;
+            c.type = CmdType::Stop;
+            c.slot = i;
+            c.id = id;
+            std::lock_guard<std::mutex> lk(cmd_mtx_);
+            pending_.push_back(std::move(c));
+            return;
+        }
+    }
+}
+
+void AudioMixer::stopAll(int64_t at_ns, int max_priority) {
+    releaseRetired();
+    Command c;
+    c.type = CmdType::StopAll;
+    c.params.start_at_ns = at_ns;
+    c.params.priority = max_priority;
+    std::lock_guard<std::mutex> lk(cmd_mtx_);
+    pending_.push_back(std::move(c));
+}
+
+void AudioMixer::setVolume(VoiceId id, float volume) {
+    if (id == 0) return;
+    std::lock_guard<std::mutex> ctl(ctl_mtx_);
+    for (size_t i = 0; i < cfg_.voices; ++i) {
+        if (slots_[i].id.load() == id) {
+            Command c;
+            c.type = CmdType::SetVolume;
+            c.slot = i;
+            c.id = id;
+            c.params.volume = std::max(0.0f, volume);
+            std::lock_guard<std::mutex> lk(cmd_mtx_);
+            pending_.push_back(std::move(c));
+            return;
+        }
+    }
+}
+
+bool AudioMixer::isActive(VoiceId id) const {
+    if (id == 0) return false;
+    for (size_t i = 0; i < cfg_.voices; ++i) {
+        if (slots_[i].id.load() == id) return true;
+    }
+    return false;
+}
+
+size_t AudioMixer::activeVoices() const {
+    size_t n = 0;
+    for (size_t i = 0; i < cfg_.voices; ++i) {
+        if (slots_[i].id.load() != 0) ++n;
+    }
+    return n;
+}
+
+AudioMixer::Stats AudioMixer::stats() const {
+    Stats s;
+    s.periods = periods_.load();
+    s.xruns = xruns_.load();
+    s.started = started_.load();
+    s.steals = steals_.load();
+    s.rejected = rejected_.load();
+    s.scheduled = scheduled_.load();
+    s.late_starts = late_starts_.load();
+    s.stream_underruns = stream_underruns_.load();
+    s.active = static_cast<uint32_t>(activeVoices());
+    s.peak_active = peak_active_.load();
+    return s;
+}
+
+int64_t AudioMixer::monotonicNowNs() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// ---------------------- 混音线程 ----------------------
+
+void AudioMixer::applyCommands() {
+    {
+        std::unique_lock<std::mutex> lk(cmd_mtx_, std::try_to_lock);
+        if (!lk.owns_lock()) return; // 控制侧正持锁，下个周期再取
+        applying_.swap(pending_);
+        for (auto& r : retired_local_) retired_.push_back(std::move(r));
+        retired_local_.clear();
+    }
+    for (auto& c : applying_) {
+        switch (c.type) {
+            case CmdType::Start:
+                startVoice(c);
+                break;
+            case CmdType::Stop: {
+                Voice& v = voices_[c.slot];
+                if (v.id == c.id) stopVoice(v);
+                break;
+            }
+            case CmdType::StopAll:
+                if (c.params.start_at_ns != 0 && stop_at_.size() < stop_at_.capacity()) {
+                    stop_at_.push_back({c.params.start_at_ns, c.params.priority});
+                    break;
+                }
+                for (auto& v : voices_) {
+                    if (v.id && v.priority <= c.params.priority) stopVoice(v);
+                }
+                break;
+            case CmdType::SetVolume: {
+                Voice& v = voices_[c.slot];
+                if (v.id == c.id && !v.stopping) {
+                    v.target = c.params.volume;
+                    if (v.start_ns != 0) v.gain = v.target; // 尚未出声，无需渐变
+                }
+                break;
+            }
+        }
+    }
+    applying_.clear();
+}
+
+void AudioMixer::startVoice(Command& c) {
+    Voice& v = voices_[c.slot];
+    if (v.id != 0) {
+        // 被抢占：旧声部移入尾巴淡出；尚未出声的定时声部直接丢弃
+        if (v.start_ns == 0 && tails_.size() < tails_.capacity()) {
+            v.stopping = true;
+            v.target = 0.0f;
+            tails_.push_back(std::move(v));
+        } else {
+            retireVoice(v);
+        }
+    }
+    v = Voice{};
+    v.id = c.id;
+    uint32_t src_rate = 0;
+    if (c.stream) {
+        // 流式声部的数据每个周期从窗口取；循环由读线程回绕，这里按不循环的无限长源处理
+        src_rate = c.stream->sampleRate();
+        v.stream = std::move(c.stream);
+    } else {
+        const PcmClip& clip = *c.clip;
+        v.data = reinterpret_cast<const int16_t*>(clip.data.data());
+        v.frames = clip.data.size() / (sizeof(int16_t) * cfg_.channels);
+        src_rate = clip.header.sample_rate;
+        v.loop = c.params.loop;
+    }
+    const float speed = c.params.speed > 0.0f ? c.params.speed : 1.0f;
+    v.step = static_cast<double>(src_rate) / cfg_.rate * speed;
+    v.kernel = c.kernel;
+    v.gain = v.target = std::max(0.0f, c.params.volume);
+    v.start_ns = c.params.start_at_ns;
+    v.priority = c.params.priority;
+    v.clip = std::move(c.clip);
+    // 定时声部的等待是有意的，不计入触发时延
+    if (v.start_ns == 0 && (first_issued_us_ == 0 || c.issued_us < first_issued_us_)) first_issued_us_ = c.issued_us;
+}
+
+void AudioMixer::retireVoice(Voice& v) {
+    if (v.clip) retired_local_.push_back(std::move(v.clip));
+    if (v.stream) retired_local_.push_back(std::move(v.stream));
+    v = Voice{};
+}
+
+void AudioMixer::stopVoice(Voice& v) {
+    v.stopping = true;
+    v.target = 0.0f;
+    if (v.start_ns != 0) {
+        // 尚未出声：下个周期直接结束，不在原定时刻播出淡出段
+        v.start_ns = 0;
+        v.gain = 0.0f;
+    }
+}
+
+bool AudioMixer::renderVoice(Voice& v, size_t skip, size_t frames) {
+    const size_t ch = cfg_.channels;
+    int16_t* out = scratch_.data();
+    const float dg = ramp_delta_;
+    float peak = 0.0f;
+    std::fill(out, out + skip * ch, 0);
+
+    // 片段：data[0] 为源帧 0；流：data 为窗口，origin 为窗口首帧的源帧序号，total 为窗口末尾
+    size_t origin = 0;
+    size_t total_frames = v.frames;
+    bool more = false;    // 流在窗口之后还有数据（可能尚未读到）
+    bool starved = false; // 预读没跟上：本周期余下部分补静音，位置不前进
+    const size_t half = v.kernel ? v.kernel->taps() / 2 : 0;
+    if (v.stream) {
+        const size_t i0 = static_cast<size_t>(v.pos);
+        const size_t need = static_cast<size_t>(v.pos + static_cast<double>(frames - skip) * v.step) + half + 2;
+        v.stream->fill(i0 > half ? i0 - half : 0, need);
+        v.data = v.stream->data();
+        origin = v.stream->base();
+        total_frames = v.stream->end();
+        more = !v.stream->finished();
+    }
+
+    size_t f = skip;
+    for (; f < frames; ++f) {
+        if (v.pos >= static_cast<double>(total_frames)) {
+            if (more) { starved = true; break; }
+            if (!v.loop || total_frames == 0) break;
+            v.pos = std::fmod(v.pos, static_cast<double>(total_frames));
+        }
+        const size_t i0 = static_cast<size_t>(v.pos);
+        if (more && i0 + half >= total_frames) { starved = true; break; }
+
+        v.gain = stepGain(v.gain, v.target, dg);
+
+        if (!v.kernel) {
+            // 原速且采样率一致：位置恒为整数，直接取样
+            const int16_t* a = v.data + (i0 - origin) * ch;
+            for (size_t c = 0; c < ch; ++c) {
+                const float s = a[c] * v.gain;
+                const float m = std::fabs(s);
+                if (m > peak) peak = m;
+                out[f * ch + c] = static_cast<int16_t>(std::clamp(s, -32768.0f, 32767.0f));
+            }
+        } else {
+            const size_t taps = v.kernel->taps();
+            const long first = static_cast<long>(i0) - static_cast<long>(taps / 2) + 1;
+            const long begin = static_cast<long>(origin);
+            const long total = static_cast<long>(total_frames);
+            const bool inside = first >= begin && first + static_cast<long>(taps) <= total;
+            v.kernel->coefficients(v.pos - static_cast<double>(i0), coef_.data());
+            for (size_t c = 0; c < ch; ++c) {
+                if (inside) {
+                    const int16_t* src = v.data + static_cast<size_t>(first - begin) * ch + c;
+                    for (size_t t = 0; t < taps; ++t) gather_[t] = src[t * ch];
+                } else {
+                    // 片段两端：循环时取另一端的样本，否则补零（流只会走到文件首尾）
+                    for (size_t t = 0; t < taps; ++t) {
+                        long idx = first + static_cast<long>(t);
+                        if (v.loop) idx = ((idx % total) + total) % total;
+                        gather_[t] = (idx < begin || idx >= total)
+                                         ? 0.0f
+                                         : v.data[static_cast<size_t>(idx - begin) * ch + c];
+                    }
+                }
+                const float s = dotProduct(gather_.data(), coef_.data(), taps) * v.gain;
+                const float m = std::fabs(s);
+                if (m > peak) peak = m;
+                out[f * ch + c] = static_cast<int16_t>(std::clamp(s, -32768.0f, 32767.0f));
+            }
+        }
+        v.pos += v.step;
+        if (v.stopping && v.gain <= 0.0f) { ++f; break; }
+    }
+    std::fill(out + f * ch, out + frames * ch, 0);
+    level_ = peak / 32768.0f;
+    if (starved) {
+        stream_underruns_.fetch_add(1, std::memory_order_relaxed);
+        if (cfg_.telemetry) cfg_.telemetry->recordUnderrun();
+        return !v.stopping; // 正在停止的流不再等数据，静音即终点
+    }
+    if (f < frames) return false;
+    return !(v.stopping && v.gain <= 0.0f);
+}
+
+void AudioMixer::renderPeriod(int16_t* out, int64_t out_ns) {
+    const size_t frames = cfg_.period_frames;
+    const size_t n = frames * cfg_.channels;
+    const int64_t end_ns = out_ns + static_cast<int64_t>(frames) * 1000000000LL / cfg_.rate;
+    applyCommands();
+    std::fill(mix_.begin(), mix_.end(), 0);
+
+    // 定时 stopAll：在本周期内到期的，停止在该时刻之前开始的声部（从周期边界开始淡出）
+    for (size_t i = 0; i < stop_at_.size();) {
+        const ScheduledStop st = stop_at_[i];
+        if (out_ns != 0 && st.at_ns >= end_ns) { ++i; continue; }
+        for (auto& v : voices_) {
+            if (v.id && v.priority <= st.max_priority && !(v.start_ns != 0 && v.start_ns >= st.at_ns)) stopVoice(v);
+        }
+        stop_at_[i] = stop_at_.back();
+        stop_at_.pop_back();
+    }
+
+    uint32_t active = 0;
+    for (size_t s = 0; s < cfg_.voices; ++s) {
+        Voice& v = voices_[s];
+        if (!v.id) continue;
+        size_t skip = 0;
+        if (v.start_ns != 0 && out_ns != 0) {
+            // 出声时刻换算为本周期内的帧偏移，四舍五入到最近的帧
+            const long long offset = std::llround(static_cast<double>(v.start_ns - out_ns) * cfg_.rate / 1e9);
+            if (offset >= static_cast<long long>(frames)) {
+                ++active; // 还没到，本周期不出声
+                continue;
+            }
+            if (offset < 0) late_starts_.fetch_add(1, std::memory_order_relaxed);
+            else skip = static_cast<size_t>(offset);
+        }
+        v.start_ns = 0;
+        const bool alive = renderVoice(v, skip, frames);
+        mixSaturate(mix_.data(), scratch_.data(), n);
+        slots_[s].level.store(level_);
+        if (!alive) {
+            VoiceId id = v.id;
+            slots_[s].id.compare_exchange_strong(id, 0);
+            retireVoice(v);
+        } else {
+            ++active;
+        }
+    }
+    for (size_t t = 0; t < tails_.size();) {
+        const bool alive = renderVoice(tails_[t], 0, frames);
+        mixSaturate(mix_.data(), scratch_.data(), n);
+        if (!alive) {
+            retireVoice(tails_[t]);
+            std::swap(tails_[t], tails_.back());
+            tails_.pop_back();
+        } else {
+            ++t;
+        }
+    }
+    if (active > peak_active_.load(std::memory_order_relaxed)) peak_active_.store(active, std::memory_order_relaxed);
+    std::memcpy(out, mix_.data(), n * sizeof(int16_t));
+}
+
+int64_t AudioMixer::nextOutputNs(uint64_t written_frames, long& queued_frames) {
+    const int64_t latency_ns = static_cast<int64_t>(cfg_.output_latency_us) * 1000;
+    unsigned int avail = 0;
+    struct timespec ts{};
+    if (pcm_get_htimestamp(pcm_, &avail, &ts) == 0 && (ts.tv_sec != 0 || ts.tv_nsec != 0)) {
+        // 时间戳时刻设备缓冲中还有 buffer - avail 帧未播，下一次写入的首帧紧随其后
+        const int64_t buffer = static_cast<int64_t>(pcm_get_buffer_size(pcm_));
+        const int64_t queued = std::max<int64_t>(0, buffer - static_cast<int64_t>(avail));
+        queued_frames = static_cast<long>(queued);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec +
+               queued * 1000000000LL / cfg_.rate + latency_ns;
+    }
+    // 设备尚未起播（刚打开或 prepare 之后）：已写入的帧在起播后依次播出
+    queued_frames = -1;
+    return monotonicNowNs() + static_cast<int64_t>(written_frames) * 1000000000LL / cfg_.rate + latency_ns;
+}
+
+void AudioMixer::mixThread() {
+    struct sched_param sch; sch.sched_priority = 20;
+    int pr = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sch);
+    if (pr != 0) {
+        std::cerr << "[AudioMixer] mixThread: pthread_setschedparam failed: " << std::strerror(pr) << std::endl;
+    }
+
+    std::vector<int16_t> out(mix_.size());
+    const unsigned int bytes = static_cast<unsigned int>(out.size() * sizeof(int16_t));
+    uint64_t written = 0; // 自打开/上次 prepare 以来写入的帧数
+    PlaybackTelemetry* tel = cfg_.telemetry.get();
+    const long buffer_frames = static_cast<long>(cfg_.period_frames * cfg_.period_count);
+    while (running_.load()) {
+        long queued = -1;
+        renderPeriod(out.data(), nextOutputNs(written, queued));
+        if (tel && queued >= 0) tel->recordBufferFill(queued, buffer_frames);
+        // 无论多少声部，每个周期只写一次设备
+        const int64_t t_write = tel ? PlaybackTelemetry::nowUs() : 0;
+        int r = pcm_write(pcm_, out.data(), bytes);
+        if (r == 0) {
+            written += cfg_.period_frames;
+            if (tel) {
+                const int64_t now = PlaybackTelemetry::nowUs();
+                tel->recordWrite(now - t_write);
+                if (first_issued_us_ != 0) tel->recordFirstWrite(now - first_issued_us_);
+            }
+            first_issued_us_ = 0;
+        } else if (r == -EPIPE) {
+            xruns_.fetch_add(1, std::memory_order_relaxed);
+            if (tel) tel->recordXrun();
+            written = 0;
+            if (pcm_prepare(pcm_) != 0) {
+                std::cerr << "[AudioMixer] Recovery failed" << std::endl;
+                break;
+            }
+        } else if (r != 0) {
+            std::cerr << "[AudioMixer] pcm_write error: " << r << " (" << pcm_get_error(pcm_) << ")" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(
+                std::max<uint32_t>(1, cfg_.period_frames * 1000 / cfg_.rate)));
+        }
+        periods_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
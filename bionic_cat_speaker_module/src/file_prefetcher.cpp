@@ -0,0 +1,199 @@
+#include "file_prefetcher.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+FilePrefetcher::FilePrefetcher()
+    : FilePrefetcher(Config{}) {}
+
+FilePrefetcher::FilePrefetcher(const Config& cfg)
+    : cfg_(cfg) {
+    if (cfg_.chunk_bytes == 0) cfg_.chunk_bytes = 16 * 1024;
+    // 至少容纳两块：读线程写一块的同时消费端还能取上一块
+    cfg_.ring_bytes = std::max(cfg_.ring_bytes, cfg_.chunk_bytes * 2);
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    close();
+}
+
+bool FilePrefetcher::open(const std::string& path, uint64_t offset, uint64_t length, size_t align) {
+    close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "[FilePrefetcher] open " << path << " failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        std::cerr << "[FilePrefetcher] fstat failed: " << std::strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // 区间按文件实际大小截断（data 块长度为 0 或大于文件时读到末尾），再按整帧截断，循环回绕时不错位
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    align_ = std::max<size_t>(1, align);
+    begin_ = std::min(offset, size);
+    end_ = (length == 0 || length > size - begin_) ? size : begin_ + length;
+    end_ = begin_ + (end_ - begin_) / align_ * align_;
+    pos_ = begin_;
+    advised_until_ = begin_;
+    posix_fadvise(fd_, static_cast<off_t>(begin_), static_cast<off_t>(end_ - begin_), POSIX_FADV_SEQUENTIAL);
+
+    ring_.reset(cfg_.ring_bytes);
+    chunk_.resize(cfg_.chunk_bytes);
+    quit_ = false;
+    rewind_req_ = false;
+    done_.store(begin_ >= end_);
+    consumed_.store(false);
+    bytes_read_.store(0);
+    io_errors_.store(0);
+    wraps_.store(0);
+    th_ = std::thread(&FilePrefetcher::readerThread, this);
+    return true;
+}
+
+void FilePrefetcher::close() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    if (th_.joinable()) th_.join();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+size_t FilePrefetcher::read(uint8_t* dst, size_t n) {
+    n = std::min(n, ring_.size()) / align_ * align_;
+    if (n == 0) return 0;
+    consumed_.store(true, std::memory_order_relaxed);
+    return ring_.read(dst, n);
+}
+
+bool FilePrefetcher::eof() const {
+    // done_ 在最后一块写入之后才置位，此后环形缓冲中不足一帧即为读完
+    return done_.load(std::memory_order_acquire) && ring_.size() < align_;
+}
+
+void FilePrefetcher::rewind() {
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        if (fd_ < 0 || quit_) return;
+        if (consumed_.load()) {
+            // 清空环形缓冲需要两端都停着：消费端在这里等，由读线程完成重置
+            rewind_req_ = true;
+            cv_.notify_all();
+            cv_.wait(lk, [&] { return !rewind_req_ || quit_; });
+        }
+    }
+    waitReady(cfg_.chunk_bytes, std::chrono::milliseconds(cfg_.prefill_timeout_ms));
+}
+
+bool FilePrefetcher::waitReady(size_t bytes, std::chrono::milliseconds timeout) {
+    bytes = std::min(bytes, ring_.capacity());
+    std::unique_lock<std::mutex> lk(mtx_);
+    return cv_.wait_for(lk, timeout, [&] { return quit_ || done_.load() || ring_.size() >= bytes; });
+}
+
+FilePrefetcher::Stats FilePrefetcher::stats() const {
+    Stats s;
+    s.bytes_read = bytes_read_.load();
+    s.io_errors = io_errors_.load();
+    s.wraps = wraps_.load();
+    return s;
+}
+
+void FilePrefetcher::adviseAhead(uint64_t pos) {
+    // 已提示的窗口剩一半时再往后提示一段，内核在读线程读到之前把页读进页缓存
+    if (advised_until_ >= end_ || pos + cfg_.readahead_bytes / 2 < advised_until_) return;
+    const uint64_t from = std::max(pos, advised_until_);
+    const uint64_t len = std::min<uint64_t>(cfg_.readahead_bytes, end_ - from);
+    posix_fadvise(fd_, static_cast<off_t>(from), static_cast<off_t>(len), POSIX_FADV_WILLNEED);
+    advised_until_ = from + len;
+}
+
+void FilePrefetcher::readerThread() {
+    // 创建者可能是实时线程：读线程显式回到普通调度，I/O 阻塞不影响播放线程
+    struct sched_param sch{};
+    sch.sched_priority = 0;
+    int pr = pthread_setschedparam(pthread_self(), SCHED_OTHER, &sch);
+    if (pr != 0) {
+        std::cerr << "[FilePrefetcher] readerThread: pthread_setschedparam failed: " << std::strerror(pr) << std::endl;
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (!quit_) {
+        if (rewind_req_) {
+            // 消费端阻塞在 rewind() 中，此时重置环形缓冲是安全的
+            ring_.reset(cfg_.ring_bytes);
+            pos_ = begin_;
+            advised_until_ = begin_;
+            done_.store(begin_ >= end_);
+            consumed_.store(false);
+            rewind_req_ = false;
+            cv_.notify_all();
+            continue;
+        }
+
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(chunk_.size(), end_ - pos_));
+        if (done_.load() || ring_.space() < want) {
+            // 消费端取数据时不加锁也不通知，缓冲满时短暂休眠后再看
+            cv_.wait_for(lk, std::chrono::milliseconds(5));
+            continue;
+        }
+
+        lk.unlock();
+        adviseAhead(pos_);
+        ssize_t n;
+        do {
+            n = pread(fd_, chunk_.data(), want, static_cast<off_t>(pos_));
+        } while (n < 0 && errno == EINTR);
+        const int err = errno;
+        lk.lock();
+        if (quit_ || rewind_req_) continue; // 本块作废，回绕后从头读
+
+        if (n <= 0) {
+            // 读错误或文件被截短：按区间结束处理，消费端读完已有数据后看到 eof
+            if (n < 0) {
+                io_errors_.fetch_add(1);
+                std::cerr << "[FilePrefetcher] pread failed: " << std::strerror(err) << std::endl;
+            }
+            done_.store(true);
+            cv_.notify_all();
+            continue;
+        }
+
+        ring_.write(chunk_.data(), static_cast<size_t>(n));
+        pos_ += static_cast<uint64_t>(n);
+        bytes_read_.fetch_add(static_cast<uint64_t>(n));
+        if (pos_ >= end_) {
+            if (loop_.load()) {
+                pos_ = begin_;
+                advised_until_ = begin_;
+                wraps_.fetch_add(1);
+            } else {
+                done_.store(true);
+            }
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,24 @@
+#include "output_arbiter.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+void OutputArbiter::onCommandStoppedStream(int64_t now_ms) {
+    latched_ = true;
+    last_data_ms_ = now_ms;
+}
+
+bool OutputArbiter::allowAutoStart(int64_t now_ms) {
+    if (!latched_) return true;
+    if (now_ms - last_data_ms_ > idle_timeout_ms_) {
+        // 被停掉的流已经停发，这是新的流
+        latched_ = false;
+        return true;
+    }
+    last_data_ms_ = now_ms;
+    ++suppressed_;
+    return false;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,152 @@
+#include "pcm_cache.hpp"
+#include "audio_asset.hpp"
+#include "pcm_convert.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+PcmCache::PcmCache(size_t max_bytes, size_t max_entry_bytes)
+    : max_bytes_(max_bytes)
+    , max_entry_bytes_(max_entry_bytes ? max_entry_bytes : max_bytes / 4) {}
+
+std::shared_ptr<const PcmClip> PcmCache::get(const std::string& path) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return nullptr;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto it = index_.find(path);
+        if (it != index_.end()) {
+            const Entry& e = *it->second;
+            if (e.mtime.tv_sec == st.st_mtim.tv_sec && e.mtime.tv_nsec == st.st_mtim.tv_nsec &&
+                e.file_size == st.st_size) {
+                lru_.splice(lru_.begin(), lru_, it->second);
+                ++stats_.hits;
+                return e.clip;
+            }
+            // 文件已被替换：丢弃旧条目
+            stats_.bytes -= e.clip->data.size();
+            lru_.erase(it->second);
+            index_.erase(it);
+        }
+        ++stats_.misses;
+        if (static_cast<size_t>(st.st_size) > max_entry_bytes_) {
+            ++stats_.too_large;
+            return nullptr;
+        }
+    }
+
+    // 读盘不持锁，避免阻塞其他命中
+    auto clip = loadFile(path);
+    if (!clip) return nullptr;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (clip->data.size() > max_entry_bytes_) {
+        // 压缩资源解码（或转换声道/位深）后超过单条上限：不入缓存，但直接返回，避免调用方再解码一次
+        ++stats_.too_large;
+        return clip;
+    }
+    auto it = index_.find(path);
+    if (it != index_.end()) {
+        // 并发加载了同一文件，以先入者为准
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->clip;
+    }
+    lru_.push_front(Entry{path, st.st_mtim, st.st_size, clip});
+    index_[path] = lru_.begin();
+    stats_.bytes += clip->data.size();
+    evictLocked();
+    return clip;
+}
+
+std::shared_ptr<const PcmClip> PcmCache::loadFile(const std::string& path) const {
+    // WAV 按 RIFF 块读出 data，ADTS 等压缩资源在这里整段解码
+    std::shared_ptr<PcmClip> clip = BionicCat::SpeakerModule::loadAudioAsset(path);
+    if (!clip) {
+        std::cerr << "[PcmCache] Not a cacheable audio asset: " << path << std::endl;
+        return nullptr;
+    }
+    if (convert_) return convertPcmClip(*clip, out_channels_);
+    return clip;
+}
+
+std::shared_ptr<const PcmClip> PcmCache::loadUncached(const std::string& path, size_t max_file_bytes) const {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return nullptr;
+    if (max_file_bytes != 0 && static_cast<size_t>(st.st_size) > max_file_bytes) {
+        std::cerr << "[PcmCache] Too large to load into memory (" << st.st_size << " bytes): " << path << std::endl;
+        return nullptr;
+    }
+    return loadFile(path);
+}
+
+void PcmCache::setOutputChannels(uint16_t channels) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    out_channels_ = channels;
+    convert_ = true;
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+std::shared_ptr<const PcmClip> convertPcmClip(const PcmClip& src, uint16_t channels) {
+    const uint16_t in_ch = src.header.num_channels;
+    const uint16_t bits = src.header.bits_per_sample;
+    const size_t bps = bits / 8;
+    if (in_ch == 0 || (bits != 8 && bits != 16 && bits != 24 && bits != 32)) return nullptr;
+    const uint16_t out_ch = channels ? channels : in_ch;
+    if (in_ch > BionicCat::SpeakerModule::kMaxPcmChannels || out_ch > BionicCat::SpeakerModule::kMaxPcmChannels) {
+        return nullptr;
+    }
+
+    auto out = std::make_shared<PcmClip>();
+    out->header = src.header;
+    if (bits == 16 && out_ch == in_ch) {
+        out->data = src.data;
+        return out;
+    }
+
+    const size_t frames = src.data.size() / (in_ch * bps);
+    out->data.resize(frames * out_ch * sizeof(int16_t));
+    BionicCat::SpeakerModule::convertFramesToS16(src.data.data(), frames, in_ch, bits, reinterpret_cast<int16_t*>(out->data.data()), out_ch);
+
+    out->header.num_channels = out_ch;
+    out->header.bits_per_sample = 16;
+    out->header.block_align = static_cast<uint16_t>(out_ch * 2);
+    out->header.byte_rate = out->header.sample_rate * out->header.block_align;
+    out->header.data_size = static_cast<uint32_t>(out->data.size());
+    return out;
+}
+
+void PcmCache::evictLocked() {
+    // 至少保留最新一条
+    while (stats_.bytes > max_bytes_ && lru_.size() > 1) {
+        const Entry& e = lru_.back();
+        stats_.bytes -= e.clip->data.size();
+        index_.erase(e.path);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+void PcmCache::clear() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+void PcmCache::setMaxBytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    max_bytes_ = max_bytes;
+    evictLocked();
+}
+
+PcmCache::Stats PcmCache::stats() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    Stats s = stats_;
+    s.entries = lru_.size();
+    return s;
+}
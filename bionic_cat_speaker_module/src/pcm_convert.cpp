@@ -0,0 +1,119 @@
+#include "pcm_convert.hpp"
+
+#include "audio_dsp.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+void s16ToFloat(const int16_t* in, float* out, size_t n) {
+    bc_dsp_s16_to_float(in, out, n);
+}
+
+void floatToS16(const float* in, float gain, int16_t* out, size_t n) {
+    bc_dsp_float_to_s16(in, out, n, gain);
+}
+
+bool pcmToFloat(const uint8_t* in, size_t samples, uint16_t bits, float* out) {
+    switch (bits) {
+        case 8:
+            for (size_t i = 0; i < samples; ++i) out[i] = (static_cast<int>(in[i]) - 128) * (1.0f / 128.0f);
+            return true;
+        case 16:
+            s16ToFloat(reinterpret_cast<const int16_t*>(in), out, samples);
+            return true;
+        case 24:
+            for (size_t i = 0; i < samples; ++i) {
+                const uint8_t* s = in + i * 3;
+                // 放到 32 位高 24 位再算术右移，完成符号扩展
+                const int32_t v = static_cast<int32_t>((static_cast<uint32_t>(s[0]) << 8) |
+                                                       (static_cast<uint32_t>(s[1]) << 16) |
+                                                       (static_cast<uint32_t>(s[2]) << 24)) >> 8;
+                out[i] = static_cast<float>(v) * (1.0f / 8388608.0f);
+            }
+            return true;
+        case 32:
+            for (size_t i = 0; i < samples; ++i) {
+                int32_t v;
+                std::memcpy(&v, in + i * 4, sizeof(v));
+                out[i] = static_cast<float>(v) * (1.0f / 2147483648.0f);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+void remixChannels(const float* in, uint16_t in_ch, float* out, uint16_t out_ch, size_t frames) {
+    if (in_ch == out_ch) {
+        std::memcpy(out, in, frames * in_ch * sizeof(float));
+        return;
+    }
+    if (in_ch == 1) {
+        for (size_t f = 0; f < frames; ++f) {
+            for (size_t c = 0; c < out_ch; ++c) out[f * out_ch + c] = in[f];
+        }
+        return;
+    }
+    if (out_ch > in_ch) {
+        for (size_t f = 0; f < frames; ++f) {
+            for (size_t c = 0; c < out_ch; ++c) out[f * out_ch + c] = in[f * in_ch + c % in_ch];
+        }
+        return;
+    }
+    // 降混：每个输出声道取同余输入声道的均值
+    for (size_t c = 0; c < out_ch; ++c) {
+        size_t count = 0;
+        for (size_t i = c; i < in_ch; i += out_ch) ++count;
+        const float k = 1.0f / static_cast<float>(count);
+        for (size_t f = 0; f < frames; ++f) {
+            float s = 0.0f;
+            for (size_t i = c; i < in_ch; i += out_ch) s += in[f * in_ch + i];
+            out[f * out_ch + c] = s * k;
+        }
+    }
+}
+
+void convertFramesToS16(const uint8_t* in, size_t frames, uint16_t in_ch, uint16_t bits, int16_t* out, uint16_t out_ch) {
+    if (bits == 16 && in_ch == out_ch) {
+        std::memcpy(out, in, frames * in_ch * sizeof(int16_t));
+        return;
+    }
+    // 两块各 8 KB；每块帧数按较宽一侧的声道数折算
+    constexpr size_t kBlockSamples = 2048;
+    float src[kBlockSamples];
+    float dst[kBlockSamples];
+    const size_t block = kBlockSamples / std::max(in_ch, out_ch);
+    const size_t in_frame_bytes = static_cast<size_t>(in_ch) * (bits / 8);
+    while (frames > 0) {
+        const size_t n = std::min(frames, block);
+        pcmToFloat(in, n * in_ch, bits, src);
+        remixChannels(src, in_ch, dst, out_ch, n);
+        floatToS16(dst, 1.0f, out, n * out_ch);
+        in += n * in_frame_bytes;
+        out += n * out_ch;
+        frames -= n;
+    }
+}
+
+float gainRampStep(float fade_ms, uint32_t rate) {
+    if (fade_ms <= 0.0f || rate == 0) return 0.0f;
+    return 1000.0f / (fade_ms * static_cast<float>(rate));
+}
+
+size_t applyGainRamp(float* x, size_t frames, uint16_t ch, float& gain, float target, float step) {
+    float g = step > 0.0f ? gain : target;
+    size_t f = 0;
+    for (; f < frames && g != target; ++f) {
+        g = stepGain(g, target, step);
+        float* p = x + f * ch;
+        for (size_t c = 0; c < ch; ++c) p[c] *= g;
+    }
+    gain = g;
+    return f;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
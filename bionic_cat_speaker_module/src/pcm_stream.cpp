@@ -0,0 +1,91 @@
+#include "pcm_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "audio_asset.hpp"
+#include "pcm_convert.hpp"
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+PcmStream::PcmStream(const FilePrefetcher::Config& cfg, uint16_t out_channels, bool loop)
+    : file_(cfg)
+    , out_channels_(out_channels)
+    , loop_(loop) {}
+
+PcmStream::~PcmStream() {
+    file_.close();
+}
+
+std::shared_ptr<PcmStream> PcmStream::open(const std::string& path, uint16_t out_channels, bool loop,
+                                           const FilePrefetcher::Config& cfg) {
+    if (out_channels == 0 || out_channels > kMaxPcmChannels) return nullptr;
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) {
+        std::perror("[PcmStream] fopen failed");
+        return nullptr;
+    }
+    uint8_t head[12] = {};
+    const size_t head_len = std::fread(head, 1, sizeof(head), fp);
+    if (probeAssetFormat(head, head_len) != AssetFormat::Wav) {
+        std::fclose(fp);
+        return nullptr;
+    }
+    WavLayout layout;
+    const bool ok = readWavLayout(fp, layout);
+    std::fclose(fp);
+    const uint16_t bits = layout.header.bits_per_sample;
+    if (!ok || layout.header.num_channels == 0 || layout.header.num_channels > kMaxPcmChannels ||
+        layout.header.sample_rate == 0 ||
+        (bits != 8 && bits != 16 && bits != 24 && bits != 32)) {
+        std::cerr << "[PcmStream] Invalid or unsupported WAV: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<PcmStream> s(new PcmStream(cfg, out_channels, loop));
+    s->header_ = layout.header;
+    s->frame_bytes_ = static_cast<size_t>(layout.header.num_channels) * (bits / 8);
+    // 回绕标志须在读线程启动前设好：读线程可能在第一次调度时就读到区间末尾
+    s->file_.setLoop(loop);
+    if (!s->file_.open(path, layout.data_offset, layout.data_size, s->frame_bytes_)) return nullptr;
+    // 起播前等首段数据（循环时含回绕后的数据），混音线程第一个周期就有数据可取
+    const size_t prefill = loop ? cfg.ring_bytes / 2
+                                : static_cast<size_t>(std::min<uint64_t>(cfg.ring_bytes / 2, layout.data_size));
+    if (!s->file_.waitReady(prefill, std::chrono::milliseconds(cfg.prefill_timeout_ms))) {
+        std::cerr << "[PcmStream] Prefetch not ready after " << cfg.prefill_timeout_ms << " ms: " << path << std::endl;
+    }
+    return s;
+}
+
+void PcmStream::reserveWindow(size_t frames) {
+    window_frames_ = std::max<size_t>(frames, 1);
+    window_.assign(window_frames_ * out_channels_, 0);
+    raw_.resize(window_frames_ * frame_bytes_);
+    base_ = 0;
+    count_ = 0;
+}
+
+void PcmStream::fill(size_t keep_from, size_t need_end) {
+    const size_t ch = out_channels_;
+    if (keep_from > base_ && count_ > 0) {
+        const size_t drop = std::min(keep_from - base_, count_);
+        std::memmove(window_.data(), window_.data() + drop * ch, (count_ - drop) * ch * sizeof(int16_t));
+        count_ -= drop;
+        base_ += drop;
+    }
+    while (end() < need_end && count_ < window_frames_) {
+        const size_t want = std::min(window_frames_ - count_, need_end - end());
+        const size_t n = file_.read(raw_.data(), want * frame_bytes_) / frame_bytes_;
+        if (n == 0) break;
+        convertFramesToS16(raw_.data(), n, header_.num_channels, header_.bits_per_sample,
+                           window_.data() + count_ * ch, out_channels_);
+        count_ += n;
+    }
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -0,0 +1,128 @@
+#include "play_command_queue.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+using BionicCat::MqttMsgs::AudioPlayMode;
+
+static constexpr uint8_t kStopPriority = 255; // 停止指令作废所有优先级的排队指令
+
+PlayCommandQueue::PlayCommandQueue(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {
+    pending_.reserve(capacity_);
+}
+
+bool PlayCommandQueue::replaces(const Command& cmd) {
+    return isStop(cmd) || cmd.mode == AudioPlayMode::REPLACE;
+}
+
+void PlayCommandQueue::removeAt(size_t i) {
+    pending_.erase(pending_.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+void PlayCommandQueue::push(const Command& cmd) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (closed_) return;
+        const uint64_t seq = next_seq_++;
+        ++stats_.submitted;
+
+        const bool replace = replaces(cmd);
+        const uint8_t p = isStop(cmd) ? kStopPriority : cmd.priority;
+        if (replace) {
+            const size_t before = pending_.size();
+            pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                          [p](const Ticket& t) { return t.cmd.priority <= p; }),
+                           pending_.end());
+            stats_.coalesced += before - pending_.size();
+        }
+
+        if (pending_.size() >= capacity_) {
+            // 挤掉优先级最低、最早入队的一条
+            size_t victim = 0;
+            for (size_t i = 1; i < pending_.size(); ++i) {
+                const Ticket& c = pending_[i];
+                const Ticket& v = pending_[victim];
+                if (c.cmd.priority < v.cmd.priority || (c.cmd.priority == v.cmd.priority && c.seq < v.seq)) victim = i;
+            }
+            ++stats_.overflowed;
+            if (pending_[victim].cmd.priority > p) return;
+            removeAt(victim);
+        }
+
+        if (replace) {
+            for (size_t i = 0; i <= p; ++i) replace_floor_[i] = seq;
+        }
+
+        pending_.push_back(Ticket{seq, cmd});
+        stats_.peak_depth = std::max(stats_.peak_depth, pending_.size());
+        ++version_;
+    }
+    cv_.notify_all();
+}
+
+bool PlayCommandQueue::pop(Ticket& out, bool output_busy) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (;;) {
+        size_t best = pending_.size();
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            const Ticket& c = pending_[i];
+            if (output_busy && c.cmd.mode == AudioPlayMode::ENQUEUE && !isStop(c.cmd)) continue;
+            if (best == pending_.size()) { best = i; continue; }
+            const Ticket& b = pending_[best];
+            if (c.cmd.priority > b.cmd.priority || (c.cmd.priority == b.cmd.priority && c.seq < b.seq)) best = i;
+        }
+        if (best == pending_.size()) return false;
+
+        Ticket& t = pending_[best];
+        if (output_busy && t.cmd.mode == AudioPlayMode::DROP_IF_BUSY && !isStop(t.cmd)) {
+            ++stats_.dropped_busy;
+            removeAt(best);
+            continue;
+        }
+        out = std::move(t);
+        removeAt(best);
+        ++stats_.taken;
+        return true;
+    }
+}
+
+bool PlayCommandQueue::superseded(const Ticket& t) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (replace_floor_[t.cmd.priority] <= t.seq) return false;
+    ++stats_.coalesced;
+    return true;
+}
+
+uint64_t PlayCommandQueue::version() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return version_;
+}
+
+void PlayCommandQueue::waitChanged(uint64_t version, int timeout_ms) {
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_.wait_for(lk, std::chrono::milliseconds(timeout_ms), [&] { return version_ != version || closed_; });
+}
+
+void PlayCommandQueue::close() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        closed_ = true;
+        pending_.clear();
+        ++version_;
+    }
+    cv_.notify_all();
+}
+
+PlayCommandQueue::Stats PlayCommandQueue::stats() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    Stats s = stats_;
+    s.depth = pending_.size();
+    return s;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
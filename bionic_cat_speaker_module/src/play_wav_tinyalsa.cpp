@@ -1,4 +1,10 @@
 #include "play_wav_tinyalsa.hpp"
+#include "pcm_cache.hpp"
+#include "file_prefetcher.hpp"
+#include "audio_asset.hpp"
+#include "pcm_convert.hpp"
+#include "playback_telemetry.hpp"
+#include "audio_dsp.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -44,7 +50,19 @@ void WavPlayer::ensureThreadStarted() {
     thread_started_ = true;
 }
 
+void WavPlayer::fadeOut() {
+    fade_stop_.store(true);
+}
+
 void WavPlayer::stop() {
+    // 先请求淡出，等播放线程把最后一块淡到静音写完；超时（设备卡住等）再强制停止
+    fadeOut();
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        const float fade = std::max(0.0f, fade_ms.load());
+        const auto timeout = std::chrono::microseconds(static_cast<int64_t>(fade * 1000.0f) + 100000);
+        cv_.wait_for(lk, timeout, [&]{ return !playing_.load() || !thread_started_; });
+    }
     // 停止当前播放，但不回收线程
     {
         std::lock_guard<std::mutex> lk(mtx_);
@@ -53,8 +71,8 @@ void WavPlayer::stop() {
     cv_.notify_all();
 
     // 等待播放线程把 playing_ 置为 false（非强制 join）
-    // 保留文件句柄关闭
-    if (fp_) { std::fclose(fp_); fp_ = nullptr; }
+    // 释放预读器（关闭文件），再次播放需重新 load()
+    std::atomic_store(&prefetch_, std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher>());
     playing_.store(false);
 }
 
@@ -86,13 +104,11 @@ void WavPlayer::stopPlaybackThread() {
 
     playing_.store(false);
 
-    if (fp_) {
-        std::fclose(fp_);
-        fp_ = nullptr;
-    }
+    std::atomic_store(&prefetch_, std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher>());
 }
 
 void WavPlayer::closeDevice() {
+    std::lock_guard<std::mutex> lk(dev_mtx_);
     if (pcm_) {
         pcm_close(pcm_);
         pcm_ = nullptr;
@@ -104,78 +120,197 @@ void WavPlayer::closeDevice() {
     device_opened_ = false;
     last_channels_ = 0;
     last_rate_ = 0;
-    last_bits_ = 0;
     last_card_ = -1;
     last_device_ = -1;
 }
 
 bool WavPlayer::load(int card, int device) {
    // 不销毁线程，仅准备资源
+    if (!loadSource()) return false;
+    if (!openPcm(card, device)) {
+        std::atomic_store(&prefetch_, std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher>());
+        return false;
+    }
+    return true;
+}
+
+bool WavPlayer::loadSource() {
     if (file_path.empty()) {
         std::cerr << "[WavPlayer] Error: file_path is empty" << std::endl;
         return false;
     }
 
-    fp_ = std::fopen(file_path.c_str(), "rb");
-    if (!fp_) {
+    // 先查 PCM 缓存：命中则整段数据已在内存
+    std::shared_ptr<const PcmClip> clip = cache_ ? cache_->get(file_path) : nullptr;
+    std::atomic_store(&prefetch_, std::shared_ptr<BionicCat::SpeakerModule::FilePrefetcher>());
+
+    fp_ = clip ? nullptr : std::fopen(file_path.c_str(), "rb");
+    if (!clip && !fp_) {
         std::perror("[WavPlayer] fopen failed");
+        std::atomic_store(&clip_, clip);
         return false;
     }
+    if (fp_) {
+        uint8_t head[12] = {};
+        const size_t head_len = std::fread(head, 1, sizeof(head), fp_);
+        if (BionicCat::SpeakerModule::probeAssetFormat(head, head_len) != BionicCat::SpeakerModule::AssetFormat::Wav) {
+            // 压缩资源（AAC/ADTS）不流式读：载入时整段解码到内存，之后与缓存命中相同
+            std::fclose(fp_);
+            fp_ = nullptr;
+            clip = BionicCat::SpeakerModule::loadAudioAsset(file_path);
+            if (!clip) {
+                std::atomic_store(&clip_, clip);
+                return false;
+            }
+        }
+    }
+
+    std::atomic_store(&clip_, clip);
+    if (clip) {
+        header_ = clip->header;
+        if (!sourceFormatSupported()) {
+            std::atomic_store(&clip_, std::shared_ptr<const PcmClip>());
+            return false;
+        }
+        return true;
+    }
 
-    if (!readHeader()) {
+    const bool ok = readHeader() && sourceFormatSupported();
+    std::fclose(fp_);
+    fp_ = nullptr;
+    if (!ok) {
         std::cerr << "[WavPlayer] Error: Invalid WAV header" << std::endl;
-        std::fclose(fp_);
-        fp_ = nullptr;
         return false;
     }
 
-    if (!openPcm(card, device)) {
-        std::fclose(fp_);
-        fp_ = nullptr;
+    // 数据区交给预读线程读取，播放线程只从环形缓冲取数据
+    const size_t frameBytes = static_cast<size_t>(header_.num_channels) * (header_.bits_per_sample / 8);
+    auto prefetch = std::make_shared<BionicCat::SpeakerModule::FilePrefetcher>();
+    if (!prefetch->open(file_path, static_cast<uint64_t>(data_start_pos_), header_.data_size, frameBytes)) {
         return false;
     }
-
+    std::atomic_store(&prefetch_, prefetch);
     return true;
 }
 
 bool WavPlayer::play() {
-    if (!fp_ || !pcm_) {
+    if ((!std::atomic_load(&prefetch_) && !std::atomic_load(&clip_)) || !pcm_) {
         std::cerr << "[WavPlayer] Error: Not loaded" << std::endl;
         return false;
     }
 
     ensureThreadStarted();
 
+    trigger_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
     {
         std::lock_guard<std::mutex> lk(mtx_);
         stop_flag_.store(false);
+        fade_stop_.store(false);
         play_request_.store(true);
     }
     cv_.notify_all();
     return true;
 }
 
+void WavPlayer::setWarmStandby(bool on) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        warm_standby_.store(on);
+    }
+    if (on && pcm_) ensureThreadStarted();
+    cv_.notify_all();
+}
+
+void WavPlayer::setOutputFormat(uint32_t rate, uint16_t channels) {
+    if (rate > 0) out_rate_ = rate;
+    if (channels > 0) out_channels_ = channels;
+}
+
+bool WavPlayer::warmUp(int card, int device) {
+    if (!openPcm(card, device)) return false;
+    setWarmStandby(true);
+    ensureThreadStarted();
+    return true;
+}
+
+WavPlayer::TriggerLatency WavPlayer::lastTriggerLatency() const {
+    std::lock_guard<std::mutex> lk(lat_mtx_);
+    return last_latency_;
+}
+
+WavPlayer::PlaybackStats WavPlayer::playbackStats() const {
+    PlaybackStats s;
+    s.reader_underruns = reader_underruns_.load();
+    s.device_xruns = device_xruns_.load();
+    if (auto prefetch = std::atomic_load(&prefetch_)) {
+        const auto ps = prefetch->stats();
+        s.prefetch_io_errors = ps.io_errors;
+        s.prefetched_bytes = ps.bytes_read;
+    }
+    return s;
+}
+
+bool WavPlayer::beginRender() {
+    if (playing_.load()) {
+        std::cerr << "[WavPlayer] Error: cannot render offline while playing" << std::endl;
+        return false;
+    }
+    if (!rewindSource(render_cur_)) {
+        std::cerr << "[WavPlayer] Error: Not loaded" << std::endl;
+        return false;
+    }
+    render_cur_.blocking = true; // 离线渲染不是实时的，等待预读而不是补静音
+    fade_stop_.store(false);
+    resetSpeedState();
+    render_end_ = false;
+    return true;
+}
+
+bool WavPlayer::renderNext(std::vector<int16_t>& out) {
+    if (render_end_) return false;
+    if (!produceBlock(render_cur_, render_in_, render_out_)) {
+        render_end_ = true;
+        return false;
+    }
+    const int16_t* p = reinterpret_cast<const int16_t*>(render_out_.data());
+    out.insert(out.end(), p, p + render_out_.size() / sizeof(int16_t));
+    if (faded_out_) render_end_ = true;
+    return true;
+}
+
 // ---------------------- 内部实现细节 ----------------------
 
 bool WavPlayer::readHeader() {
-    if (!fp_) return false;
-    if (fseek(fp_, 0, SEEK_SET) != 0) return false;
-    if (fread(&header_, sizeof(header_), 1, fp_) != 1) return false;
-    if (std::strncmp(header_.riff, "RIFF", 4) != 0 || std::strncmp(header_.wave, "WAVE", 4) != 0) {
+    // 按 RIFF 块查找 fmt/data，data 前可以有 LIST、fact 等块
+    BionicCat::SpeakerModule::WavLayout layout;
+    if (!BionicCat::SpeakerModule::readWavLayout(fp_, layout)) return false;
+    header_ = layout.header;
+    data_start_pos_ = static_cast<long>(layout.data_offset);
+    return true;
+}
+
+bool WavPlayer::sourceFormatSupported() const {
+    const uint16_t bits = header_.bits_per_sample;
+    if (bits != 8 && bits != 16 && bits != 24 && bits != 32) {
+        std::cerr << "[WavPlayer] Unsupported bit depth: " << bits << std::endl;
+        return false;
+    }
+    if (header_.num_channels == 0 || header_.sample_rate == 0) {
+        std::cerr << "[WavPlayer] Invalid format: ch=" << header_.num_channels
+                  << " rate=" << header_.sample_rate << std::endl;
         return false;
     }
-    data_start_pos_ = ftell(fp_);
     return true;
 }
 
 bool WavPlayer::openPcm(int card, int device) {
-    // 尝试复用
+    // 设备格式固定，与源文件无关：同一声卡/设备直接复用
     if (device_opened_ &&
         last_card_ == card &&
         last_device_ == device &&
-        last_channels_ == header_.num_channels &&
-        last_rate_ == header_.sample_rate &&
-        last_bits_ == header_.bits_per_sample) {
+        last_channels_ == out_channels_ &&
+        last_rate_ == out_rate_) {
         return true; 
     }
 
@@ -184,8 +319,8 @@ bool WavPlayer::openPcm(int card, int device) {
     // 分配并填充 cfg_
     cfg_ = new pcm_config{};
     std::memset(cfg_, 0, sizeof(pcm_config));
-    cfg_->channels = header_.num_channels;
-    cfg_->rate = header_.sample_rate;
+    cfg_->channels = out_channels_;
+    cfg_->rate = out_rate_;
     // 缓冲区设置：较大以防断流
     cfg_->period_size = 1024; 
     cfg_->period_count = 4;
@@ -194,16 +329,7 @@ bool WavPlayer::openPcm(int card, int device) {
     cfg_->silence_threshold = 0;
     cfg_->avail_min = 1;
 
-    switch (header_.bits_per_sample) {
-        case 8:  cfg_->format = PCM_FORMAT_S8; break;
-        case 16: cfg_->format = PCM_FORMAT_S16_LE; break;
-        case 24: cfg_->format = PCM_FORMAT_S24_LE; break;
-        case 32: cfg_->format = PCM_FORMAT_S32_LE; break;
-        default:
-            std::cerr << "[WavPlayer] Unsupported bit depth: " << header_.bits_per_sample << std::endl;
-            delete cfg_; cfg_ = nullptr;
-            return false;
-    }
+    cfg_->format = PCM_FORMAT_S16_LE;
 
     std::cout << "[WavPlayer] Opening PCM card=" << card << " device=" << device 
               << " rate=" << cfg_->rate << " ch=" << cfg_->channels << "..." << std::endl;
@@ -244,25 +370,32 @@ bool WavPlayer::openPcm(int card, int device) {
         std::cerr << "[WavPlayer] pcm_open timeout after " << std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count() << "ms" << std::endl;
         // 后台线程可能仍在运行，detach 让它在后台完成；清理本次分配并返回失败
         open_thread.detach();
+        if (telemetry_) telemetry_->recordOpen(std::chrono::duration_cast<std::chrono::microseconds>(timeout).count(), false);
         delete cfg_; cfg_ = nullptr;
         return false;
     }
 
-    pcm_ = fut.get();
+    struct pcm* opened = fut.get();
     // 确保线程已结束
     if (open_thread.joinable()) open_thread.join();
 
     auto t1 = std::chrono::steady_clock::now();
+    const bool ok = opened && pcm_is_ready(opened);
+    if (telemetry_) {
+        telemetry_->recordOpen(std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count(), ok);
+        if (ok) telemetry_->setPeriod(cfg_->period_size, cfg_->rate);
+    }
 
-    if (!pcm_ || !pcm_is_ready(pcm_)) {
-        std::cerr << "[WavPlayer] PCM open failed: " << (pcm_ ? pcm_get_error(pcm_) : "unknown") << std::endl;
-        if (pcm_) {
-            pcm_close(pcm_);
-            pcm_ = nullptr;
-        }
+    if (!ok) {
+        std::cerr << "[WavPlayer] PCM open failed: " << (opened ? pcm_get_error(opened) : "unknown") << std::endl;
+        if (opened) pcm_close(opened);
         delete cfg_; cfg_ = nullptr;
         return false;
     }
+    {
+        std::lock_guard<std::mutex> lk(dev_mtx_);
+        pcm_ = opened;
+    }
 
     std::cout << "[WavPlayer] pcm_open ok, elapsed="
               << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << "ms" << std::endl;
@@ -270,12 +403,32 @@ bool WavPlayer::openPcm(int card, int device) {
     device_opened_ = true;
     last_card_ = card;
     last_device_ = device;
-    last_channels_ = header_.num_channels;
-    last_rate_ = header_.sample_rate;
-    last_bits_ = header_.bits_per_sample;
+    last_channels_ = out_channels_;
+    last_rate_ = out_rate_;
     return true;
 }
 
+long WavPlayer::queuedFramesLocked() {
+    unsigned int avail = 0;
+    struct timespec ts{};
+    // 设备未运行（刚 prepare 或 xrun 后）时取不到时间戳，此时无排队
+    if (!pcm_ || pcm_get_htimestamp(pcm_, &avail, &ts) != 0) return 0;
+    const long queued = static_cast<long>(pcm_get_buffer_size(pcm_)) - static_cast<long>(avail);
+    return queued > 0 ? queued : 0;
+}
+
+void WavPlayer::feedStandbySilence() {
+    std::lock_guard<std::mutex> lk(dev_mtx_);
+    if (!pcm_ || !cfg_) return;
+    // 只保持半个到一个周期的静音在设备中，新请求最多等一个周期即可出声
+    const unsigned int chunk = std::max(1u, cfg_->period_size / 2);
+    if (queuedFramesLocked() > static_cast<long>(chunk)) return;
+    const unsigned int bytes = pcm_frames_to_bytes(pcm_, chunk);
+    if (silence_.size() < bytes) silence_.assign(bytes, 0);
+    int r = pcm_write(pcm_, silence_.data(), bytes);
+    if (r == -EPIPE) pcm_prepare(pcm_);
+}
+
 void WavPlayer::playbackThread() {
     // 尝试在播放线程内部设置实时优先级（有时这比外部设置更可靠）
     struct sched_param sch; sch.sched_priority = 20;
@@ -285,56 +438,99 @@ void WavPlayer::playbackThread() {
     }
 
     while (true) {
-        // 等待播放请求或终止
+        // 等待播放请求或终止；热备时每 1/4 周期醒来补静音
         {
             std::unique_lock<std::mutex> lk(mtx_);
-            cv_.wait(lk, [&]{ return play_request_.load() || terminate_.load(); });
+            auto ready = [&]{ return play_request_.load() || terminate_.load(); };
+            if (warm_standby_.load() && pcm_) {
+                const unsigned int rate = last_rate_ ? last_rate_ : 16000;
+                const unsigned int period = cfg_ ? cfg_->period_size : 1024;
+                cv_.wait_for(lk, std::chrono::microseconds(250000ULL * period / rate), ready);
+            } else {
+                cv_.wait(lk, [&]{ return ready() || (warm_standby_.load() && pcm_); });
+            }
         }
         if (terminate_.load()) break;
+        if (!play_request_.load()) {
+            feedStandbySilence();
+            continue;
+        }
 
         // 开始一次播放
         playing_.store(true);
         play_request_.store(false);
+        const bool warm = warm_standby_.load();
 
-        const size_t rawBlock = 4096;
-        std::vector<uint8_t> inBuf(rawBlock);
+        std::vector<uint8_t> inBuf;
         std::vector<uint8_t> procBuf;
 
-        if (!fp_) { playing_.store(false); continue; }
-        if (fseek(fp_, data_start_pos_, SEEK_SET) != 0) { playing_.store(false); continue; }
+        SourceCursor cur;
+        if (!rewindSource(cur)) { playing_.store(false); continue; }
+        const uint64_t underruns_at_start = reader_underruns_.load();
+        const uint64_t xruns_at_start = device_xruns_.load();
 
-        if (pcm_prepare(pcm_) != 0) {
+        // 热备时设备已在运行，prepare 会丢弃排队数据并重新等待起播阈值
+        if (!warm && pcm_prepare(pcm_) != 0) {
             std::cerr << "[WavPlayer] pcm_prepare failed" << std::endl;
         }
 
+        resetSpeedState();
         bool firstWrite = true;
-        auto t_start = std::chrono::steady_clock::now();
 
         while (!stop_flag_.load()) {
-            size_t n = fread(inBuf.data(), 1, rawBlock, fp_);
-            if (n == 0) {
-                if (loop.load()) { fseek(fp_, data_start_pos_, SEEK_SET); continue; }
-                std::fill(inBuf.begin(), inBuf.end(), 0); n = rawBlock;
+            // 循环播放时变速器状态跨首尾保持，回绕处同样无跳变
+            if (!produceBlock(cur, inBuf, procBuf)) {
+                if (warm) break; // 热备：播完即回到静音待命
+                // 冷启动：源结束后以静音维持设备运行，直到 stop()
+                std::fill(inBuf.begin(), inBuf.end(), 0);
+                applyVolumeAndSpeed(inBuf.data(), inBuf.size(), procBuf);
+            }
+            if (procBuf.empty()) {
+                if (faded_out_) break;
+                continue;
             }
-
-            applyVolumeAndSpeed(inBuf.data(), n, procBuf);
-            if (procBuf.empty()) { continue; }
 
             uint8_t* ptr = procBuf.data();
             size_t remaining = procBuf.size();
 
+            std::lock_guard<std::mutex> dev_lk(dev_mtx_);
+            if (!pcm_) break;
+            BionicCat::SpeakerModule::PlaybackTelemetry* tel = telemetry_.get();
             while (remaining > 0 && !stop_flag_.load()) {
+                const int64_t t_write = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                const long queued = (firstWrite || tel) ? queuedFramesLocked() : 0;
+                // 冷启动首次写入前设备尚未起播，填充度无意义
+                if (tel && !firstWrite) tel->recordBufferFill(queued, static_cast<long>(pcm_get_buffer_size(pcm_)));
                 int r = pcm_write(pcm_, ptr, remaining);
                 if (r == 0) {
                     ptr += remaining; remaining = 0;
+                    if (tel) {
+                        tel->recordWrite((std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count() - t_write) / 1000);
+                    }
                     if (firstWrite) {
                         firstWrite = false;
-                        auto t_fw = std::chrono::steady_clock::now();
-                        std::cout << "[WavPlayer] First audio buffer written, latency="
-                                  << std::chrono::duration_cast<std::chrono::milliseconds>(t_fw - t_start).count() << "ms" << std::endl;
+                        // 首个样本在已排队的帧播完后出声
+                        TriggerLatency lat;
+                        lat.warm = warm;
+                        lat.dispatch_us = (t_write - trigger_ns_.load()) / 1000;
+                        lat.queue_us = last_rate_ ? queued * 1000000LL / last_rate_ : 0;
+                        lat.total_us = lat.dispatch_us + lat.queue_us;
+                        {
+                            std::lock_guard<std::mutex> lk(lat_mtx_);
+                            last_latency_ = lat;
+                        }
+                        if (tel) tel->recordFirstWrite(lat.dispatch_us);
+                        std::cout << "[WavPlayer] First audio buffer written (" << (warm ? "warm" : "cold")
+                                  << "), trigger latency=" << lat.total_us / 1000.0 << "ms (dispatch "
+                                  << lat.dispatch_us / 1000.0 << "ms + queued " << lat.queue_us / 1000.0 << "ms)"
+                                  << std::endl;
                     }
                 } else if (r == -EPIPE || r == -32) {
                     if (stop_flag_.load()) break;
+                    device_xruns_.fetch_add(1);
+                    if (tel) tel->recordXrun();
                     r = pcm_prepare(pcm_);
                     if (r != 0) { std::cerr << "[WavPlayer] Recovery failed: " << r << std::endl; break; }
                 } else {
@@ -343,85 +539,199 @@ void WavPlayer::playbackThread() {
                     break;
                 }
             }
+            if (faded_out_) break; // 淡出的最后一块已写完
         }
-        // 播放完成或被停止
-        playing_.store(false);
-        stop_flag_.store(true);
+        // 欠载只在本轮结束后汇报，播放中不在实时线程里打印
+        const uint64_t underruns = reader_underruns_.load() - underruns_at_start;
+        const uint64_t xruns = device_xruns_.load() - xruns_at_start;
+        if (underruns > 0 || xruns > 0) {
+            std::cerr << "[WavPlayer] Playback finished with " << underruns << " prefetch underrun(s), "
+                      << xruns << " device xrun(s)" << std::endl;
+        }
+        // 播放完成或被停止；stop() 在 mtx_ 上等待淡出结束
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            playing_.store(false);
+            stop_flag_.store(true);
+        }
+        cv_.notify_all();
     }
 }
 
-void WavPlayer::applyVolumeAndSpeed(const uint8_t* in, size_t inBytes, std::vector<uint8_t>& out) {
-    float curSpeed = speed.load();
-    float curVol = volume.load();
+bool WavPlayer::rewindSource(SourceCursor& cur) {
+    cur.clip = std::atomic_load(&clip_);
+    cur.clip_pos = 0;
+    cur.file.reset();
+    if (cur.clip) return true;
+    cur.file = std::atomic_load(&prefetch_);
+    if (!cur.file) return false;
+    // 起播时等预读就绪；尚未取过数据（刚 load）时不重读
+    cur.file->setLoop(loop.load());
+    cur.file->rewind();
+    return true;
+}
 
-    const int channels = header_.num_channels;
-    const int bps = header_.bits_per_sample / 8;
-    if (bps <= 0) return;
+bool WavPlayer::produceBlock(SourceCursor& cur, std::vector<uint8_t>& inBuf, std::vector<uint8_t>& out) {
+    // 块长取整帧，24 bit 等帧长不整除 4096 时不会把半帧拆到下一块
+    const size_t frameBytes = std::max<size_t>(1, static_cast<size_t>(header_.num_channels) * (header_.bits_per_sample / 8));
+    const size_t rawBlock = std::max(frameBytes, 4096 / frameBytes * frameBytes);
+    inBuf.resize(rawBlock);
+    // 循环开关交给预读线程，在区间末尾自行回绕，播放线程不必等重新读盘
+    if (cur.file) cur.file->setLoop(loop.load());
 
-    size_t frameCount = inBytes / (channels * bps);
-    if (frameCount == 0) { out.clear(); return; }
+    bool rewound = false;
+    while (true) {
+        const uint8_t* src = inBuf.data();
+        size_t n = 0;
+        if (cur.clip) {
+            // 缓存命中：直接从内存取块，无磁盘 I/O
+            n = std::min(rawBlock, cur.clip->data.size() - cur.clip_pos);
+            src = cur.clip->data.data() + cur.clip_pos;
+            cur.clip_pos += n;
+        } else if (cur.file) {
+            n = cur.file->read(inBuf.data(), rawBlock);
+            if (n == 0 && !cur.file->eof()) {
+                if (cur.blocking) {
+                    // 离线渲染：等读线程，长时间读不到按源结束处理
+                    if (!cur.file->waitReady(frameBytes, std::chrono::seconds(1))) return flushSpeedState(out);
+                    continue;
+                }
+                // 预读没跟上（闪存 I/O 卡顿等）：补一块静音让设备不断流，计一次欠载
+                reader_underruns_.fetch_add(1);
+                if (telemetry_) telemetry_->recordUnderrun();
+                if (fade_stop_.load()) { // 正在淡出停止：静音即终点，不必再等数据
+                    faded_out_ = true;
+                    out.clear();
+                    return true;
+                }
+                const size_t frames = std::max<size_t>(
+                    1, static_cast<size_t>(static_cast<uint64_t>(rawBlock / frameBytes) * out_rate_ / header_.sample_rate));
+                out.assign(frames * out_channels_ * sizeof(int16_t), 0);
+                return true;
+            }
+        }
+        if (n > 0) {
+            applyVolumeAndSpeed(src, n, out);
+            return true;
+        }
+        // 循环播放回绕；空源回绕后仍读不到数据时按结束处理，避免空转
+        if (loop.load() && !rewound) {
+            rewound = true;
+            // 文件源通常已由预读线程回绕；只有播放末尾才打开循环时走到这里，需要等一次重读
+            if (cur.clip) cur.clip_pos = 0;
+            else if (cur.file) cur.file->rewind();
+            else return false;
+            continue;
+        }
+        return flushSpeedState(out);
+    }
+}
 
-    size_t targetFrames;
-    if (curSpeed > 0.999f && curSpeed < 1.001f) {
-        targetFrames = frameCount;
-    } else if (curSpeed > 1.0f) {
-        targetFrames = static_cast<size_t>(frameCount / curSpeed);
+void WavPlayer::resetSpeedState() {
+    using BionicCat::SpeakerModule::Resampler;
+    // 重采样在声道重排之后进行，按输出声道数建立
+    const uint16_t ch = out_channels_;
+    const auto quality = resample_quality.load();
+    if (!resampler_ || resampler_->channels() != ch || resampler_->quality() != quality) {
+        resampler_ = std::make_unique<Resampler>(ch, quality);
     } else {
-        targetFrames = static_cast<size_t>(frameCount / curSpeed);
+        resampler_->reset();
     }
+    resample_on_ = false;
+    // 起播从静音淡入；不渐变时直接取目标音量
+    gain_ = fade_ms.load() > 0.0f ? 0.0f : targetGain();
+    faded_out_ = false;
+}
 
-    out.resize(targetFrames * channels * bps);
+void WavPlayer::runSpeedChain(const float* x, size_t frames, bool resample, float speed) {
+    const size_t ch = out_channels_;
+    const double ratio = static_cast<double>(header_.sample_rate) / out_rate_;
 
-    auto copyFrame = [&](size_t srcIndex, size_t dstIndex) {
-        if (srcIndex >= frameCount) srcIndex = frameCount - 1;
-        const uint8_t* src = in + srcIndex * channels * bps;
-        uint8_t* dst = out.data() + dstIndex * channels * bps;
-        std::memcpy(dst, src, channels * bps);
-    };
+    // 重采样：速度折算进步长；关闭时先排空，尾巴在时间上位于本块之前
+    if (resample) {
+        resampler_->setStep(ratio * speed);
+        resampler_->process(x, frames, fout_);
+    } else {
+        if (resample_on_) resampler_->flush(fout_);
+        if (frames > 0) fout_.insert(fout_.end(), x, x + frames * ch);
+    }
+    resample_on_ = resample;
+}
 
-    double step = curSpeed;
-    double pos = 0.0;
-    for (size_t d = 0; d < targetFrames; ++d) {
-        copyFrame(static_cast<size_t>(pos), d);
-        pos += step;
+float WavPlayer::targetGain() const {
+    return fade_stop_.load() ? 0.0f : std::max(0.0f, volume.load());
+}
+
+void WavPlayer::finishBlock(float target, std::vector<uint8_t>& out) {
+    using namespace BionicCat::SpeakerModule;
+    const size_t ch = out_channels_;
+    size_t frames = fout_.size() / ch;
+    out.resize(frames * ch * sizeof(int16_t));
+    int16_t* dst = reinterpret_cast<int16_t*>(out.data());
+
+    // 渐变段逐帧乘增益，到达目标后的部分在转 S16 时乘常量目标增益，不多走一遍
+    const float step = gainRampStep(fade_ms.load(), out_rate_);
+    const size_t ramped = applyGainRamp(fout_.data(), frames, static_cast<uint16_t>(ch), gain_, target, step);
+    floatToS16(fout_.data(), 1.0f, dst, ramped * ch);
+    floatToS16(fout_.data() + ramped * ch, target, dst + ramped * ch, (frames - ramped) * ch);
+
+    // 淡出停止：到 0 的那一帧之后不再输出
+    if (fade_stop_.load() && target == 0.0f && gain_ == 0.0f) {
+        frames = ramped;
+        out.resize(frames * ch * sizeof(int16_t));
+        faded_out_ = true;
     }
+}
 
-    if (std::abs(curVol - 1.0f) > 0.001f) {
-        size_t samples = out.size() / bps;
-        if (bps == 1) { // 8-bit
-            for (size_t i = 0; i < samples; ++i) {
-                int v = static_cast<int>(static_cast<int8_t>(out[i]));
-                v = static_cast<int>(v * curVol);
-                v = std::clamp(v, -128, 127);
-                out[i] = static_cast<uint8_t>(static_cast<int8_t>(v));
-            }
-        } else if (bps == 2) { // 16-bit
-            int16_t* p = reinterpret_cast<int16_t*>(out.data());
-            for (size_t i = 0; i < samples; ++i) {
-                int v = static_cast<int>(p[i]);
-                v = static_cast<int>(v * curVol);
-                v = std::clamp(v, -32768, 32767);
-                p[i] = static_cast<int16_t>(v);
-            }
-        } else if (bps == 3) { // 24-bit
-             for (size_t i = 0; i < samples; ++i) {
-                uint8_t* s = out.data() + i * 3;
-                int v = (static_cast<int>(s[0]) | (static_cast<int>(s[1]) << 8) | (static_cast<int>(s[2]) << 16));
-                if (v & 0x800000) v |= ~0xFFFFFF; // sign extend
-                v = static_cast<int>(v * curVol);
-                v = std::clamp(v, -8388608, 8388607);
-                s[0] = static_cast<uint8_t>(v & 0xFF);
-                s[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
-                s[2] = static_cast<uint8_t>((v >> 16) & 0xFF);
-            }
-        } else if (bps == 4) { // 32-bit
-            int32_t* p = reinterpret_cast<int32_t*>(out.data());
-            for (size_t i = 0; i < samples; ++i) {
-                long long v = static_cast<long long>(p[i]);
-                v = static_cast<long long>(v * curVol);
-                v = std::clamp<long long>(v, -2147483648LL, 2147483647LL);
-                p[i] = static_cast<int32_t>(v);
-            }
+bool WavPlayer::flushSpeedState(std::vector<uint8_t>& out) {
+    if (!resample_on_) return false;
+    fout_.clear();
+    runSpeedChain(nullptr, 0, false, 1.0f);
+    if (fout_.empty()) return false;
+    finishBlock(targetGain(), out);
+    return true;
+}
+
+void WavPlayer::applyVolumeAndSpeed(const uint8_t* in, size_t inBytes, std::vector<uint8_t>& out) {
+    using namespace BionicCat::SpeakerModule;
+    float curSpeed = speed.load();
+    const float target = targetGain();
+    if (!(curSpeed > 0.0f)) curSpeed = 1.0f;
+
+    const uint16_t in_ch = header_.num_channels;
+    const uint16_t out_ch = out_channels_;
+    const uint16_t bits = header_.bits_per_sample;
+    const size_t frame_bytes = static_cast<size_t>(in_ch) * (bits / 8);
+    if (frame_bytes == 0) { out.clear(); return; }
+    const size_t frames = inBytes / frame_bytes;
+
+    const bool unitSpeed = curSpeed > 0.999f && curSpeed < 1.001f;
+    const bool unitVol = std::abs(target - 1.0f) <= 0.001f;
+    const bool resample = header_.sample_rate != out_rate_ || !unitSpeed;
+
+    // 源已是输出格式、链路中无残留且增益不在渐变：原音量直接拷贝，否则直接在 S16 上做增益，不经过 float
+    if (bits == 16 && in_ch == out_ch && !resample && !resample_on_ &&
+        gain_ == target && !fade_stop_.load()) {
+        if (unitVol) {
+            out.assign(in, in + frames * frame_bytes);
+        } else {
+            out.resize(frames * frame_bytes);
+            bc_dsp_gain_s16_copy(reinterpret_cast<const int16_t*>(in), reinterpret_cast<int16_t*>(out.data()),
+                                 frames * in_ch, target);
         }
+        return;
+    }
+
+    fin_.resize(frames * in_ch);
+    pcmToFloat(in, frames * in_ch, bits, fin_.data());
+    const float* x = fin_.data();
+    if (in_ch != out_ch) {
+        fmix_.resize(frames * out_ch);
+        remixChannels(fin_.data(), in_ch, fmix_.data(), out_ch, frames);
+        x = fmix_.data();
     }
-}
\ No newline at end of file
+
+    fout_.clear();
+    runSpeedChain(x, frames, resample, curSpeed);
+    finishBlock(target, out);
+}
@@ -0,0 +1,122 @@
+#include "playback_telemetry.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+// 耗时桶（微秒）：低于一个周期的正常写入落在前几桶，超过 20 ms 的多半已造成 xrun
+static constexpr uint32_t kTimeBoundsUs[] = {500, 1000, 2000, 5000, 10000, 20000, 50000};
+// 缓冲填充度桶（%）
+static constexpr uint32_t kFillBoundsPct[] = {10, 25, 50, 75, 90};
+
+Histogram::Histogram(const uint32_t* upper, size_t bounds)
+    : bounds_(std::min(bounds, kMaxBounds)) {
+    std::copy(upper, upper + bounds_, upper_.begin());
+}
+
+void Histogram::record(uint32_t v) {
+    const size_t b = static_cast<size_t>(std::lower_bound(upper_.begin(), upper_.begin() + bounds_, v) - upper_.begin());
+    buckets_[b].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+    uint32_t cur = max_.load(std::memory_order_relaxed);
+    while (v > cur && !max_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot(bool reset) {
+    Snapshot s;
+    s.bounds = bounds_;
+    s.upper = upper_;
+    for (size_t i = 0; i <= bounds_; ++i) {
+        s.buckets[i] = reset ? buckets_[i].exchange(0, std::memory_order_relaxed)
+                             : buckets_[i].load(std::memory_order_relaxed);
+        s.count += s.buckets[i];
+    }
+    const uint64_t sum = reset ? sum_.exchange(0, std::memory_order_relaxed) : sum_.load(std::memory_order_relaxed);
+    s.max = reset ? max_.exchange(0, std::memory_order_relaxed) : max_.load(std::memory_order_relaxed);
+    s.avg = s.count ? static_cast<float>(sum) / static_cast<float>(s.count) : 0.0f;
+    return s;
+}
+
+uint32_t Histogram::Snapshot::percentile(float p) const {
+    if (count == 0) return 0;
+    const uint64_t rank = static_cast<uint64_t>(std::clamp(p, 0.0f, 1.0f) * static_cast<float>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bounds; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(upper[i], max);
+    }
+    return max;
+}
+
+PlaybackTelemetry::PlaybackTelemetry()
+    : open_us_(kTimeBoundsUs, sizeof(kTimeBoundsUs) / sizeof(kTimeBoundsUs[0]))
+    , first_write_us_(kTimeBoundsUs, sizeof(kTimeBoundsUs) / sizeof(kTimeBoundsUs[0]))
+    , write_us_(kTimeBoundsUs, sizeof(kTimeBoundsUs) / sizeof(kTimeBoundsUs[0]))
+    , buffer_fill_pct_(kFillBoundsPct, sizeof(kFillBoundsPct) / sizeof(kFillBoundsPct[0])) {
+    window_start_us_.store(nowUs());
+}
+
+int64_t PlaybackTelemetry::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t clampUs(int64_t us) {
+    return static_cast<uint32_t>(std::clamp<int64_t>(us, 0, UINT32_MAX));
+}
+
+void PlaybackTelemetry::recordOpen(int64_t us, bool ok) {
+    (ok ? device_opens_ : device_open_failures_).fetch_add(1, std::memory_order_relaxed);
+    open_us_.record(clampUs(us));
+}
+
+void PlaybackTelemetry::recordFirstWrite(int64_t us) {
+    first_write_us_.record(clampUs(us));
+}
+
+void PlaybackTelemetry::recordWrite(int64_t us) {
+    periods_written_.fetch_add(1, std::memory_order_relaxed);
+    write_us_.record(clampUs(us));
+}
+
+void PlaybackTelemetry::recordBufferFill(long queued_frames, long buffer_frames) {
+    if (buffer_frames <= 0) return;
+    const long pct = std::clamp(queued_frames, 0L, buffer_frames) * 100 / buffer_frames;
+    buffer_fill_pct_.record(static_cast<uint32_t>(pct));
+}
+
+void PlaybackTelemetry::recordXrun() {
+    xruns_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PlaybackTelemetry::recordUnderrun() {
+    underruns_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PlaybackTelemetry::setPeriod(uint32_t frames, uint32_t rate) {
+    if (rate > 0) period_us_.store(1e6f * static_cast<float>(frames) / static_cast<float>(rate));
+}
+
+PlaybackTelemetryStats PlaybackTelemetry::stats(bool reset_window) {
+    PlaybackTelemetryStats s;
+    const int64_t now = nowUs();
+    s.window_ms = static_cast<uint32_t>((now - window_start_us_.load()) / 1000);
+    s.device_opens = device_opens_.load(std::memory_order_relaxed);
+    s.device_open_failures = device_open_failures_.load(std::memory_order_relaxed);
+    s.periods_written = periods_written_.load(std::memory_order_relaxed);
+    s.xruns = xruns_.load(std::memory_order_relaxed);
+    s.underruns = underruns_.load(std::memory_order_relaxed);
+    s.period_us = period_us_.load();
+    s.open_us = open_us_.snapshot(reset_window);
+    s.first_write_us = first_write_us_.snapshot(reset_window);
+    s.write_us = write_us_.snapshot(reset_window);
+    s.buffer_fill_pct = buffer_fill_pct_.snapshot(reset_window);
+    if (reset_window) window_start_us_.store(now);
+    return s;
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
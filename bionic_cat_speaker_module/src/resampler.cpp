@@ -0,0 +1,216 @@
+#include "resampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace BionicCat {
+namespace SpeakerModule {
+
+namespace {
+
+// 最长滤波器的一半；历史中始终保留这么多帧，换表时无需补数据
+constexpr size_t kMaxHalf = SincKernel::kMaxTaps / 2;
+
+struct Preset {
+    size_t taps;
+    size_t phases;
+    double beta;
+};
+
+Preset presetFor(ResampleQuality quality) {
+    switch (quality) {
+        case ResampleQuality::Fast: return {8, 32, 5.0};
+        case ResampleQuality::High: return {64, 256, 9.0};
+        case ResampleQuality::Medium:
+        default: return {24, 64, 7.0};
+    }
+}
+
+// 第一类零阶修正贝塞尔函数，用于 Kaiser 窗
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    const double q = x * x / 4.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= q / (static_cast<double>(k) * k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+} // namespace
+
+double SincKernel::cutoffFor(double step) {
+    // 保留 0.95 倍奈奎斯特带宽；降采样时按 step 下移，step 量化到 1/8 以便共用表
+    if (step <= 1.0) return 0.95;
+    return 0.95 / (std::ceil(step * 8.0) / 8.0);
+}
+
+SincKernel::SincKernel(ResampleQuality quality, double step) {
+    const Preset p = presetFor(quality);
+    cutoff_ = cutoffFor(step);
+    // 截止频率越低，过渡带越宽，需要按比例加长滤波器才能保持同样的阻带衰减
+    const double scale = std::min(4.0, 0.95 / cutoff_);
+    taps_ = (static_cast<size_t>(std::ceil(static_cast<double>(p.taps) * scale)) + 3) & ~static_cast<size_t>(3);
+    phases_ = p.phases;
+
+    const double half = static_cast<double>(taps_ / 2);
+    const double norm = besselI0(p.beta);
+    table_.resize((phases_ + 1) * taps_);
+    for (size_t ph = 0; ph <= phases_; ++ph) {
+        const double frac = static_cast<double>(ph) / static_cast<double>(phases_);
+        float* row = table_.data() + ph * taps_;
+        double sum = 0.0;
+        for (size_t k = 0; k < taps_; ++k) {
+            // 系数 k 作用于源帧 floor(pos) - half + 1 + k，相对中心的距离
+            const double x = static_cast<double>(k) - half + 1.0 - frac;
+            const double r = x / half;
+            double h = 0.0;
+            if (std::fabs(r) < 1.0) {
+                const double arg = M_PI * cutoff_ * x;
+                const double sinc = std::fabs(arg) < 1e-9 ? 1.0 : std::sin(arg) / arg;
+                h = cutoff_ * sinc * besselI0(p.beta * std::sqrt(1.0 - r * r)) / norm;
+            }
+            row[k] = static_cast<float>(h);
+            sum += h;
+        }
+        // 每个相位的直流增益都为 1，避免相位切换带来的幅度调制
+        for (size_t k = 0; k < taps_; ++k) row[k] = static_cast<float>(row[k] / sum);
+    }
+}
+
+void SincKernel::coefficients(double frac, float* out) const {
+    const double x = frac * static_cast<double>(phases_);
+    size_t p = static_cast<size_t>(x);
+    if (p >= phases_) p = phases_ - 1;
+    const float t = static_cast<float>(x - static_cast<double>(p));
+    const float* a = table_.data() + p * taps_;
+    const float* b = a + taps_;
+    for (size_t k = 0; k < taps_; ++k) out[k] = a[k] + (b[k] - a[k]) * t;
+}
+
+float dotProduct(const float* a, const float* b, size_t n) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < n; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    const float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#elif defined(__SSE2__)
+    __m128 acc = _mm_setzero_ps();
+    for (size_t i = 0; i < n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+#else
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (size_t i = 0; i < n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    return (s0 + s1) + (s2 + s3);
+#endif
+}
+
+Resampler::Resampler(uint16_t channels, ResampleQuality quality)
+    : channels_(channels ? channels : 1),
+      quality_(quality),
+      kernel_(std::make_shared<SincKernel>(quality, 1.0)),
+      hist_(channels_) {
+    reset();
+}
+
+void Resampler::setStep(double step) {
+    if (!(step > 0.0)) step = 1.0;
+    step_ = step;
+    if (SincKernel::cutoffFor(step) != kernel_->cutoff()) {
+        kernel_ = std::make_shared<SincKernel>(quality_, step);
+    }
+}
+
+void Resampler::reset() {
+    // 前面垫 kMaxHalf 帧零：输出帧 0 正好对准输入帧 0，不引入整体延迟
+    for (auto& h : hist_) h.assign(kMaxHalf, 0.0f);
+    ipos_ = kMaxHalf;
+    frac_ = 0.0;
+    origin_ = static_cast<long>(kMaxHalf);
+    fed_ = 0;
+}
+
+size_t Resampler::pendingFrames() const {
+    return hist_[0].size() > ipos_ ? hist_[0].size() - ipos_ : 0;
+}
+
+size_t Resampler::process(const float* in, size_t frames, std::vector<float>& out) {
+    const size_t ch = channels_;
+    for (size_t c = 0; c < ch; ++c) {
+        std::vector<float>& h = hist_[c];
+        const size_t base = h.size();
+        h.resize(base + frames);
+        for (size_t f = 0; f < frames; ++f) h[base + f] = in[f * ch + c];
+    }
+    fed_ += frames;
+    return render(out, false);
+}
+
+size_t Resampler::flush(std::vector<float>& out) {
+    // 补零凑够前瞻，只输出中心落在真实输入范围内的帧
+    const size_t pad = kernel_->taps() / 2 + 1;
+    for (auto& h : hist_) h.insert(h.end(), pad, 0.0f);
+    const size_t n = render(out, true);
+    reset();
+    return n;
+}
+
+size_t Resampler::render(std::vector<float>& out, bool draining) {
+    const size_t ch = channels_;
+    const size_t taps = kernel_->taps();
+    const size_t half = taps / 2;
+    const size_t avail = hist_[0].size();
+    // 排空时只输出中心落在真实输入内的帧；留一点余量吸收小数相位的累加误差
+    const long end = origin_ + static_cast<long>(fed_);
+
+    if (avail > ipos_) {
+        out.reserve(out.size() + (static_cast<size_t>(static_cast<double>(avail - ipos_) / step_) + 2) * ch);
+    }
+    coef_.resize(taps);
+    size_t n = 0;
+    while (ipos_ + half < avail) {
+        if (draining && static_cast<double>(static_cast<long>(ipos_) - end) + frac_ >= -1e-6) break;
+        kernel_->coefficients(frac_, coef_.data());
+        const size_t start = ipos_ + 1 - half;
+        for (size_t c = 0; c < ch; ++c) {
+            out.push_back(dotProduct(hist_[c].data() + start, coef_.data(), taps));
+        }
+        frac_ += step_;
+        const double whole = std::floor(frac_);
+        ipos_ += static_cast<size_t>(whole);
+        frac_ -= whole;
+        ++n;
+    }
+    compact();
+    return n;
+}
+
+void Resampler::compact() {
+    // 只保留当前位置之前 kMaxHalf 帧历史
+    if (ipos_ <= kMaxHalf) return;
+    const size_t drop = std::min(ipos_ - kMaxHalf, hist_[0].size());
+    for (auto& h : hist_) h.erase(h.begin(), h.begin() + static_cast<std::ptrdiff_t>(drop));
+    ipos_ -= drop;
+    origin_ -= static_cast<long>(drop);
+}
+
+} // namespace SpeakerModule
+} // namespace BionicCat
@@ -1,10 +1,32 @@
 #include "speaker_node.hpp"
 #include "serializer.hpp"
+#include "mqtt_utils.hpp"
 #include <chrono>
 
 namespace BionicCat {
 namespace SpeakerModule {
 
+// 超过该时长未收到流数据视为流已结束（发送端未发 stop 时兜底）
+static constexpr int64_t kStreamIdleTimeoutMs = 2000;
+// PCM 缓存总上限；单个文件不超过其 1/4，更大的 WAV 由混音器流式播放（PcmStream），不入缓存
+static constexpr size_t kPcmCacheBytes = 8 * 1024 * 1024;
+// 超过缓存单条上限的压缩资源只能整段解码后播放：文件不超过该值（约 1 分钟 128 kbps AAC，解码后约 11 MB）
+static constexpr size_t kMaxUncachedDecodeBytes = 1024 * 1024;
+// 混音输出格式与声部数：设备常开并持续写周期（无声部时为静音），触发到出声约一个周期
+static constexpr uint32_t kMixerRate = 48000;
+static constexpr uint16_t kMixerChannels = 2;
+static constexpr uint32_t kMixerPeriodFrames = 256;
+static constexpr size_t kMixerVoices = 8;
+// 定时播放最多提前这么久；更远的时刻多半来自其他主机的时钟（start_at_ns 须为本机 CLOCK_MONOTONIC），改为立即播放
+static constexpr int64_t kMaxScheduleAheadNs = 10LL * 1000 * 1000 * 1000;
+// 指令线程没有可执行指令时的等待上限；ENQUEUE 指令靠它轮询声部是否已播完
+static constexpr int kCommandPollMs = 20;
+
+static int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 SpeakerNode::SpeakerNode(const std::string& server_address,
                          const std::string& client_id,
                          const std::string& subscribe_topic,
@@ -16,8 +38,13 @@ SpeakerNode::SpeakerNode(const std::string& server_address,
     , subscribe_topic_(subscribe_topic)
     , qos_(qos)
     , running_(false) 
+    , stream_arbiter_(kStreamIdleTimeoutMs)
     , current_card_(card)
-    , current_device_(device) {}
+    , current_device_(device) {
+    pcm_cache_ = std::make_shared<PcmCache>(kPcmCacheBytes);
+    pcm_cache_->setOutputChannels(kMixerChannels);
+    telemetry_ = std::make_shared<PlaybackTelemetry>();
+}
 
 SpeakerNode::~SpeakerNode() {
     stop();
@@ -25,7 +52,13 @@ SpeakerNode::~SpeakerNode() {
 
 bool SpeakerNode::init() {
     subscriber_ = std::make_unique<BionicCat::MqttClient::MQTTSubscriber>(server_address_, client_id_ + "_audio_sub", qos_);
-    subscriber_->setMessageHandler(std::bind(&SpeakerNode::handleAudioPlayCommand, this, std::placeholders::_1));
+    subscriber_->setMessageHandler(std::bind(&SpeakerNode::handleMessage, this, std::placeholders::_1));
+    publisher_ = std::make_unique<BionicCat::MqttClient::MQTTPublisher>(server_address_, client_id_ + "_audio_pub", qos_);
+    if (!publisher_->connect()) {
+        // 统计发布失败不影响播放
+        std::cerr << "[SpeakerNode] Failed to connect MQTT publisher, playback stats disabled" << std::endl;
+        publisher_.reset();
+    }
     std::cout << "[SpeakerNode] Connecting subscriber..." << std::endl;
     if (!subscriber_->connect()) {
         std::cerr << "[SpeakerNode] Failed to connect MQTT subscriber" << std::endl;
@@ -35,26 +68,111 @@ bool SpeakerNode::init() {
         std::cerr << "[SpeakerNode] Failed to subscribe topic: " << subscribe_topic_ << std::endl;
         return false;
     }
+    if (!subscriber_->subscribe(subscribe_topic_stream_) || !subscriber_->subscribe(subscribe_topic_stream_ctrl_)) {
+        std::cerr << "[SpeakerNode] Failed to subscribe stream topics" << std::endl;
+        return false;
+    }
     std::cout << "[SpeakerNode] Init OK. Subscribed to " << subscribe_topic_ << std::endl;
     running_ = true;
+    cmd_thread_ = std::thread(&SpeakerNode::commandThread, this);
     return true;
 }
 
 void SpeakerNode::run() {
     std::cout << "[SpeakerNode] Running loop." << std::endl;
+    auto last_stats = std::chrono::steady_clock::now();
     while (running_ && subscriber_ && subscriber_->isConnected()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        {
+            std::lock_guard<std::mutex> lk(stream_mtx_);
+            if (stream_player_ && stream_player_->idleMs() > kStreamIdleTimeoutMs) {
+                std::cout << "[SpeakerNode] Audio stream idle, stopping" << std::endl;
+                stream_player_.reset();
+            }
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_stats >= std::chrono::milliseconds(kStatsIntervalMs)) {
+            last_stats = now;
+            publishPlaybackStats();
+        }
     }
 }
 
+static BionicCat::MqttMsgs::PlaybackHistogram toMsg(const Histogram::Snapshot& s) {
+    BionicCat::MqttMsgs::PlaybackHistogram h;
+    h.count = s.count;
+    h.avg = s.avg;
+    h.max = s.max;
+    h.upper.assign(s.upper.begin(), s.upper.begin() + static_cast<std::ptrdiff_t>(s.bounds));
+    h.buckets.assign(s.buckets.begin(), s.buckets.begin() + static_cast<std::ptrdiff_t>(s.bounds + 1));
+    return h;
+}
+
+void SpeakerNode::publishPlaybackStats() {
+    if (!publisher_) return;
+    const PlaybackTelemetryStats st = telemetry_->stats(/*reset_window*/true);
+    BionicCat::MqttMsgs::SpeakerPlaybackStatsMsg m{};
+    {
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        m.output = stream_player_ ? 2 : (mixer_ && mixer_->isOpen() ? 1 : 0);
+    }
+    m.window_ms = st.window_ms;
+    m.device_opens = st.device_opens;
+    m.device_open_failures = st.device_open_failures;
+    m.periods_written = st.periods_written;
+    m.xruns = st.xruns;
+    m.underruns = st.underruns;
+    m.period_us = st.period_us;
+    m.device_open_us = toMsg(st.open_us);
+    m.first_write_us = toMsg(st.first_write_us);
+    m.write_us = toMsg(st.write_us);
+    m.buffer_fill_pct = toMsg(st.buffer_fill_pct);
+    m.header.frame_id = "speaker";
+    m.header.device_id = client_id_;
+    m.header.timestamp = getStamp();
+    auto bin = BionicCat::MsgsSerializer::Serializer::serializeSpeakerPlaybackStats(m);
+    publisher_->publish(publish_topic_stats_, bin.data(), bin.size(), qos_, false);
+}
+
 void SpeakerNode::stop() {
     if (!running_) return;
     running_ = false;
-    if (player_) {
-        player_->stop();
-        player_.reset();
+    commands_.close();
+    if (cmd_thread_.joinable()) cmd_thread_.join();
+    const PlayCommandQueue::Stats qs = commands_.stats();
+    std::cout << "[SpeakerNode] Commands: submitted=" << qs.submitted << " executed=" << qs.taken
+              << " coalesced=" << qs.coalesced << " dropped_busy=" << qs.dropped_busy
+              << " overflowed=" << qs.overflowed << " peak_depth=" << qs.peak_depth
+              << " stream_dropped=" << stream_dropped_packets_.load();
+    {
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        std::cout << " stream_suppressed=" << stream_arbiter_.suppressedPackets() << std::endl;
+    }
+    stopStream();
+    {
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        if (mixer_) {
+            const AudioMixer::Stats ms = mixer_->stats();
+            std::cout << "[SpeakerNode] Mixer: started=" << ms.started << " steals=" << ms.steals
+                      << " rejected=" << ms.rejected << " xruns=" << ms.xruns
+                      << " stream_underruns=" << ms.stream_underruns << std::endl;
+            mixer_->close();
+            mixer_.reset();
+        }
     }
     if (subscriber_) subscriber_->disconnect();
+    if (publisher_) publisher_->disconnect();
+}
+
+void SpeakerNode::handleMessage(mqtt::const_message_ptr msg) {
+    const std::string& topic = msg->get_topic();
+    if (topic == subscribe_topic_stream_) {
+        handleStreamData(msg);
+    } else if (topic == subscribe_topic_stream_ctrl_) {
+        handleStreamControl(msg);
+    } else {
+        handleAudioPlayCommand(msg);
+    }
 }
 
 void SpeakerNode::handleAudioPlayCommand(mqtt::const_message_ptr msg) {
@@ -65,26 +183,186 @@ void SpeakerNode::handleAudioPlayCommand(mqtt::const_message_ptr msg) {
         std::cout << "[SpeakerNode] AudioPlayCommand received: file=" << cmd.file_path
                   << " speed=" << cmd.speed
                   << " volume=" << cmd.volume
-                  << " loop=" << cmd.loop << std::endl;
-        playCommand(cmd);
+                  << " loop=" << cmd.loop
+                  << " mode=" << static_cast<int>(cmd.mode)
+                  << " priority=" << static_cast<int>(cmd.priority);
+        if (cmd.start_at_ns != 0) {
+            std::cout << " start_in_ms=" << (cmd.start_at_ns - AudioMixer::monotonicNowNs()) / 1000000;
+        }
+        std::cout << std::endl;
+        commands_.push(cmd);
     } catch (const std::exception& e) {
         std::cerr << "[SpeakerNode] Failed to deserialize AudioPlayCommand: " << e.what() << std::endl;
     }
 }
 
-void SpeakerNode::playCommand(const BionicCat::MqttMsgs::AudioPlayCommand& cmd) {
-    if (!player_) player_ = std::make_unique<WavPlayer>();
-    player_->stop();
-    player_->file_path = cmd.file_path;
-    player_->speed = cmd.speed <= 0.f ? 1.f : cmd.speed;
-    player_->volume = cmd.volume < 0.f ? 0.f : cmd.volume;
-    player_->loop = cmd.loop;
-    if (!player_->load(current_card_, current_device_)) { // default card/device; could be extended via header.device_id
-        std::cerr << "[SpeakerNode] Failed to load wav: " << cmd.file_path << std::endl;
+void SpeakerNode::handleStreamControl(mqtt::const_message_ptr msg) {
+    try {
+        auto ctrl = BionicCat::MsgsSerializer::Serializer::deserializeAdtsStreamControl(
+            reinterpret_cast<const uint8_t*>(msg->get_payload().data()),
+            msg->get_payload().size());
+        {
+            // 显式的开始/结束解除“流已被播放指令停止”的锁存
+            std::lock_guard<std::mutex> lk(stream_mtx_);
+            stream_arbiter_.onStreamControl();
+        }
+        if (!ctrl.is_start) {
+            std::cout << "[SpeakerNode] Audio stream STOP" << std::endl;
+            stopStream();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(stream_mtx_);
+            stream_codec_ = ctrl.codec;
+        }
+        if (ctrl.codec != BionicCat::MqttMsgs::AudioCodec::AAC_ADTS) {
+            std::cerr << "[SpeakerNode] Unsupported stream codec " << static_cast<int>(ctrl.codec)
+                      << ", only AAC ADTS can be played; dropping its data" << std::endl;
+            stopStream();
+            return;
+        }
+        // 流进行中再次收到 start（如码率变化）无需重启，解码器从 ADTS 头获取参数
+        std::cout << "[SpeakerNode] Audio stream START: " << ctrl.sample_rate << " Hz x"
+                  << static_cast<int>(ctrl.channels) << " " << ctrl.bit_rate << " bps" << std::endl;
+        startStream();
+    } catch (const std::exception& e) {
+        std::cerr << "[SpeakerNode] Failed to deserialize AdtsStreamControlMsg: " << e.what() << std::endl;
+    }
+}
+
+void SpeakerNode::handleStreamData(mqtt::const_message_ptr msg) {
+    try {
+        auto data = BionicCat::MsgsSerializer::Serializer::deserializeAdtsStreamData(
+            reinterpret_cast<const uint8_t*>(msg->get_payload().data()),
+            msg->get_payload().size());
+        std::lock_guard<std::mutex> lk(stream_mtx_);
+        // 数据包本身不带编码：只有最近的控制消息声明为 AAC/ADTS（或从未收到控制消息）时才送入 AAC 解码
+        if (stream_codec_ != BionicCat::MqttMsgs::AudioCodec::AAC_ADTS) {
+            if (stream_dropped_packets_.fetch_add(1) % 500 == 0) {
+                std::cerr << "[SpeakerNode] Dropping stream data for unsupported codec "
+                          << static_cast<int>(stream_codec_) << " (dropped=" << stream_dropped_packets_.load() << ")"
+                          << std::endl;
+            }
+            return;
+        }
+        // 未收到 start 时也按数据自动开流；播放指令刚停掉的流继续发来的数据不开流，以免掐断指令的声音
+        if (!stream_player_) {
+            if (!stream_arbiter_.allowAutoStart(steadyNowMs())) return;
+            if (!startStreamLocked()) return;
+        }
+        stream_player_->push(data.seq, data.pts_ms, data.payload.data(), data.payload.size());
+    } catch (const std::exception& e) {
+        std::cerr << "[SpeakerNode] Failed to deserialize AdtsStreamDataMsg: " << e.what() << std::endl;
+    }
+}
+
+bool SpeakerNode::startStream() {
+    std::lock_guard<std::mutex> lk(stream_mtx_);
+    return stream_player_ || startStreamLocked();
+}
+
+bool SpeakerNode::startStreamLocked() {
+    // 释放混音器占用的设备
+    if (mixer_) mixer_->close();
+    AdtsStreamPlayer::Config cfg;
+    cfg.card = current_card_;
+    cfg.device = current_device_;
+    cfg.telemetry = telemetry_;
+    auto sp = std::make_unique<AdtsStreamPlayer>(cfg);
+    if (!sp->start()) {
+        std::cerr << "[SpeakerNode] Failed to start stream player" << std::endl;
+        return false;
+    }
+    stream_player_ = std::move(sp);
+    return true;
+}
+
+void SpeakerNode::stopStream() {
+    std::lock_guard<std::mutex> lk(stream_mtx_);
+    stream_player_.reset();
+}
+
+void SpeakerNode::commandThread() {
+    while (running_) {
+        const uint64_t version = commands_.version();
+        PlayCommandQueue::Ticket t;
+        if (commands_.pop(t, outputBusy())) {
+            executeCommand(t);
+        } else {
+            commands_.waitChanged(version, kCommandPollMs);
+        }
+    }
+}
+
+bool SpeakerNode::outputBusy() {
+    std::lock_guard<std::mutex> lk(stream_mtx_);
+    return stream_player_ || (mixer_ && mixer_->activeVoices() > 0);
+}
+
+void SpeakerNode::executeCommand(const PlayCommandQueue::Ticket& t) {
+    const BionicCat::MqttMsgs::AudioPlayCommand& cmd = t.cmd;
+    int64_t start_at_ns = cmd.start_at_ns;
+    if (start_at_ns != 0 && start_at_ns - AudioMixer::monotonicNowNs() > kMaxScheduleAheadNs) {
+        std::cerr << "[SpeakerNode] start_at_ns is too far ahead (not this host's monotonic clock?), playing now"
+                  << std::endl;
+        start_at_ns = 0;
+    }
+
+    // 载入在设备锁外进行：慢的载入期间流播放与统计照常，正在播放的声音也不会提前停下
+    std::shared_ptr<const PcmClip> clip;
+    std::shared_ptr<PcmStream> stream;
+    if (!cmd.file_path.empty()) {
+        clip = pcm_cache_->get(cmd.file_path);
+        // 不入缓存的 WAV 边预读边播，内存占用与文件长度无关；压缩资源仍整段解码，受 kMaxUncachedDecodeBytes 限制
+        if (!clip) stream = PcmStream::open(cmd.file_path, kMixerChannels, cmd.loop);
+        if (!clip && !stream) clip = pcm_cache_->loadUncached(cmd.file_path, kMaxUncachedDecodeBytes);
+        if (!clip && !stream) {
+            std::cerr << "[SpeakerNode] Failed to load wav: " << cmd.file_path << std::endl;
+            return;
+        }
+        if (commands_.superseded(t)) {
+            std::cout << "[SpeakerNode] Command superseded while loading, skipped: " << cmd.file_path << std::endl;
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(stream_mtx_);
+    if (stream_player_) {
+        std::cout << "[SpeakerNode] Audio stream stopped by play command" << std::endl;
+        stream_player_.reset();
+        stream_arbiter_.onCommandStoppedStream(steadyNowMs());
+    }
+    if (!clip && !stream) {
+        if (mixer_) mixer_->stopAll(start_at_ns);
+        return;
+    }
+    if (!mixer_) {
+        AudioMixer::Config cfg;
+        cfg.card = current_card_; // default card/device; could be extended via header.device_id
+        cfg.device = current_device_;
+        cfg.rate = kMixerRate;
+        cfg.channels = kMixerChannels;
+        cfg.period_frames = kMixerPeriodFrames;
+        cfg.voices = kMixerVoices;
+        cfg.telemetry = telemetry_;
+        mixer_ = std::make_unique<AudioMixer>(cfg);
+    }
+    if (!mixer_->isOpen() && !mixer_->open()) {
+        std::cerr << "[SpeakerNode] Failed to open mixer output" << std::endl;
         return;
     }
-    if (!player_->play()) {
-        std::cerr << "[SpeakerNode] Failed to start playback" << std::endl;
+
+    // 定时的 REPLACE 在新声部出声时才停止旧声部；优先级更高的声部不受影响
+    if (cmd.mode == BionicCat::MqttMsgs::AudioPlayMode::REPLACE) mixer_->stopAll(start_at_ns, cmd.priority);
+    AudioMixer::VoiceParams params;
+    params.speed = cmd.speed <= 0.f ? 1.f : cmd.speed;
+    params.volume = cmd.volume < 0.f ? 0.f : cmd.volume;
+    params.loop = cmd.loop;
+    params.priority = cmd.priority;
+    params.start_at_ns = start_at_ns;
+    const AudioMixer::VoiceId id = stream ? mixer_->play(std::move(stream), params) : mixer_->play(clip, params);
+    if (id == 0) {
+        std::cerr << "[SpeakerNode] No voice available for " << cmd.file_path << std::endl;
     }
 }
 
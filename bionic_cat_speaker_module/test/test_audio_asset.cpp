@@ -0,0 +1,221 @@
+// 音效资源载入测试：RIFF 块遍历与 AAC（ADTS）载入时解码
+//  - data 前有 LIST/fact（含奇数长度填充）、fmt 带扩展字段、data 后有尾部块时只读 data
+//  - WAVE_FORMAT_EXTENSIBLE 取子格式；浮点等非整数 PCM 拒绝；data 长度为 0 时读到文件末尾
+//  - FLAC/Ogg 能识别但无解码器时返回空；ID3 标签后的 ADTS 能识别
+//  - 用 FDK 现场编码 440 Hz ADTS，载入后采样率、声道、长度与频率正确，并可进入 PcmCache
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fdk-aac/aacenc_lib.h>
+#include "audio_asset.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+void put16(std::vector<uint8_t>& v, uint16_t x) {
+    v.push_back(static_cast<uint8_t>(x));
+    v.push_back(static_cast<uint8_t>(x >> 8));
+}
+
+void put32(std::vector<uint8_t>& v, uint32_t x) {
+    for (int i = 0; i < 4; ++i) v.push_back(static_cast<uint8_t>(x >> (8 * i)));
+}
+
+void chunk(std::vector<uint8_t>& v, const char* id, const std::vector<uint8_t>& body, uint32_t declared) {
+    v.insert(v.end(), id, id + 4);
+    put32(v, declared);
+    v.insert(v.end(), body.begin(), body.end());
+    if (body.size() & 1) v.push_back(0);
+}
+
+std::vector<uint8_t> fmtBody(uint16_t format, uint16_t channels, uint32_t rate, uint16_t bits, uint16_t subformat) {
+    std::vector<uint8_t> f;
+    put16(f, format);
+    put16(f, channels);
+    put32(f, rate);
+    put32(f, rate * channels * bits / 8);
+    put16(f, static_cast<uint16_t>(channels * bits / 8));
+    put16(f, bits);
+    put16(f, subformat ? 22 : 0); // cbSize
+    if (subformat) {
+        put16(f, bits);
+        put32(f, channels == 2 ? 3 : 4);
+        put16(f, subformat);
+        static const uint8_t guid_tail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+                                              0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        f.insert(f.end(), guid_tail, guid_tail + 14);
+    }
+    return f;
+}
+
+// RIFF 头 + fmt + LIST（奇数长度）+ fact + data + 尾部 LIST
+std::vector<uint8_t> buildWav(const std::vector<uint8_t>& fmt, const std::vector<int16_t>& pcm, bool zero_size) {
+    std::vector<uint8_t> body(reinterpret_cast<const uint8_t*>(pcm.data()),
+                              reinterpret_cast<const uint8_t*>(pcm.data()) + pcm.size() * 2);
+    std::vector<uint8_t> v = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E'};
+    chunk(v, "fmt ", fmt, static_cast<uint32_t>(fmt.size()));
+    chunk(v, "LIST", {'I', 'N', 'F', 'O', 'x'}, 5);
+    chunk(v, "fact", {0x10, 0, 0, 0}, 4);
+    chunk(v, "data", body, zero_size ? 0 : static_cast<uint32_t>(body.size()));
+    if (!zero_size) chunk(v, "LIST", {'I', 'N', 'F', 'O', 'I', 'C', 'M', 'T'}, 8);
+    const uint32_t riff = static_cast<uint32_t>(v.size() - 8);
+    std::memcpy(v.data() + 4, &riff, 4);
+    return v;
+}
+
+std::string writeFile(const std::string& name, const std::vector<uint8_t>& bytes) {
+    const std::string path = "/tmp/bionic_cat_asset_" + name;
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp) return {};
+    std::fwrite(bytes.data(), 1, bytes.size(), fp);
+    std::fclose(fp);
+    return path;
+}
+
+void testChunkWalker() {
+    std::vector<int16_t> pcm(300);
+    for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = static_cast<int16_t>(i * 97 - 12000);
+
+    const std::string path = writeFile("chunks.wav", buildWav(fmtBody(1, 2, 22050, 16, 0), pcm, false));
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    WavLayout layout;
+    const bool ok = readWavLayout(fp, layout);
+    std::fclose(fp);
+    check(ok && layout.header.num_channels == 2 && layout.header.sample_rate == 22050 &&
+          layout.header.bits_per_sample == 16 && layout.data_size == pcm.size() * 2,
+          "fmt with cbSize and LIST/fact before data are walked");
+    check(layout.data_offset == 12 + 8 + 18 + 8 + 6 + 8 + 4 + 8, "odd-sized chunk padding is honoured");
+
+    auto clip = loadAudioAsset(path);
+    check(clip && clip->data.size() == pcm.size() * 2 && std::memcmp(clip->data.data(), pcm.data(), pcm.size() * 2) == 0,
+          "trailing chunks after data are not read as audio");
+    std::remove(path.c_str());
+
+    const std::string ext = writeFile("ext.wav", buildWav(fmtBody(0xFFFE, 2, 48000, 24, 1), {1, 2, 3, 4, 5, 6}, false));
+    clip = loadAudioAsset(ext);
+    check(clip && clip->header.audio_format == 1 && clip->header.bits_per_sample == 24 && clip->data.size() == 12,
+          "WAVE_FORMAT_EXTENSIBLE with PCM subformat is accepted");
+    std::remove(ext.c_str());
+
+    const std::string flt = writeFile("float.wav", buildWav(fmtBody(3, 1, 48000, 32, 0), {0, 0, 0, 0}, false));
+    const std::string extflt = writeFile("extfloat.wav", buildWav(fmtBody(0xFFFE, 1, 48000, 32, 3), {0, 0}, false));
+    check(!loadAudioAsset(flt) && !loadAudioAsset(extflt), "float WAV (plain or extensible) is rejected");
+    std::remove(flt.c_str());
+    std::remove(extflt.c_str());
+
+    const std::string streamed = writeFile("zero.wav", buildWav(fmtBody(1, 1, 16000, 16, 0), pcm, true));
+    clip = loadAudioAsset(streamed);
+    check(clip && clip->data.size() == pcm.size() * 2, "data size 0 (streamed WAV) reads to end of file");
+    std::remove(streamed.c_str());
+}
+
+void testProbe() {
+    const std::string flac = writeFile("x.flac", {'f', 'L', 'a', 'C', 0, 0, 0, 34});
+    const std::string ogg = writeFile("x.opus", {'O', 'g', 'g', 'S', 0, 2, 0, 0});
+    check(!loadAudioAsset(flac) && !loadAudioAsset(ogg), "FLAC/Ogg without a bundled decoder load as nullptr");
+    std::remove(flac.c_str());
+    std::remove(ogg.c_str());
+
+    const uint8_t id3_adts[] = {'I', 'D', '3', 4, 0, 0, 0, 0, 0, 2, 0, 0, 0xFF, 0xF1, 0x50, 0x80};
+    check(probeAssetFormat(id3_adts, sizeof(id3_adts)) == AssetFormat::Adts, "ADTS after an ID3v2 tag is detected");
+    check(probeAssetFormat(id3_adts + 12, 4) == AssetFormat::Adts, "bare ADTS is detected");
+}
+
+// 编码 seconds 秒 440 Hz 单声道 ADTS
+std::vector<uint8_t> encodeTone(int rate, float seconds) {
+    std::vector<uint8_t> stream;
+    HANDLE_AACENCODER enc = nullptr;
+    if (aacEncOpen(&enc, 0, 1) != AACENC_OK) return stream;
+    aacEncoder_SetParam(enc, AACENC_AOT, 2);
+    aacEncoder_SetParam(enc, AACENC_SAMPLERATE, rate);
+    aacEncoder_SetParam(enc, AACENC_CHANNELMODE, MODE_1);
+    aacEncoder_SetParam(enc, AACENC_BITRATE, 48000);
+    aacEncoder_SetParam(enc, AACENC_TRANSMUX, TT_MP4_ADTS);
+    AACENC_InfoStruct info{};
+    if (aacEncEncode(enc, nullptr, nullptr, nullptr, nullptr) != AACENC_OK || aacEncInfo(enc, &info) != AACENC_OK) {
+        aacEncClose(&enc);
+        return stream;
+    }
+    const int n = static_cast<int>(info.frameLength);
+    std::vector<int16_t> pcm(static_cast<size_t>(n));
+    std::vector<uint8_t> out(4096);
+    const int total = static_cast<int>(seconds * rate);
+    for (int pos = 0; pos < total + 4 * n; pos += n) {
+        for (int i = 0; i < n; ++i) {
+            const int t = pos + i;
+            pcm[static_cast<size_t>(i)] = t < total ? static_cast<int16_t>(10000.0 * std::sin(2.0 * M_PI * 440.0 * t / rate)) : 0;
+        }
+        void* in_ptr = pcm.data();
+        int in_size = n * 2, in_elem = 2, in_id = IN_AUDIO_DATA;
+        void* out_ptr = out.data();
+        int out_size = static_cast<int>(out.size()), out_elem = 1, out_id = OUT_BITSTREAM_DATA;
+        AACENC_BufDesc ib{1, &in_ptr, &in_id, &in_size, &in_elem};
+        AACENC_BufDesc ob{1, &out_ptr, &out_id, &out_size, &out_elem};
+        AACENC_InArgs ia{};
+        AACENC_OutArgs oa{};
+        ia.numInSamples = n;
+        if (aacEncEncode(enc, &ib, &ob, &ia, &oa) != AACENC_OK) break;
+        stream.insert(stream.end(), out.begin(), out.begin() + oa.numOutBytes);
+    }
+    aacEncClose(&enc);
+    return stream;
+}
+
+void testAdtsDecode() {
+    const int rate = 16000;
+    std::vector<uint8_t> file = {'I', 'D', '3', 4, 0, 0, 0, 0, 0, 4, 't', 'a', 'g', '!'};
+    const std::vector<uint8_t> adts = encodeTone(rate, 1.0f);
+    file.insert(file.end(), adts.begin(), adts.end());
+    const std::string path = writeFile("tone.aac", file);
+
+    auto clip = loadAudioAsset(path);
+    check(clip && clip->header.sample_rate == static_cast<uint32_t>(rate) && clip->header.num_channels == 1 &&
+          clip->header.bits_per_sample == 16, "ADTS decodes to S16 at the stream's rate and channels");
+    const size_t frames = clip ? clip->data.size() / 2 : 0;
+    check(frames >= static_cast<size_t>(rate) && frames < static_cast<size_t>(rate) * 3 / 2,
+          "decoded length covers the encoded second (plus codec delay)");
+
+    // 中间 0.5 s 的过零次数 ≈ 2 × 440 × 0.5
+    size_t crossings = 0;
+    if (clip) {
+        const int16_t* s = reinterpret_cast<const int16_t*>(clip->data.data());
+        for (size_t i = rate / 4 + 1; i < static_cast<size_t>(rate) * 3 / 4 && i < frames; ++i) {
+            crossings += (s[i - 1] < 0) != (s[i] < 0);
+        }
+    }
+    check(crossings > 420 && crossings < 460, "decoded tone is 440 Hz");
+
+    PcmCache cache(8 * 1024 * 1024);
+    auto first = cache.get(path);
+    auto second = cache.get(path);
+    check(first && first == second && cache.stats().hits == 1, "decoded AAC asset is cached as PCM");
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testChunkWalker();
+    testProbe();
+    testAdtsDecode();
+    std::cout << (g_failures == 0 ? "All audio asset tests passed" : "Audio asset tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// FilePrefetcher 测试：临时文件上检查预读环形缓冲的读出结果
+//  - 只读 [offset, offset + length)，区间外的尾部数据不读；length 超出文件时截到文件末尾
+//  - 每次只取整帧，区间按整帧截断
+//  - 循环时读线程在末尾回绕，首尾数据连续；关闭循环后读到末尾报告 eof
+//  - rewind() 后从头读起；数据未到时 read 返回 0 且不报 eof
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file_prefetcher.hpp"
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+// 字节 i 的值为 i % 251，便于核对偏移
+std::string writePattern(const std::string& name, size_t bytes) {
+    std::vector<uint8_t> v(bytes);
+    for (size_t i = 0; i < bytes; ++i) v[i] = static_cast<uint8_t>(i % 251);
+    const std::string path = "/tmp/bionic_cat_prefetch_" + name + ".bin";
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp) return {};
+    std::fwrite(v.data(), 1, v.size(), fp);
+    std::fclose(fp);
+    return path;
+}
+
+bool matches(const std::vector<uint8_t>& v, uint64_t file_offset, uint64_t period = 0) {
+    for (size_t i = 0; i < v.size(); ++i) {
+        const uint64_t pos = file_offset + (period ? i % period : i);
+        if (v[i] != static_cast<uint8_t>(pos % 251)) return false;
+    }
+    return true;
+}
+
+// 读到 eof（或读够 limit 字节），每次最多 block 字节
+std::vector<uint8_t> drain(FilePrefetcher& p, size_t block, size_t limit, bool* aligned, size_t align) {
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> buf(block);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (out.size() < limit && std::chrono::steady_clock::now() < deadline) {
+        const size_t n = p.read(buf.data(), std::min(block, limit - out.size()));
+        if (aligned && n % align != 0) *aligned = false;
+        if (n == 0) {
+            if (p.eof()) break;
+            p.waitReady(align, std::chrono::milliseconds(100));
+            continue;
+        }
+        out.insert(out.end(), buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    return out;
+}
+
+void testRegionAndAlignment() {
+    // 44 字节“文件头” + 100003 字节数据 + 尾部 500 字节（如 LIST 块）
+    const std::string path = writePattern("region", 44 + 100003 + 500);
+    FilePrefetcher::Config cfg;
+    cfg.ring_bytes = 8 * 1024; // 远小于数据量，读线程要多次等空间
+    cfg.chunk_bytes = 1000;
+    FilePrefetcher p(cfg);
+    check(p.open(path, 44, 100003, 6), "open starts the reader");
+
+    bool aligned = true;
+    const auto out = drain(p, 4096, SIZE_MAX, &aligned, 6);
+    check(out.size() == 100003 / 6 * 6, "region is truncated to whole frames and excludes trailing data");
+    check(matches(out, 44), "bytes match the file at the region offset");
+    check(aligned, "every read returns whole frames");
+    check(p.eof() && p.read(nullptr, 0) == 0, "eof is reported after the region is consumed");
+
+    p.open(path, 44, 0xFFFFFFFFu, 4);
+    const auto all = drain(p, 4096, SIZE_MAX, nullptr, 4);
+    check(all.size() == (100003 + 500) / 4 * 4 && matches(all, 44), "oversized length reads to end of file");
+    std::remove(path.c_str());
+}
+
+void testLoopAndRewind() {
+    const std::string path = writePattern("loop", 10000);
+    FilePrefetcher::Config cfg;
+    cfg.ring_bytes = 4096;
+    cfg.chunk_bytes = 700;
+    FilePrefetcher p(cfg);
+    p.setLoop(true);
+    p.open(path, 0, 0, 2);
+
+    const auto looped = drain(p, 1000, 35000, nullptr, 2);
+    check(looped.size() == 35000 && matches(looped, 0, 10000), "looping wraps seamlessly at the region end");
+    check(p.stats().wraps >= 3, "reader counts wraps");
+
+    p.setLoop(false);
+    const auto rest = drain(p, 1000, SIZE_MAX, nullptr, 2);
+    check(p.eof() && rest.size() < 10000 + cfg.ring_bytes + cfg.chunk_bytes,
+          "turning loop off ends within one pass plus the buffered data");
+
+    p.rewind();
+    const auto again = drain(p, 1000, 3000, nullptr, 2);
+    check(again.size() == 3000 && matches(again, 0), "rewind restarts at the region start");
+    std::remove(path.c_str());
+}
+
+void testNoDataIsNotEof() {
+    FilePrefetcher p;
+    check(!p.open("/tmp/bionic_cat_prefetch_missing.bin", 0, 0, 2), "missing file fails to open");
+    uint8_t b[4];
+    check(p.read(b, sizeof(b)) == 0 && !p.eof(), "unopened prefetcher reads nothing without claiming eof");
+}
+
+} // namespace
+
+int main() {
+    testRegionAndAlignment();
+    testLoopAndRewind();
+    testNoDataIsNotEof();
+    std::cout << (g_failures == 0 ? "All prefetcher tests passed" : "Prefetcher tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+// ADTS 抖动缓冲 / 丢包隐藏回放测试
+//
+// 把一段 ADTS 流（文件或用 FDK 现场编码的扫频音）按 AdtsStreamDataMsg 的 seq/pts_ms 拆包，
+// 模拟网络抖动、随机/突发丢包、重复包后送入 AdtsStreamReceiver，并以固定播放时钟取帧。
+//  1) 无损无抖动回放须与直接解码逐样本一致
+//  2) 有损回放输出统计：播放/隐藏/晚到/欠载/目标时延
+//  3) 48 kHz 流（每包约 21 ms）：抖动缓冲按 ADTS 头换算每包时长，起播前缓冲够目标时延下限
+//
+// 示例：
+//   speaker_jitter_buffer_test --jitter 40 --loss 0.03 --burst 3 --out concealed.wav
+//   speaker_jitter_buffer_test --in capture.aac --jitter 80
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fdk-aac/aacenc_lib.h>
+#include "adts_stream_receiver.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+struct Options {
+    std::string in_path;
+    std::string out_path;
+    float jitter_ms{30.0f};  // 指数分布抖动均值
+    float loss{0.02f};       // 丢包起始概率
+    int burst{1};            // 每次丢包连续丢失的包数
+    float dup{0.01f};        // 重复包概率
+    float spike_ms{400.0f};  // 中段一次性延迟尖峰（模拟 Wi-Fi 漫游）
+    float seconds{20.0f};
+    uint32_t seed{1};
+};
+
+void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  --in <file.aac>   ADTS stream to replay (default: encode a synthetic sweep)\n"
+              << "  --out <file.wav>  Write the impaired playback output\n"
+              << "  --jitter <ms>     Mean exponential network jitter (default 30)\n"
+              << "  --loss <p>        Packet loss probability (default 0.02)\n"
+              << "  --burst <n>       Packets lost per loss event (default 1)\n"
+              << "  --dup <p>         Duplicate packet probability (default 0.01)\n"
+              << "  --spike <ms>      One-off delay spike mid-stream (default 400, 0 = off)\n"
+              << "  --secs <s>        Synthetic duration (default 20)\n"
+              << "  --seed <n>        RNG seed\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&](void) -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--in" && (v = next())) o.in_path = v;
+        else if (a == "--out" && (v = next())) o.out_path = v;
+        else if (a == "--jitter" && (v = next())) o.jitter_ms = std::stof(v);
+        else if (a == "--loss" && (v = next())) o.loss = std::stof(v);
+        else if (a == "--burst" && (v = next())) o.burst = std::max(1, std::stoi(v));
+        else if (a == "--dup" && (v = next())) o.dup = std::stof(v);
+        else if (a == "--spike" && (v = next())) o.spike_ms = std::stof(v);
+        else if (a == "--secs" && (v = next())) o.seconds = std::stof(v);
+        else if (a == "--seed" && (v = next())) o.seed = static_cast<uint32_t>(std::stoul(v));
+        else if (a == "-h" || a == "--help") { usage(argv[0]); std::exit(0); }
+        else { std::cerr << "Unknown or incomplete arg: " << a << "\n"; return false; }
+    }
+    return true;
+}
+
+// 按 ADTS 头中的 13 bit 帧长切分
+std::vector<std::vector<uint8_t>> splitAdts(const std::vector<uint8_t>& s) {
+    std::vector<std::vector<uint8_t>> frames;
+    size_t off = 0;
+    while (off + 7 <= s.size()) {
+        if (s[off] != 0xFF || (s[off + 1] & 0xF0) != 0xF0) { ++off; continue; }
+        const size_t len = (static_cast<size_t>(s[off + 3] & 0x03) << 11) |
+                           (static_cast<size_t>(s[off + 4]) << 3) | (s[off + 5] >> 5);
+        if (len < 7 || off + len > s.size()) break;
+        frames.emplace_back(s.begin() + static_cast<std::ptrdiff_t>(off),
+                            s.begin() + static_cast<std::ptrdiff_t>(off + len));
+        off += len;
+    }
+    return frames;
+}
+
+// 单声道扫频 + 音节包络，编码为 ADTS 帧（默认 16 kHz）
+bool encodeSweep(float seconds, std::vector<std::vector<uint8_t>>& frames, int sr = 16000) {
+    HANDLE_AACENCODER enc = nullptr;
+    if (aacEncOpen(&enc, 0, 1) != AACENC_OK) return false;
+    aacEncoder_SetParam(enc, AACENC_AOT, 2);
+    aacEncoder_SetParam(enc, AACENC_SAMPLERATE, sr);
+    aacEncoder_SetParam(enc, AACENC_CHANNELMODE, MODE_1);
+    aacEncoder_SetParam(enc, AACENC_BITRATE, sr >= 32000 ? 64000 : 32000);
+    aacEncoder_SetParam(enc, AACENC_TRANSMUX, TT_MP4_ADTS);
+    AACENC_InfoStruct info{};
+    if (aacEncEncode(enc, nullptr, nullptr, nullptr, nullptr) != AACENC_OK || aacEncInfo(enc, &info) != AACENC_OK) {
+        aacEncClose(&enc);
+        return false;
+    }
+    const int n = static_cast<int>(info.frameLength);
+    std::vector<int16_t> pcm(static_cast<size_t>(n));
+    std::vector<uint8_t> out(4096);
+    double phase = 0.0;
+    const int total = static_cast<int>(seconds * sr);
+    for (int pos = 0; pos < total; pos += n) {
+        for (int i = 0; i < n; ++i) {
+            const double t = static_cast<double>(pos + i) / sr;
+            phase += 2.0 * M_PI * (300.0 + 1500.0 * (0.5 + 0.5 * std::sin(2.0 * M_PI * 0.2 * t))) / sr;
+            const double env = 0.5 + 0.5 * std::sin(2.0 * M_PI * 3.0 * t);
+            pcm[static_cast<size_t>(i)] = static_cast<int16_t>(8000.0 * env * std::sin(phase));
+        }
+        void* in_ptr = pcm.data();
+        int in_size = n * 2, in_elem = 2, in_id = IN_AUDIO_DATA;
+        void* out_ptr = out.data();
+        int out_size = static_cast<int>(out.size()), out_elem = 1, out_id = OUT_BITSTREAM_DATA;
+        AACENC_BufDesc ib{1, &in_ptr, &in_id, &in_size, &in_elem};
+        AACENC_BufDesc ob{1, &out_ptr, &out_id, &out_size, &out_elem};
+        AACENC_InArgs ia{};
+        AACENC_OutArgs oa{};
+        ia.numInSamples = n;
+        if (aacEncEncode(enc, &ib, &ob, &ia, &oa) != AACENC_OK) break;
+        if (oa.numOutBytes > 0) frames.emplace_back(out.begin(), out.begin() + oa.numOutBytes);
+    }
+    aacEncClose(&enc);
+    return !frames.empty();
+}
+
+void writeWav(const std::string& path, const std::vector<int16_t>& pcm, int sr, int ch) {
+    std::ofstream f(path, std::ios::binary);
+    const uint32_t data = static_cast<uint32_t>(pcm.size() * 2);
+    auto u32 = [&](uint32_t v) { f.write(reinterpret_cast<const char*>(&v), 4); };
+    auto u16 = [&](uint16_t v) { f.write(reinterpret_cast<const char*>(&v), 2); };
+    f.write("RIFF", 4); u32(36 + data); f.write("WAVEfmt ", 8);
+    u32(16); u16(1); u16(static_cast<uint16_t>(ch)); u32(static_cast<uint32_t>(sr));
+    u32(static_cast<uint32_t>(sr * ch * 2)); u16(static_cast<uint16_t>(ch * 2)); u16(16);
+    f.write("data", 4); u32(data);
+    f.write(reinterpret_cast<const char*>(pcm.data()), static_cast<std::streamsize>(data));
+}
+
+struct Arrival {
+    double t_ms;
+    uint32_t seq;
+};
+
+struct PlayoutResult {
+    std::vector<int16_t> pcm;
+    size_t frames{0}, lost{0}, buffering{0};
+    JitterBufferStats stats{};
+    uint64_t decode_errors{0};
+    uint64_t gap_events{0};
+    float frame_ms{0.0f};
+};
+
+// 固定播放时钟：每 frame_ms 送入已到达的包并取一帧。抖动缓冲用默认配置，每包时长由 ADTS 头得出
+PlayoutResult playout(const std::vector<std::vector<uint8_t>>& frames, std::vector<Arrival> arrivals,
+                      double frame_ms) {
+    std::sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) { return a.t_ms < b.t_ms; });
+    JitterBufferConfig cfg{};
+    AdtsStreamReceiver rx(cfg);
+    PlayoutResult r;
+    if (!rx.open()) return r;
+    rx.jitterBuffer().onGap([&](uint32_t, uint32_t) { ++r.gap_events; });
+
+    const double end_ms = arrivals.empty() ? 0.0 : arrivals.back().t_ms + 4.0 * cfg.max_delay_ms;
+    std::vector<int16_t> pcm;
+    size_t k = 0;
+    for (double now = 0.0; now <= end_ms; now += frame_ms) {
+        while (k < arrivals.size() && arrivals[k].t_ms <= now) {
+            const auto& f = frames[arrivals[k].seq];
+            rx.push(arrivals[k].seq, static_cast<uint64_t>(arrivals[k].seq * frame_ms), f.data(), f.size(),
+                    static_cast<uint64_t>(arrivals[k].t_ms));
+            ++k;
+        }
+        // 全部送入且已播空即结束，避免把流尾的欠载算作丢包
+        if (k == arrivals.size() && rx.jitterBuffer().stats().buffered_ms <= 0.0f) break;
+        switch (rx.nextFrame(pcm)) {
+            case AdtsJitterBuffer::PopStatus::Frame: ++r.frames; break;
+            case AdtsJitterBuffer::PopStatus::Lost: ++r.lost; break;
+            case AdtsJitterBuffer::PopStatus::Buffering: ++r.buffering; break;
+        }
+        // 开始播放前的静音不计入输出，便于与参考解码对齐
+        if (r.frames > 0) r.pcm.insert(r.pcm.end(), pcm.begin(), pcm.end());
+    }
+    r.stats = rx.jitterBuffer().stats();
+    r.decode_errors = rx.decodeErrors();
+    r.frame_ms = rx.jitterBuffer().frameMs();
+    return r;
+}
+
+// 48 kHz 无损回放：每包时长须按采样率换算，起播时缓冲的包数覆盖 min_delay_ms（而不是按 64 ms/包只缓冲 1 包）
+bool testHighRate() {
+    const int sr = 48000;
+    std::vector<std::vector<uint8_t>> frames;
+    if (!encodeSweep(3.0f, frames, sr)) return false;
+    const double frame_ms = 1000.0 * 1024 / sr;
+    std::vector<Arrival> clean;
+    for (uint32_t i = 0; i < frames.size(); ++i) clean.push_back({static_cast<double>(i) * frame_ms + 5.0, i});
+    const PlayoutResult r = playout(frames, clean, frame_ms);
+    const JitterBufferConfig def{};
+    // 起播那一次 pop 时缓冲中的包 = 之前缓冲中的 pop 数 + 1
+    const double startup_ms = static_cast<double>(r.buffering + 1) * frame_ms;
+    const bool ok = std::fabs(r.frame_ms - frame_ms) < 0.01 && r.lost == 0 && r.frames == frames.size() &&
+                    startup_ms >= def.min_delay_ms - 0.5 && startup_ms <= def.initial_delay_ms + frame_ms;
+    std::cout << std::fixed << std::setprecision(1) << "[JitterTest] 48 kHz replay: frame=" << r.frame_ms
+              << "ms startup=" << startup_ms << "ms frames=" << r.frames << " lost=" << r.lost
+              << " -> " << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> frames;
+    if (!opt.in_path.empty()) {
+        std::ifstream f(opt.in_path, std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        frames = splitAdts(bytes);
+    } else if (!encodeSweep(opt.seconds, frames)) {
+        std::cerr << "FDK AAC encode failed" << std::endl;
+        return 2;
+    }
+    if (frames.empty()) {
+        std::cerr << "No ADTS frames" << std::endl;
+        return 2;
+    }
+
+    // 参考：直接顺序解码
+    AacDecoder ref_dec;
+    std::vector<int16_t> ref, pcm;
+    if (!ref_dec.open()) return 2;
+    for (const auto& f : frames) {
+        if (ref_dec.decode(f.data(), f.size(), pcm)) ref.insert(ref.end(), pcm.begin(), pcm.end());
+    }
+    const int sr = ref_dec.sampleRate();
+    const int ch = ref_dec.channels();
+    const double frame_ms = 1000.0 * ref_dec.frameSize() / sr;
+    std::cout << "[JitterTest] " << frames.size() << " ADTS frames, " << sr << " Hz x" << ch
+              << ", " << frame_ms << " ms/frame" << std::endl;
+
+    // 1) 无损无抖动：输出须与参考逐样本一致
+    std::vector<Arrival> clean;
+    for (uint32_t i = 0; i < frames.size(); ++i) clean.push_back({static_cast<double>(i) * frame_ms + 10.0, i});
+    const PlayoutResult c = playout(frames, clean, frame_ms);
+    const size_t n = std::min(c.pcm.size(), ref.size());
+    const bool clean_ok = c.lost == 0 && c.decode_errors == 0 && c.frames == frames.size() && n == ref.size() &&
+                          std::equal(ref.begin(), ref.end(), c.pcm.begin());
+    std::cout << "[JitterTest] clean replay: frames=" << c.frames << " lost=" << c.lost
+              << " -> " << (clean_ok ? "PASS" : "FAIL") << std::endl;
+
+    // 2) 抖动 + 丢包 + 重复 + 延迟尖峰
+    std::mt19937 rng(opt.seed);
+    std::exponential_distribution<double> jitter(opt.jitter_ms > 0.0f ? 1.0 / opt.jitter_ms : 1e9);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::vector<Arrival> impaired;
+    int burst_left = 0;
+    size_t dropped = 0;
+    const uint32_t spike_at = static_cast<uint32_t>(frames.size() / 2);
+    for (uint32_t i = 0; i < frames.size(); ++i) {
+        if (burst_left == 0 && uni(rng) < opt.loss) burst_left = opt.burst;
+        if (burst_left > 0) { --burst_left; ++dropped; continue; }
+        double t = static_cast<double>(i) * frame_ms + 10.0 + jitter(rng);
+        if (opt.spike_ms > 0.0f && i >= spike_at && i < spike_at + 5) t += opt.spike_ms;
+        impaired.push_back({t, i});
+        if (uni(rng) < opt.dup) impaired.push_back({t + jitter(rng), i});
+    }
+    const PlayoutResult r = playout(frames, impaired, frame_ms);
+    const JitterBufferStats& s = r.stats;
+    std::cout << std::fixed << std::setprecision(1)
+              << "[JitterTest] impaired replay: sent=" << frames.size() << " net_dropped=" << dropped
+              << " | played=" << r.frames << " concealed=" << r.lost << " gaps=" << r.gap_events
+              << " late=" << s.late_dropped << " dup=" << s.duplicates
+              << " underruns=" << s.underruns << " shrink=" << s.shrink_dropped
+              << " decode_err=" << r.decode_errors
+              << " | jitter=" << s.jitter_ms << "ms target=" << s.target_delay_ms << "ms" << std::endl;
+    if (!opt.out_path.empty()) {
+        writeWav(opt.out_path, r.pcm, sr, ch);
+        std::cout << "[JitterTest] wrote " << opt.out_path << std::endl;
+    }
+
+    // 每个已接收的包要么播放、要么晚到/主动丢弃，不应凭空消失
+    const bool accounted = s.played + s.shrink_dropped <= s.received && r.decode_errors == 0 && r.frames > 0;
+    std::cout << "[JitterTest] impaired accounting -> " << (accounted ? "PASS" : "FAIL") << std::endl;
+
+    const bool high_rate_ok = testHighRate();
+    return (clean_ok && accounted && high_rate_ok) ? 0 : 3;
+}
@@ -0,0 +1,349 @@
+// AudioMixer 离线测试：不打开设备，直接调用 renderPeriod 检查混音结果
+//  - 饱和相加、音量、声部自然结束
+//  - 停止时渐变无跳变、循环、变速
+//  - 声部用满时的优先级与抢占策略；带优先级的 stopAll 不停止更高优先级的声部
+//  - 非 S16 / 声道不同的片段自动转换
+//  - 定时声部从出声时刻对应的帧开始；已过时刻的从周期首帧开始并计数；未开始即停止的不出声
+//  - 流式声部（PcmStream）与整段载入的片段逐样本一致，含位深/声道转换、重采样与循环回绕
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_asset.hpp"
+#include "audio_mixer.hpp"
+#include "pcm_stream.hpp"
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+std::shared_ptr<const PcmClip> makeClip(uint32_t rate, uint16_t channels, const std::vector<int16_t>& samples) {
+    auto clip = std::make_shared<PcmClip>();
+    std::memcpy(clip->header.riff, "RIFF", 4);
+    std::memcpy(clip->header.wave, "WAVE", 4);
+    clip->header.audio_format = 1;
+    clip->header.num_channels = channels;
+    clip->header.sample_rate = rate;
+    clip->header.bits_per_sample = 16;
+    clip->header.block_align = static_cast<uint16_t>(channels * 2);
+    clip->header.byte_rate = rate * clip->header.block_align;
+    clip->data.resize(samples.size() * 2);
+    std::memcpy(clip->data.data(), samples.data(), clip->data.size());
+    clip->header.data_size = static_cast<uint32_t>(clip->data.size());
+    return clip;
+}
+
+std::shared_ptr<const PcmClip> constClip(uint32_t rate, size_t frames, int16_t value) {
+    return makeClip(rate, 1, std::vector<int16_t>(frames, value));
+}
+
+// 写一个 44 字节头的 WAV，raw 为交错的小端样本
+std::string writeWav(const std::string& name, uint32_t rate, uint16_t channels, uint16_t bits,
+                     const std::vector<uint8_t>& raw) {
+    WavHeader h{};
+    std::memcpy(h.riff, "RIFF", 4);
+    std::memcpy(h.wave, "WAVE", 4);
+    std::memcpy(h.fmt, "fmt ", 4);
+    std::memcpy(h.data, "data", 4);
+    h.fmt_size = 16;
+    h.audio_format = 1;
+    h.num_channels = channels;
+    h.sample_rate = rate;
+    h.bits_per_sample = bits;
+    h.block_align = static_cast<uint16_t>(channels * bits / 8);
+    h.byte_rate = rate * h.block_align;
+    h.data_size = static_cast<uint32_t>(raw.size());
+    h.file_size = 36 + h.data_size;
+
+    const std::string path = "/tmp/bionic_cat_mixer_" + name + ".wav";
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp) return {};
+    std::fwrite(&h, sizeof(h), 1, fp);
+    std::fwrite(raw.data(), 1, raw.size(), fp);
+    std::fclose(fp);
+    return path;
+}
+
+AudioMixer::Config monoConfig(size_t voices = 4) {
+    AudioMixer::Config cfg;
+    cfg.rate = 16000;
+    cfg.channels = 1;
+    cfg.period_frames = 160;
+    cfg.voices = voices;
+    cfg.fade_ms = 5;
+    return cfg;
+}
+
+void testSumAndVolume() {
+    AudioMixer m(monoConfig());
+    std::vector<int16_t> out(160);
+    AudioMixer::VoiceParams p;
+    p.volume = 0.5f;
+    m.play(constClip(16000, 1600, 1000), p);
+    m.renderPeriod(out.data());
+    check(out[0] == 500 && out[159] == 500, "volume 0.5 scales a single voice");
+
+    AudioMixer s(monoConfig());
+    s.play(constClip(16000, 1600, 20000), {});
+    s.play(constClip(16000, 1600, 20000), {});
+    s.play(constClip(16000, 1600, -3000), {});
+    s.renderPeriod(out.data());
+    check(out[10] == 32767 - 3000, "voices are summed with per-voice saturating adds");
+}
+
+void testVoiceEnds() {
+    AudioMixer m(monoConfig());
+    std::vector<int16_t> out(160);
+    const auto id = m.play(constClip(16000, 200, 1000), {});
+    m.renderPeriod(out.data());
+    m.renderPeriod(out.data());
+    check(out[39] == 1000 && out[40] == 0, "voice output stops exactly at clip end");
+    check(!m.isActive(id) && m.activeVoices() == 0, "finished voice frees its slot");
+}
+
+void testStopIsClickFree() {
+    AudioMixer m(monoConfig());
+    std::vector<int16_t> out(160), all;
+    const auto id = m.play(constClip(16000, 16000, 16000), {});
+    m.renderPeriod(out.data());
+    m.stop(id);
+    for (int i = 0; i < 3; ++i) {
+        m.renderPeriod(out.data());
+        all.insert(all.end(), out.begin(), out.end());
+    }
+    int max_jump = 0;
+    for (size_t i = 1; i < all.size(); ++i) max_jump = std::max(max_jump, std::abs(all[i] - all[i - 1]));
+    // 5 ms @16 kHz = 80 帧，16000 满幅每帧最多下降约 16000 / 80
+    check(all.back() == 0 && max_jump <= 16000 / 80 + 1, "stop fades out within fade_ms without a step");
+    check(!m.isActive(id), "stopped voice is released after the fade");
+}
+
+void testLoopAndSpeed() {
+    std::vector<int16_t> ramp(100);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = static_cast<int16_t>(i * 100);
+
+    AudioMixer m(monoConfig());
+    std::vector<int16_t> out(160);
+    AudioMixer::VoiceParams p;
+    p.loop = true;
+    m.play(makeClip(16000, 1, ramp), p);
+    m.renderPeriod(out.data());
+    check(out[99] == 9900 && out[100] == 0 && out[150] == 5000, "looping voice wraps to the start");
+
+    AudioMixer f(monoConfig());
+    p.loop = false;
+    p.speed = 2.0f;
+    f.play(makeClip(16000, 1, ramp), p);
+    f.renderPeriod(out.data());
+    // 变速经 sinc 重采样，斜坡中段应与理想值基本一致
+    check(std::abs(out[10] - 2000) <= 20 && std::abs(out[30] - 6000) <= 60 && out[50] == 0,
+          "speed 2 advances two source frames per output frame");
+
+    AudioMixer r(monoConfig());
+    p.speed = 1.0f;
+    r.play(makeClip(8000, 1, ramp), p); // 8 kHz 片段重采样到 16 kHz 输出
+    r.renderPeriod(out.data());
+    check(std::abs(out[40] - 2000) <= 20 && std::abs(out[41] - 2050) <= 20, "sample rate mismatch is interpolated");
+}
+
+void testPriorityAndStealing() {
+    std::vector<int16_t> out(160);
+    AudioMixer::VoiceParams lo, hi;
+    lo.priority = 0;
+    hi.priority = 5;
+
+    AudioMixer m(monoConfig(2));
+    const auto a = m.play(constClip(16000, 16000, 100), hi);
+    const auto b = m.play(constClip(16000, 16000, 100), lo);
+    m.renderPeriod(out.data());
+    const auto c = m.play(constClip(16000, 16000, 100), lo);
+    m.renderPeriod(out.data());
+    check(c != 0 && m.isActive(a) && !m.isActive(b) && m.isActive(c), "equal priority steals the oldest low-priority voice");
+
+    AudioMixer::VoiceParams lower;
+    lower.priority = -1;
+    const auto d = m.play(constClip(16000, 16000, 100), lower);
+    check(d == 0 && m.stats().rejected == 1, "a lower-priority voice is rejected when all slots outrank it");
+
+    AudioMixer::Config cfg = monoConfig(1);
+    cfg.steal = AudioMixer::StealPolicy::None;
+    AudioMixer n(cfg);
+    n.play(constClip(16000, 16000, 100), lo);
+    check(n.play(constClip(16000, 16000, 100), hi) == 0, "StealPolicy::None never preempts");
+}
+
+void testConversion() {
+    AudioMixer::Config cfg = monoConfig();
+    cfg.channels = 2;
+    AudioMixer m(cfg);
+    auto clip = std::make_shared<PcmClip>();
+    clip->header.num_channels = 1;
+    clip->header.sample_rate = 16000;
+    clip->header.bits_per_sample = 8;
+    clip->data.assign(1600, 128 + 64); // 8 bit 无符号：+64 → +16384
+    std::vector<int16_t> out(320);
+    m.play(clip, {});
+    m.renderPeriod(out.data());
+    check(out[0] == 16384 && out[1] == 16384, "8-bit mono clip is converted to S16 stereo");
+}
+
+void testScheduledStart() {
+    // 16 kHz：一帧 62500 ns，一个周期（160 帧）10 ms
+    const int64_t t0 = 1000000000000LL;
+    const int64_t period = 10000000;
+    std::vector<int16_t> out(160);
+
+    AudioMixer m(monoConfig());
+    AudioMixer::VoiceParams p;
+    p.start_at_ns = t0 + period + 37 * 62500;
+    const auto id = m.play(constClip(16000, 1600, 1000), p);
+    m.renderPeriod(out.data(), t0);
+    check(m.isActive(id) && out[0] == 0 && out[159] == 0, "voice scheduled for a later period stays silent");
+    m.renderPeriod(out.data(), t0 + period);
+    check(out[36] == 0 && out[37] == 1000 && out[159] == 1000, "scheduled voice starts on the exact frame");
+    check(m.stats().scheduled == 1 && m.stats().late_starts == 0, "on-time start is not counted as late");
+
+    AudioMixer l(monoConfig());
+    p.start_at_ns = t0 - 1000000;
+    l.play(constClip(16000, 1600, 1000), p);
+    l.renderPeriod(out.data(), t0);
+    check(out[0] == 1000 && l.stats().late_starts == 1, "late voice starts at the period start and is counted");
+
+    AudioMixer u(monoConfig());
+    p.start_at_ns = t0 + 1000 * period;
+    u.play(constClip(16000, 1600, 1000), p);
+    u.renderPeriod(out.data());
+    check(out[0] == 1000, "without an output clock scheduled voices start immediately");
+
+    AudioMixer s(monoConfig());
+    const auto pending = s.play(constClip(16000, 1600, 1000), p);
+    s.renderPeriod(out.data(), t0);
+    s.stop(pending);
+    s.renderPeriod(out.data(), t0 + period);
+    check(!s.isActive(pending), "stopping a pending voice releases it without playing");
+}
+
+void testScheduledReplace() {
+    const int64_t t0 = 1000000000000LL;
+    const int64_t period = 10000000;
+    std::vector<int16_t> out(160);
+
+    AudioMixer m(monoConfig());
+    const auto old_id = m.play(constClip(16000, 16000, 1000), {});
+    AudioMixer::VoiceParams p;
+    p.start_at_ns = t0 + 2 * period + 80 * 62500;
+    m.stopAll(p.start_at_ns);
+    const auto new_id = m.play(constClip(16000, 16000, 2000), p);
+    m.renderPeriod(out.data(), t0);
+    m.renderPeriod(out.data(), t0 + period);
+    check(out[159] == 1000 && m.isActive(new_id), "scheduled stopAll leaves current voices playing until its time");
+    m.renderPeriod(out.data(), t0 + 2 * period);
+    check(out[79] < 1000 && out[80] >= 2000 && out[159] == 2000, "old voice fades out as the replacement starts");
+    check(!m.isActive(old_id) && m.isActive(new_id), "replacement voice is not stopped by its own stopAll");
+}
+
+void testPriorityStopAll() {
+    std::vector<int16_t> out(160);
+    AudioMixer m(monoConfig());
+    AudioMixer::VoiceParams high;
+    high.priority = 5;
+    const auto low_id = m.play(constClip(16000, 16000, 1000), {});
+    const auto high_id = m.play(constClip(16000, 16000, 2000), high);
+    m.renderPeriod(out.data());
+    m.stopAll(0, 3);
+    m.renderPeriod(out.data());
+    m.renderPeriod(out.data());
+    check(!m.isActive(low_id) && m.isActive(high_id) && out[159] == 2000,
+          "stopAll with a priority limit keeps higher-priority voices");
+    m.stopAll();
+    m.renderPeriod(out.data());
+    m.renderPeriod(out.data());
+    check(!m.isActive(high_id), "stopAll without a limit stops every voice");
+}
+
+// 渲染到两个混音器都没有活动声部（最多 max_periods 个周期），返回两者输出是否逐样本一致
+bool renderSame(AudioMixer& a, AudioMixer& b, size_t max_periods) {
+    const size_t n = a.config().period_frames * a.config().channels;
+    std::vector<int16_t> x(n), y(n);
+    for (size_t i = 0; i < max_periods && (a.activeVoices() > 0 || b.activeVoices() > 0); ++i) {
+        a.renderPeriod(x.data());
+        b.renderPeriod(y.data());
+        if (x != y) return false;
+    }
+    return true;
+}
+
+void testStreamedVoice() {
+    // 24 kHz 双声道 24 bit 的文件在 16 kHz 单声道输出上播放：转换声道/位深并重采样
+    const size_t frames = 6000;
+    std::vector<uint8_t> raw;
+    raw.reserve(frames * 2 * 3);
+    for (size_t f = 0; f < frames; ++f) {
+        const int32_t l = static_cast<int32_t>(12000.0 * std::sin(2.0 * M_PI * 440.0 * f / 24000.0)) * 256;
+        const int32_t r = static_cast<int32_t>(8000.0 * std::sin(2.0 * M_PI * 700.0 * f / 24000.0)) * 256;
+        for (int32_t v : {l, r}) {
+            raw.push_back(static_cast<uint8_t>(v & 0xFF));
+            raw.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+            raw.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
+        }
+    }
+    const std::string path = writeWav("stream24", 24000, 2, 24, raw);
+
+    AudioMixer a(monoConfig());
+    AudioMixer b(monoConfig());
+    AudioMixer::VoiceParams p;
+    p.volume = 0.8f;
+    a.play(loadAudioAsset(path), p);
+    std::shared_ptr<PcmStream> stream = PcmStream::open(path, 1, false);
+    const size_t window = stream ? stream->windowFrames() : 0;
+    check(stream && b.play(stream, p) != 0, "a WAV opens as a streamed voice");
+    check(stream && stream->windowFrames() < 1024 && window == 0, "the stream window is sized for one period, not the file");
+    stream.reset();
+    check(renderSame(a, b, 200) && b.stats().stream_underruns == 0,
+          "streamed voice matches the in-memory clip after conversion and resampling");
+
+    std::vector<int16_t> ramp(1000);
+    std::vector<uint8_t> raw16(ramp.size() * 2);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = static_cast<int16_t>(i * 30);
+    std::memcpy(raw16.data(), ramp.data(), raw16.size());
+    const std::string loop_path = writeWav("loop16", 16000, 1, 16, raw16);
+    AudioMixer c(monoConfig());
+    AudioMixer d(monoConfig());
+    p.loop = true;
+    c.play(makeClip(16000, 1, ramp), p);
+    d.play(PcmStream::open(loop_path, 1, true), p);
+    check(renderSame(c, d, 30) && d.activeVoices() == 1, "looping stream wraps at the end of the data chunk");
+
+    check(!PcmStream::open("/tmp/bionic_cat_mixer_missing.wav", 1, false), "missing file does not open a stream");
+}
+
+} // namespace
+
+int main() {
+    testSumAndVolume();
+    testVoiceEnds();
+    testStopIsClickFree();
+    testLoopAndSpeed();
+    testPriorityAndStealing();
+    testConversion();
+    testScheduledStart();
+    testScheduledReplace();
+    testPriorityStopAll();
+    testStreamedVoice();
+    std::cout << (g_failures == 0 ? "All mixer tests passed" : "Mixer tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// 流播放与播放指令仲裁测试：不依赖设备与 MQTT
+// OutputSim 按 SpeakerNode 的调用顺序驱动 OutputArbiter（handleStreamData / executeCommand / handleStreamControl）
+//  - 流进行中执行播放指令：被停掉的流继续发数据也不会重新开流，音效不被掐断
+//  - 显式 is_start 控制消息后重新开流（停止混音器）；is_start=false 同样解除锁存
+//  - 被停掉的流停发超过空闲超时后，新数据视为新的流，自动开流
+//  - 没有流在播放时执行指令不锁存
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "output_arbiter.hpp"
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+constexpr int64_t kIdleTimeoutMs = 2000;
+
+// 只保留节点输出状态：流播放器与混音器声部二者互斥
+struct OutputSim {
+    OutputArbiter arbiter{kIdleTimeoutMs};
+    bool stream_playing{false};
+    bool clip_playing{false};
+    int stream_starts{0};
+
+    void streamData(int64_t now_ms) {
+        if (stream_playing) return;
+        if (!arbiter.allowAutoStart(now_ms)) return;
+        startStream();
+    }
+    void streamControl(bool is_start) {
+        arbiter.onStreamControl();
+        if (is_start) {
+            if (!stream_playing) startStream();
+        } else {
+            stream_playing = false;
+        }
+    }
+    void playCommand(int64_t now_ms) {
+        if (stream_playing) {
+            stream_playing = false;
+            arbiter.onCommandStoppedStream(now_ms);
+        }
+        clip_playing = true;
+    }
+
+private:
+    void startStream() {
+        clip_playing = false; // 开流关闭混音器
+        stream_playing = true;
+        ++stream_starts;
+    }
+};
+
+// 每 20 ms 一个数据包
+void sendData(OutputSim& sim, int64_t from_ms, int64_t to_ms) {
+    for (int64_t t = from_ms; t < to_ms; t += 20) sim.streamData(t);
+}
+
+void testPlayDuringStream() {
+    OutputSim sim;
+    sendData(sim, 0, 1000);
+    check(sim.stream_playing && sim.stream_starts == 1, "stream data auto-starts the stream");
+
+    sim.playCommand(1000);
+    sendData(sim, 1000, 4000);
+    check(sim.clip_playing && !sim.stream_playing && sim.stream_starts == 1,
+          "play during stream: later stream data does not restart the stream");
+    check(sim.arbiter.latched() && sim.arbiter.suppressedPackets() == 150, "suppressed packets are counted");
+}
+
+void testExplicitStart() {
+    OutputSim sim;
+    sendData(sim, 0, 500);
+    sim.playCommand(500);
+    sendData(sim, 500, 1000);
+    sim.streamControl(true);
+    check(sim.stream_playing && !sim.clip_playing && !sim.arbiter.latched(),
+          "explicit is_start restarts the stream and clears the latch");
+
+    sim.playCommand(1500);
+    sim.streamControl(false);
+    sendData(sim, 1600, 1700);
+    check(sim.stream_playing && sim.stream_starts == 3, "is_start=false also clears the latch");
+}
+
+void testIdleTimeout() {
+    OutputSim sim;
+    sendData(sim, 0, 500);
+    sim.playCommand(500);
+    sendData(sim, 500, 1500);
+    sim.streamData(1480 + kIdleTimeoutMs); // 最后一个数据包在 1480 ms
+    check(!sim.stream_playing && sim.arbiter.latched(), "latch holds up to the idle timeout after the last packet");
+
+    OutputSim sim2;
+    sendData(sim2, 0, 500);
+    sim2.playCommand(500);
+    sendData(sim2, 500, 1500);
+    sim2.streamData(1480 + kIdleTimeoutMs + 1);
+    check(sim2.stream_playing && sim2.stream_starts == 2 && !sim2.arbiter.latched(),
+          "data after the stream was idle longer than the timeout starts a new stream");
+}
+
+void testNoStreamNoLatch() {
+    OutputSim sim;
+    sim.playCommand(0);
+    sim.streamData(100);
+    check(sim.stream_playing && !sim.arbiter.latched(), "a command without a live stream does not latch");
+}
+
+} // namespace
+
+int main() {
+    testPlayDuringStream();
+    testExplicitStart();
+    testIdleTimeout();
+    testNoStreamNoLatch();
+    std::cout << (g_failures == 0 ? "All output arbiter tests passed" : "Output arbiter tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
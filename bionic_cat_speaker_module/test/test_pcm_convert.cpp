@@ -0,0 +1,146 @@
+// 播放链路格式转换测试（SIMD 与标量尾部一致）
+//  - S16 ↔ float 全值域往返无损、超出满幅时饱和
+//  - 8/24/32 bit WAV 样本转 float
+//  - 声道升混/降混
+//  - WAV 帧 → S16 的分块转换与逐段 float 链路一致
+//  - 两个播放引擎共用的增益步长
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pcm_convert.hpp"
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+void testS16RoundTrip() {
+    // 奇数长度，覆盖向量主体与标量尾部
+    std::vector<int16_t> in(65536 + 5);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<int16_t>(static_cast<int>(i % 65536) - 32768);
+    std::vector<float> f(in.size());
+    std::vector<int16_t> out(in.size());
+    s16ToFloat(in.data(), f.data(), in.size());
+    floatToS16(f.data(), 1.0f, out.data(), out.size());
+    check(in == out, "S16 -> float -> S16 is lossless over the full range");
+    check(f[0] == -1.0f && std::fabs(f[32768]) == 0.0f, "S16 full scale maps to [-1, 1)");
+
+    const std::vector<float> loud = {1.5f, -1.5f, 0.99999f, -2.0f, 0.25f, 0.5f, -0.5f, 3.0f, 1.5f, -1.5f, 0.0f};
+    std::vector<int16_t> sat(loud.size());
+    floatToS16(loud.data(), 1.0f, sat.data(), sat.size());
+    check(sat[0] == 32767 && sat[1] == -32768 && sat[7] == 32767 && sat[8] == 32767 && sat[9] == -32768,
+          "float -> S16 saturates in both the vector body and the tail");
+
+    std::vector<int16_t> half(loud.size());
+    floatToS16(loud.data(), 0.5f, half.data(), half.size());
+    check(half[4] == 4096 && half[5] == 8192 && half[6] == -8192, "gain is applied before rounding");
+}
+
+void testWavDepths() {
+    const uint8_t u8[] = {0, 128, 255, 192};
+    float f8[4];
+    check(pcmToFloat(u8, 4, 8, f8) && f8[0] == -1.0f && f8[1] == 0.0f && f8[3] == 0.5f, "8-bit unsigned is centred at 128");
+
+    const uint8_t s24[] = {0x00, 0x00, 0x80, 0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x40};
+    float f24[3];
+    check(pcmToFloat(s24, 3, 24, f24) && f24[0] == -1.0f && f24[2] == 0.5f && f24[1] < 1.0f && f24[1] > 0.9999f,
+          "24-bit is sign-extended");
+
+    const int32_t s32[] = {INT32_MIN, 1 << 30};
+    uint8_t raw[8];
+    std::memcpy(raw, s32, sizeof(raw));
+    float f32[2];
+    check(pcmToFloat(raw, 2, 32, f32) && f32[0] == -1.0f && f32[1] == 0.5f, "32-bit maps full scale to [-1, 1)");
+
+    float dummy[1];
+    check(!pcmToFloat(u8, 1, 12, dummy), "unsupported bit depth is rejected");
+}
+
+void testRemix() {
+    const float mono[] = {0.1f, 0.2f};
+    float st[4];
+    remixChannels(mono, 1, st, 2, 2);
+    check(st[0] == 0.1f && st[1] == 0.1f && st[2] == 0.2f && st[3] == 0.2f, "mono is duplicated to stereo");
+
+    const float stereo[] = {0.2f, 0.4f, -1.0f, 1.0f};
+    float m[2];
+    remixChannels(stereo, 2, m, 1, 2);
+    check(std::fabs(m[0] - 0.3f) < 1e-6f && m[1] == 0.0f, "stereo is averaged to mono");
+
+    const float quad[] = {0.1f, 0.2f, 0.3f, 0.4f};
+    float q2[2];
+    remixChannels(quad, 4, q2, 2, 1);
+    check(std::fabs(q2[0] - 0.2f) < 1e-6f && std::fabs(q2[1] - 0.3f) < 1e-6f, "4 channels fold to stereo by parity");
+}
+
+void testFramesToS16() {
+    // 24 bit 6 声道 → 双声道，帧数跨越多个内部块
+    const uint16_t in_ch = 6;
+    const size_t frames = 1000;
+    std::vector<uint8_t> raw(frames * in_ch * 3);
+    for (size_t i = 0; i < raw.size(); ++i) raw[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    std::vector<float> f(frames * in_ch);
+    std::vector<float> mix(frames * 2);
+    std::vector<int16_t> ref(frames * 2);
+    pcmToFloat(raw.data(), f.size(), 24, f.data());
+    remixChannels(f.data(), in_ch, mix.data(), 2, frames);
+    floatToS16(mix.data(), 1.0f, ref.data(), ref.size());
+
+    std::vector<int16_t> out(frames * 2);
+    convertFramesToS16(raw.data(), frames, in_ch, 24, out.data(), 2);
+    check(out == ref, "frame conversion matches the float chain across blocks");
+
+    // 8 bit 单声道升到 kMaxPcmChannels：每块帧数最少的情况
+    const uint8_t u8[] = {0, 128, 255};
+    std::vector<int16_t> wide(3 * kMaxPcmChannels);
+    convertFramesToS16(u8, 3, 1, 8, wide.data(), kMaxPcmChannels);
+    check(wide[0] == -32768 && wide[kMaxPcmChannels - 1] == -32768 && wide[kMaxPcmChannels] == 0 &&
+              wide[3 * kMaxPcmChannels - 1] == 32512,
+          "8-bit mono fans out to the widest layout");
+}
+
+void testGainStep() {
+    // 5 ms @ 48 kHz：0 → 1 恰好 240 步，不越过目标
+    const float step = gainRampStep(5.0f, 48000);
+    float g = 0.0f;
+    int n = 0;
+    while (g != 1.0f && n < 1000) { g = stepGain(g, 1.0f, step); ++n; }
+    check(n >= 240 && n <= 241 && g == 1.0f, "5 ms ramp at 48 kHz takes 240 frames");
+    check(gainRampStep(0.0f, 48000) == 0.0f && stepGain(0.2f, 0.7f, 0.0f) == 0.7f, "zero fade jumps to the target");
+
+    // applyGainRamp 与逐帧 stepGain 走同一条曲线
+    std::vector<float> x(300 * 2, 1.0f);
+    float rg = 1.0f;
+    const size_t ramped = applyGainRamp(x.data(), 300, 2, rg, 0.0f, step);
+    g = 1.0f;
+    bool same = ramped <= 241;
+    for (size_t f = 0; f < ramped; ++f) {
+        g = stepGain(g, 0.0f, step);
+        same = same && x[f * 2] == g && x[f * 2 + 1] == g;
+    }
+    check(same && rg == 0.0f, "applyGainRamp follows stepGain frame by frame");
+}
+
+} // namespace
+
+int main() {
+    testS16RoundTrip();
+    testWavDepths();
+    testRemix();
+    testFramesToS16();
+    testGainStep();
+    std::cout << (g_failures == 0 ? "All conversion tests passed" : "Conversion tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
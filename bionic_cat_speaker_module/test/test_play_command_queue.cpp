@@ -0,0 +1,145 @@
+// 播放指令队列测试：不依赖设备与 MQTT
+//  - REPLACE 作废排队中优先级不高于它的指令，停止指令作废全部
+//  - 取出顺序按优先级，同优先级先到先出
+//  - ENQUEUE 在输出忙时不取出；DROP_IF_BUSY 输出忙时丢弃、空闲时正常取出
+//  - 已取出的指令在后到的 REPLACE/停止之后 superseded() 为 true，MIX 与低优先级 REPLACE 不作废它
+//  - 队满挤掉优先级最低的；waitChanged 在另一线程 push 时立即返回
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "play_command_queue.hpp"
+
+using namespace BionicCat::SpeakerModule;
+using BionicCat::MqttMsgs::AudioPlayMode;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+PlayCommandQueue::Command cmd(const std::string& file, AudioPlayMode mode, uint8_t priority = 0) {
+    PlayCommandQueue::Command c{};
+    c.file_path = file;
+    c.speed = 1.0f;
+    c.volume = 1.0f;
+    c.loop = false;
+    c.mode = mode;
+    c.priority = priority;
+    return c;
+}
+
+void testCoalesce() {
+    PlayCommandQueue q;
+    q.push(cmd("a.wav", AudioPlayMode::MIX));
+    q.push(cmd("b.wav", AudioPlayMode::REPLACE));
+    q.push(cmd("alarm.wav", AudioPlayMode::MIX, 5));
+    q.push(cmd("c.wav", AudioPlayMode::REPLACE));
+    PlayCommandQueue::Ticket t1, t2, t3;
+    const bool ok1 = q.pop(t1, false);
+    const bool ok2 = q.pop(t2, false);
+    check(ok1 && ok2 && !q.pop(t3, false) && t1.cmd.file_path == "alarm.wav" && t2.cmd.file_path == "c.wav",
+          "REPLACE drops pending commands of lower or equal priority only");
+    check(q.stats().coalesced == 2, "coalesced commands are counted");
+
+    q.push(cmd("d.wav", AudioPlayMode::MIX, 9));
+    q.push(cmd("", AudioPlayMode::MIX));
+    check(q.pop(t1, false) && t1.cmd.file_path.empty() && !q.pop(t2, false), "a stop command drops every priority");
+}
+
+void testOrder() {
+    PlayCommandQueue q;
+    q.push(cmd("low1.wav", AudioPlayMode::MIX, 1));
+    q.push(cmd("high.wav", AudioPlayMode::MIX, 3));
+    q.push(cmd("low2.wav", AudioPlayMode::MIX, 1));
+    PlayCommandQueue::Ticket a, b, c;
+    q.pop(a, false);
+    q.pop(b, false);
+    q.pop(c, false);
+    check(a.cmd.file_path == "high.wav" && b.cmd.file_path == "low1.wav" && c.cmd.file_path == "low2.wav",
+          "higher priority first, FIFO within a priority");
+}
+
+void testBusyPolicies() {
+    PlayCommandQueue q;
+    q.push(cmd("next.wav", AudioPlayMode::ENQUEUE));
+    q.push(cmd("chirp.wav", AudioPlayMode::DROP_IF_BUSY));
+    q.push(cmd("mix.wav", AudioPlayMode::MIX));
+    PlayCommandQueue::Ticket t;
+    const bool got = q.pop(t, true);
+    check(got && t.cmd.file_path == "mix.wav" && q.stats().dropped_busy == 1,
+          "while busy DROP_IF_BUSY is dropped and MIX overtakes a waiting ENQUEUE");
+    check(!q.pop(t, true) && q.stats().depth == 1, "ENQUEUE waits while the output is busy");
+    check(q.pop(t, false) && t.cmd.file_path == "next.wav", "ENQUEUE runs once the output is idle");
+
+    q.push(cmd("chirp.wav", AudioPlayMode::DROP_IF_BUSY));
+    check(q.pop(t, false) && t.cmd.file_path == "chirp.wav", "DROP_IF_BUSY plays when the output is idle");
+}
+
+void testSuperseded() {
+    PlayCommandQueue q;
+    PlayCommandQueue::Ticket loading;
+    q.push(cmd("slow.wav", AudioPlayMode::REPLACE, 2));
+    q.pop(loading, false);
+    q.push(cmd("mix.wav", AudioPlayMode::MIX, 9));
+    q.push(cmd("low.wav", AudioPlayMode::REPLACE, 1));
+    check(!q.superseded(loading), "MIX and lower-priority REPLACE do not supersede an in-flight command");
+    q.push(cmd("latest.wav", AudioPlayMode::REPLACE, 2));
+    check(q.superseded(loading), "a later REPLACE supersedes a command still loading");
+
+    PlayCommandQueue::Ticket high;
+    q.push(cmd("alarm.wav", AudioPlayMode::MIX, 200));
+    while (q.pop(high, false) && high.cmd.file_path != "alarm.wav") {
+    }
+    q.push(cmd("", AudioPlayMode::REPLACE));
+    check(high.cmd.file_path == "alarm.wav" && q.superseded(high), "a stop supersedes any priority");
+}
+
+void testOverflowAndWait() {
+    PlayCommandQueue q(2);
+    q.push(cmd("a.wav", AudioPlayMode::MIX, 1));
+    q.push(cmd("b.wav", AudioPlayMode::MIX, 3));
+    q.push(cmd("c.wav", AudioPlayMode::MIX, 2));
+    q.push(cmd("d.wav", AudioPlayMode::MIX, 0));
+    PlayCommandQueue::Ticket a, b, c;
+    q.pop(a, false);
+    q.pop(b, false);
+    check(a.cmd.file_path == "b.wav" && b.cmd.file_path == "c.wav" && !q.pop(c, false) && q.stats().overflowed == 2,
+          "a full queue evicts the lowest priority and rejects lower newcomers");
+
+    const uint64_t v = q.version();
+    const auto t0 = std::chrono::steady_clock::now();
+    std::thread pusher([&q] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        q.push(cmd("e.wav", AudioPlayMode::MIX));
+    });
+    q.waitChanged(v, 5000);
+    const auto waited = std::chrono::steady_clock::now() - t0;
+    pusher.join();
+    check(waited < std::chrono::seconds(1) && q.pop(c, false) && c.cmd.file_path == "e.wav",
+          "waitChanged wakes on push from another thread");
+
+    q.push(cmd("f.wav", AudioPlayMode::MIX));
+    q.close();
+    q.push(cmd("g.wav", AudioPlayMode::MIX));
+    check(!q.pop(c, false), "close drops pending commands and rejects new ones");
+}
+
+} // namespace
+
+int main() {
+    testCoalesce();
+    testOrder();
+    testBusyPolicies();
+    testSuperseded();
+    testOverflowAndWait();
+    std::cout << (g_failures == 0 ? "All play command queue tests passed" : "Play command queue tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// PlaybackTelemetry 测试：直方图与统计窗口
+//  - 样本按上界（含）落桶，超过最后一个上界的进溢出桶；均值、最大值正确
+//  - 分位数按桶上界估计，落在溢出桶时返回最大值
+//  - stats(true) 清空直方图开启新窗口，累计计数不清零
+//  - 缓冲填充度按百分比记录并截断到 0~100；两个线程同时记录不丢样本
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "playback_telemetry.hpp"
+
+using namespace BionicCat::SpeakerModule;
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+void testHistogram() {
+    const uint32_t upper[] = {10, 100, 1000};
+    Histogram h(upper, 3);
+    for (uint32_t v : {0u, 10u, 11u, 100u, 500u, 5000u}) h.record(v);
+    const Histogram::Snapshot s = h.snapshot(false);
+    check(s.bounds == 3 && s.buckets[0] == 2 && s.buckets[1] == 2 && s.buckets[2] == 1 && s.buckets[3] == 1,
+          "samples land in the bucket whose upper bound they do not exceed");
+    check(s.count == 6 && s.max == 5000 && s.avg > 936.0f && s.avg < 937.0f, "count, max and mean");
+    check(s.percentile(0.5f) == 100 && s.percentile(0.0f) == 10 && s.percentile(1.0f) == 5000,
+          "percentiles are bucket upper bounds, overflow reports the max");
+
+    h.snapshot(true);
+    const Histogram::Snapshot e = h.snapshot(false);
+    check(e.count == 0 && e.max == 0 && e.avg == 0.0f && e.percentile(0.99f) == 0, "reset empties the histogram");
+}
+
+void testTelemetryWindow() {
+    PlaybackTelemetry t;
+    t.recordOpen(12000, true);
+    t.recordOpen(30000, false);
+    t.recordFirstWrite(4000);
+    t.recordWrite(5300);
+    t.recordWrite(5400);
+    t.recordXrun();
+    t.recordUnderrun();
+    t.setPeriod(256, 48000);
+    t.recordBufferFill(512, 1024);
+    t.recordBufferFill(2000, 1024);
+    t.recordBufferFill(-5, 1024);
+
+    const PlaybackTelemetryStats s = t.stats(true);
+    check(s.device_opens == 1 && s.device_open_failures == 1 && s.open_us.count == 2 && s.open_us.max == 30000,
+          "device opens and failures are both timed");
+    check(s.periods_written == 2 && s.write_us.count == 2 && s.first_write_us.count == 1,
+          "writes and first-write latency are recorded");
+    check(s.xruns == 1 && s.underruns == 1 && s.period_us > 5333.0f && s.period_us < 5334.0f,
+          "xrun/underrun counters and the period budget");
+    check(s.buffer_fill_pct.max == 100 && s.buffer_fill_pct.buckets[0] == 1 && s.buffer_fill_pct.buckets[2] == 1,
+          "buffer fill is a percentage clamped to 0..100");
+
+    const PlaybackTelemetryStats n = t.stats(false);
+    check(n.write_us.count == 0 && n.periods_written == 2 && n.xruns == 1,
+          "a new window clears histograms but keeps cumulative counters");
+}
+
+void testConcurrentRecord() {
+    PlaybackTelemetry t;
+    auto writer = [&] {
+        for (int i = 0; i < 100000; ++i) t.recordWrite(i % 30000);
+    };
+    std::thread a(writer), b(writer);
+    a.join();
+    b.join();
+    const PlaybackTelemetryStats s = t.stats(true);
+    check(s.periods_written == 200000 && s.write_us.count == 200000 && s.write_us.max == 29999,
+          "concurrent writers lose no samples");
+}
+
+} // namespace
+
+int main() {
+    testHistogram();
+    testTelemetryWindow();
+    testConcurrentRecord();
+    std::cout << (g_failures == 0 ? "All playback telemetry tests passed" : "Playback telemetry tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// 触发到出声时延对比：冷启动（每次 prepare）与热备（设备常开、静音待命）
+// 需要真实声卡；统计来自 WavPlayer::lastTriggerLatency()
+//
+//   speaker_trigger_latency_test -f meow.wav [-d 0] [-D 0] [-n 10]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pcm_cache.hpp"
+#include "play_wav_tinyalsa.hpp"
+
+static void usage(const char* prog) {
+    std::cout << "Usage: " << prog << " -f <file.wav> [-d <card=0>] [-D <device=0>] [-n <triggers=10>]" << std::endl;
+}
+
+struct Summary {
+    double avg_ms{0.0};
+    double max_ms{0.0};
+    int count{0};
+};
+
+// 连续触发 n 次，每次播完（或最多 3 s）后再触发下一次
+static Summary runTriggers(WavPlayer& player, int card, int device, int n, bool warm) {
+    std::vector<double> totals;
+    for (int i = 0; i < n; ++i) {
+        player.stop();
+        if (!player.load(card, device) || !player.play()) {
+            std::cerr << "[TriggerLatency] load/play failed" << std::endl;
+            break;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        // 热备模式播完会自动回到待命；冷模式播完后持续写静音，需要主动 stop
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        while (warm && player.isPlaying() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        const WavPlayer::TriggerLatency lat = player.lastTriggerLatency();
+        if (lat.total_us >= 0 && lat.warm == warm) totals.push_back(lat.total_us / 1000.0);
+        if (!warm) {
+            // 冷模式每次重新 prepare：关闭设备让下一次真正冷启动
+            player.close();
+        }
+    }
+    Summary s;
+    s.count = static_cast<int>(totals.size());
+    for (double t : totals) {
+        s.avg_ms += t;
+        s.max_ms = std::max(s.max_ms, t);
+    }
+    if (s.count > 0) s.avg_ms /= s.count;
+    return s;
+}
+
+int main(int argc, char** argv) {
+    int card = 0, device = 0, n = 10;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-f" && i + 1 < argc) path = argv[++i];
+        else if (a == "-d" && i + 1 < argc) card = std::stoi(argv[++i]);
+        else if (a == "-D" && i + 1 < argc) device = std::stoi(argv[++i]);
+        else if (a == "-n" && i + 1 < argc) n = std::stoi(argv[++i]);
+        else { usage(argv[0]); return 1; }
+    }
+    if (path.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    WavPlayer player;
+    player.file_path = path;
+    player.setCache(std::make_shared<PcmCache>());
+
+    const Summary cold = runTriggers(player, card, device, n, false);
+    player.setWarmStandby(true);
+    const Summary warm = runTriggers(player, card, device, n, true);
+    player.close();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "[TriggerLatency] cold: n=" << cold.count << " avg=" << cold.avg_ms << "ms max=" << cold.max_ms << "ms\n"
+              << "[TriggerLatency] warm: n=" << warm.count << " avg=" << warm.avg_ms << "ms max=" << warm.max_ms << "ms"
+              << std::endl;
+    return (cold.count > 0 && warm.count > 0) ? 0 : 2;
+}
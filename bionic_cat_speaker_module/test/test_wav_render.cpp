@@ -0,0 +1,154 @@
+// WavPlayer 离线渲染测试：不打开设备，经 renderNext 检查与播放线程相同的处理链
+//  - 起播淡入、音量变化逐样本渐变且在一块内开始生效
+//  - fadeOut() 在 fade_ms 内淡到静音后结束，无截断跳变（含重采样链路）
+//  - fade_ms 为 0 时原格式原音量逐位透传
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "play_wav_tinyalsa.hpp"
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    if (!ok) ++g_failures;
+}
+
+constexpr double kFreq = 440.0;
+constexpr double kAmp = 16000.0;
+
+// 写一个 S16 正弦 WAV，所有声道相同
+std::string writeSine(const std::string& name, uint32_t rate, uint16_t channels, size_t frames) {
+    std::vector<int16_t> pcm(frames * channels);
+    for (size_t f = 0; f < frames; ++f) {
+        const auto s = static_cast<int16_t>(std::lround(kAmp * std::sin(2.0 * M_PI * kFreq * f / rate)));
+        for (size_t c = 0; c < channels; ++c) pcm[f * channels + c] = s;
+    }
+    WavHeader h{};
+    std::memcpy(h.riff, "RIFF", 4);
+    std::memcpy(h.wave, "WAVE", 4);
+    std::memcpy(h.fmt, "fmt ", 4);
+    std::memcpy(h.data, "data", 4);
+    h.fmt_size = 16;
+    h.audio_format = 1;
+    h.num_channels = channels;
+    h.sample_rate = rate;
+    h.bits_per_sample = 16;
+    h.block_align = static_cast<uint16_t>(channels * 2);
+    h.byte_rate = rate * h.block_align;
+    h.data_size = static_cast<uint32_t>(pcm.size() * 2);
+    h.file_size = 36 + h.data_size;
+
+    const std::string path = "/tmp/bionic_cat_render_" + name + ".wav";
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp) return {};
+    std::fwrite(&h, sizeof(h), 1, fp);
+    std::fwrite(pcm.data(), 2, pcm.size(), fp);
+    std::fclose(fp);
+    return path;
+}
+
+// 相邻样本最大差值（只看第 0 声道）
+int maxStep(const std::vector<int16_t>& v, size_t ch, size_t from = 0) {
+    int m = 0;
+    for (size_t i = (from + 1) * ch; i < v.size(); i += ch) m = std::max(m, std::abs(v[i] - v[i - ch]));
+    return m;
+}
+
+// [from, to) 帧内第 0 声道的峰值
+int peak(const std::vector<int16_t>& v, size_t ch, size_t from, size_t to) {
+    int m = 0;
+    for (size_t f = from; f < to && f * ch < v.size(); ++f) m = std::max(m, std::abs(static_cast<int>(v[f * ch])));
+    return m;
+}
+
+// 440 Hz、幅度 16000 @48k 时相邻样本最大差约 921；渐变叠加后也不应超过约 1000
+constexpr int kSmoothStep = 1000;
+
+void testFadeInAndVolume() {
+    const std::string path = writeSine("vol", 48000, 2, 48000);
+    WavPlayer p;
+    p.file_path = path;
+    p.fade_ms = 5.0f;
+    check(p.loadSource() && p.beginRender(), "source loads without opening a device");
+
+    std::vector<int16_t> out;
+    for (int i = 0; i < 8 && p.renderNext(out); ++i) {}
+    const size_t at = out.size() / 2; // 音量变化所在帧
+    p.volume = 0.25f;
+    for (int i = 0; i < 8 && p.renderNext(out); ++i) {}
+
+    // 淡入：首帧接近 0，5 ms（240 帧）后恢复满幅
+    check(std::abs(out[0]) < 200 && peak(out, 2, 240, 1200) > kAmp * 0.99, "playback fades in over fade_ms");
+    check(maxStep(out, 2) < kSmoothStep, "volume change ramps without a step");
+    // 下一块（1024 帧）内开始变化，再经 0.75 × 240 帧到达目标
+    check(peak(out, 2, at + 1024 + 200, at + 1024 + 1400) < kAmp * 0.26 &&
+          peak(out, 2, at + 1024 + 200, at + 1024 + 1400) > kAmp * 0.24,
+          "new volume is reached within one block plus the ramp");
+    bool stereo = true;
+    for (size_t i = 0; i + 1 < out.size(); i += 2) stereo = stereo && out[i] == out[i + 1];
+    check(stereo, "ramp is applied identically to every channel of a frame");
+    std::remove(path.c_str());
+}
+
+void testFadeOutStop(uint32_t rate, const std::string& tag) {
+    const std::string path = writeSine("stop" + tag, rate, 1, rate / 2);
+    WavPlayer p;
+    p.file_path = path;
+    p.fade_ms = 5.0f;
+    p.loop = true; // 不会自然结束，只能靠 fadeOut 停下
+    p.loadSource();
+    p.beginRender();
+
+    std::vector<int16_t> out;
+    for (int i = 0; i < 6; ++i) p.renderNext(out);
+    const size_t before = out.size() / 2;
+    p.fadeOut();
+    int blocks = 0;
+    while (p.renderNext(out) && blocks < 100) ++blocks;
+    const size_t after = out.size() / 2 - before;
+
+    check(blocks < 100 && after <= 1024 + 240 + 64, tag + " fadeOut ends within one block plus fade_ms");
+    check(std::abs(out[out.size() - 2]) < 100, tag + " stream ends at silence");
+    check(maxStep(out, 2, 300) < kSmoothStep, tag + " fade-out has no truncation click");
+    check(!p.renderNext(out), tag + " rendering stays finished after fade-out");
+    std::remove(path.c_str());
+}
+
+void testBitExactPassthrough() {
+    const std::string path = writeSine("raw", 48000, 2, 4800);
+    WavPlayer p;
+    p.file_path = path;
+    p.fade_ms = 0.0f;
+    p.loadSource();
+    p.beginRender();
+    std::vector<int16_t> out;
+    while (p.renderNext(out)) {}
+
+    bool same = out.size() == 4800 * 2;
+    for (size_t f = 0; same && f < 4800; ++f) {
+        same = out[f * 2] == static_cast<int16_t>(std::lround(kAmp * std::sin(2.0 * M_PI * kFreq * f / 48000)));
+    }
+    check(same, "fade_ms 0 at unit volume passes S16 through bit-exactly");
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testFadeInAndVolume();
+    testFadeOutStop(48000, "48k");
+    testFadeOutStop(44100, "44.1k resampled");
+    testBitExactPassthrough();
+    std::cout << (g_failures == 0 ? "All render tests passed" : "Render tests FAILED") << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -22,6 +22,7 @@ function(find_third_party_pro)
         yaml_cpp
         tinyalsa
         fdk_aac
+        opus
         cvi_mpi
         ini
         lvgl